@@ -0,0 +1,335 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "audiostems.h"
+#include "../src/lib/localeHandling.h"
+#include "mlt++/Mlt.h"
+
+#include <QDebug>
+#include <QDomDocument>
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+/** @brief Writes wav files, as 16 bit or 24 bit PCM or 32 bit float */
+class WavWriter
+{
+public:
+    enum Format { S16, S24, F32 };
+    WavWriter(const QString &path, int frequency, int channels, Format format)
+        : m_file(path)
+        , m_frequency(frequency)
+        , m_channels(channels)
+        , m_format(format)
+    {
+    }
+    bool open()
+    {
+        if (!m_file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        // The sizes are written when closing the file
+        writeHeader();
+        return true;
+    }
+    void write(const std::vector<float> &samples)
+    {
+        const int bytes = sampleSize();
+        m_buffer.resize(int(samples.size()) * bytes);
+        char *data = m_buffer.data();
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const float sample = qBound(-1.f, samples[i], 1.f);
+            switch (m_format) {
+            case F32:
+                qToLittleEndian(samples[i], data);
+                break;
+            case S24: {
+                const qint32 value = qBound(-8388608, qRound(sample * 8388608.f), 8388607);
+                char le[4];
+                qToLittleEndian(value, le);
+                memcpy(data, le, 3);
+                break;
+            }
+            default:
+                qToLittleEndian(qint16(qBound(-32768, qRound(sample * 32768.f), 32767)), data);
+                break;
+            }
+            data += bytes;
+        }
+        m_file.write(m_buffer.constData(), m_buffer.size());
+        m_dataSize += quint32(m_buffer.size());
+    }
+    bool close()
+    {
+        m_file.seek(0);
+        writeHeader();
+        m_file.close();
+        return m_file.error() == QFileDevice::NoError;
+    }
+    QString fileName() const { return m_file.fileName(); }
+
+private:
+    QFile m_file;
+    int m_frequency;
+    int m_channels;
+    Format m_format;
+    quint32 m_dataSize = 0;
+    QByteArray m_buffer;
+
+    int sampleSize() const { return m_format == S16 ? 2 : (m_format == S24 ? 3 : 4); }
+    void writeHeader()
+    {
+        QByteArray chunks;
+        auto put32 = [&chunks](quint32 value) {
+            char bytes[4];
+            qToLittleEndian(value, bytes);
+            chunks.append(bytes, 4);
+        };
+        auto put16 = [&chunks](quint16 value) {
+            char bytes[2];
+            qToLittleEndian(value, bytes);
+            chunks.append(bytes, 2);
+        };
+        const bool isFloat = m_format == F32;
+        const quint16 blockAlign = quint16(m_channels * sampleSize());
+        chunks.append("WAVEfmt ");
+        // Non PCM formats have an extension size and a fact chunk
+        put32(isFloat ? 18 : 16);
+        // PCM or IEEE float
+        put16(isFloat ? 3 : 1);
+        put16(quint16(m_channels));
+        put32(quint32(m_frequency));
+        put32(quint32(m_frequency) * blockAlign);
+        put16(blockAlign);
+        put16(quint16(sampleSize() * 8));
+        if (isFloat) {
+            put16(0);
+            chunks.append("fact");
+            put32(4);
+            put32(m_dataSize / blockAlign);
+        }
+        chunks.append("data");
+        put32(m_dataSize);
+        QByteArray header("RIFF");
+        char size[4];
+        qToLittleEndian(quint32(chunks.size()) + m_dataSize, size);
+        header.append(size, 4);
+        header.append(chunks);
+        m_file.write(header);
+    }
+};
+
+/** @brief Audio of one frame, as interleaved float samples */
+class AudioBuffer
+{
+public:
+    explicit AudioBuffer(int channels)
+        : m_channels(channels)
+    {
+    }
+    /** @brief Fill with @p samples samples of silence */
+    void reset(int samples) { m_samples.assign(size_t(samples * m_channels), 0.f); }
+    /** @brief Copy the audio of a frame, converting it to float. The number of samples set by reset() is kept, so that all files stay aligned */
+    void store(const void *data, mlt_audio_format format, int frameChannels, int frameSamples)
+    {
+        if (data == nullptr || frameChannels <= 0) {
+            return;
+        }
+        const int count = qMin(int(m_samples.size()) / m_channels, frameSamples);
+        for (int s = 0; s < count; ++s) {
+            for (int c = 0; c < m_channels; ++c) {
+                const int channel = qMin(c, frameChannels - 1);
+                const int interleaved = s * frameChannels + channel;
+                const int planar = channel * frameSamples + s;
+                float value = 0.f;
+                switch (format) {
+                case mlt_audio_s16:
+                    value = static_cast<const qint16 *>(data)[interleaved] / 32768.f;
+                    break;
+                case mlt_audio_s32le:
+                    value = float(static_cast<const qint32 *>(data)[interleaved] / 2147483648.);
+                    break;
+                case mlt_audio_s32:
+                    value = float(static_cast<const qint32 *>(data)[planar] / 2147483648.);
+                    break;
+                case mlt_audio_f32le:
+                    value = static_cast<const float *>(data)[interleaved];
+                    break;
+                case mlt_audio_float:
+                    value = static_cast<const float *>(data)[planar];
+                    break;
+                case mlt_audio_u8:
+                    value = (static_cast<const quint8 *>(data)[interleaved] - 128) / 128.f;
+                    break;
+                default:
+                    return;
+                }
+                m_samples[size_t(s * m_channels + c)] = value;
+            }
+        }
+    }
+    const std::vector<float> &samples() const { return m_samples; }
+
+private:
+    int m_channels;
+    std::vector<float> m_samples;
+};
+
+/** @brief Get audio callback of the capture filter, stores the audio of the track in its AudioBuffer on the way to the mix */
+int captureAudio(mlt_frame frame, void **buffer, mlt_audio_format *format, int *frequency, int *channels, int *samples)
+{
+    auto *capture = static_cast<AudioBuffer *>(mlt_frame_pop_audio(frame));
+    int error = mlt_frame_get_audio(frame, buffer, format, frequency, channels, samples);
+    if (error == 0) {
+        capture->store(*buffer, *format, *channels, *samples);
+    }
+    return error;
+}
+
+mlt_frame captureProcess(mlt_filter filter, mlt_frame frame)
+{
+    mlt_frame_push_audio(frame, filter->child);
+    mlt_frame_push_audio(frame, reinterpret_cast<void *>(captureAudio));
+    return frame;
+}
+
+/** @brief Attach a filter to @p track that copies its audio to @p capture each time the track is mixed */
+bool attachCapture(Mlt::Producer &track, AudioBuffer *capture)
+{
+    mlt_filter filter = mlt_filter_new();
+    if (filter == nullptr) {
+        return false;
+    }
+    filter->child = capture;
+    filter->process = captureProcess;
+    // Track effects are attached first, so the stems include them
+    bool result = mlt_service_attach(track.get_service(), filter) == 0;
+    mlt_filter_close(filter);
+    return result;
+}
+
+/** @brief Reads the audio of @p producer at @p position to @p buffer, as @p samples samples */
+void readAudio(Mlt::Producer &producer, int position, int frequency, int channels, int samples, AudioBuffer &buffer)
+{
+    buffer.reset(samples);
+    producer.seek(position);
+    std::unique_ptr<Mlt::Frame> frame(producer.get_frame());
+    if (!frame || !frame->is_valid()) {
+        return;
+    }
+    mlt_audio_format format = mlt_audio_f32le;
+    int frameFrequency = frequency;
+    int frameChannels = channels;
+    int frameSamples = samples;
+    void *data = frame->get_audio(format, frameFrequency, frameChannels, frameSamples);
+    buffer.store(data, format, frameChannels, frameSamples);
+}
+} // namespace
+
+int AudioStems::render(const QString &playlist)
+{
+    QFile f(playlist);
+    QDomDocument doc;
+    if (!f.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open file" << f.fileName() << "for reading";
+        return 1;
+    }
+    if (!doc.setContent(&f, false)) {
+        qWarning() << "Failed to parse file" << f.fileName() << "to QDomDocument";
+        f.close();
+        return 1;
+    }
+    f.close();
+    QDomElement consumer = doc.documentElement().firstChildElement(QStringLiteral("consumer"));
+    int in = consumer.attribute(QStringLiteral("in"), QString::number(0)).toInt();
+    int out = consumer.attribute(QStringLiteral("out"), QString::number(-1)).toInt();
+    const QString target = consumer.attribute(QStringLiteral("target"));
+    const int frequency = consumer.attribute(QStringLiteral("frequency"), QString::number(48000)).toInt();
+    const int channels = consumer.attribute(QStringLiteral("channels"), QString::number(2)).toInt();
+    if (target.isEmpty() || frequency <= 0 || channels <= 0) {
+        qWarning() << "Invalid audio parameters in" << playlist;
+        return 1;
+    }
+
+    // After initialising the MLT factory, set the locale back from user default to C
+    // to ensure numbers are always serialised with . as decimal point.
+    Mlt::Factory::init();
+    LocaleHandling::resetAllLocale();
+    // The profile is read from the playlist
+    Mlt::Profile profile;
+    Mlt::Producer producer(profile, "xml", playlist.toUtf8().constData());
+    if (!producer.is_valid() || producer.type() != mlt_service_tractor_type) {
+        fprintf(stderr, "INVALID playlist: %s \n", playlist.toUtf8().constData());
+        return 1;
+    }
+    Mlt::Tractor tractor(producer);
+    in = qMax(0, in);
+    if (out < 0 || out >= tractor.get_length()) {
+        out = tractor.get_length() - 1;
+    }
+
+    const QString stemFormat = QString::fromUtf8(tractor.get("kdenlive:stem_format"));
+    const WavWriter::Format format = stemFormat == QLatin1String("f32") ? WavWriter::F32 : (stemFormat == QLatin1String("s24") ? WavWriter::S24 : WavWriter::S16);
+    // The last track is the rendered tractor, for the mixdown with the transitions and master effects
+    const int mixIndex = tractor.get_int("kdenlive:stem_mix");
+    if (mixIndex <= 0 || mixIndex >= tractor.count()) {
+        fprintf(stderr, "INVALID playlist: %s \n", playlist.toUtf8().constData());
+        return 1;
+    }
+    // The tracks are only pulled by the rendered tractor: decoding them twice at the same position would return silence the second time.
+    // A capture filter on each track copies its audio while it is mixed.
+    std::vector<std::unique_ptr<Mlt::Producer>> tracks;
+    std::vector<std::unique_ptr<AudioBuffer>> captures;
+    std::vector<std::unique_ptr<WavWriter>> stems;
+    for (int i = 0; i < mixIndex; ++i) {
+        const QString path = QString::fromUtf8(tractor.get(QStringLiteral("kdenlive:stem.%1").arg(i).toUtf8().constData()));
+        tracks.emplace_back(tractor.track(i));
+        captures.emplace_back(new AudioBuffer(channels));
+        stems.emplace_back(new WavWriter(path, frequency, channels, format));
+        if (path.isEmpty() || !tracks.back() || !attachCapture(*tracks.back(), captures.back().get()) || !stems.back()->open()) {
+            fprintf(stderr, "Cannot render audio track %d to %s \n", i, path.toUtf8().constData());
+            return 1;
+        }
+    }
+    std::unique_ptr<Mlt::Producer> mix(tractor.track(mixIndex));
+    WavWriter mixdown(target, frequency, channels, format);
+    if (!mix || !mixdown.open()) {
+        fprintf(stderr, "Cannot write to %s \n", target.toUtf8().constData());
+        return 1;
+    }
+
+    const double fps = profile.fps();
+    AudioBuffer buffer(channels);
+    int percentage = -1;
+    for (int position = in; position <= out; ++position) {
+        int samples = mlt_audio_calculate_frame_samples(float(fps), frequency, position);
+        for (auto &capture : captures) {
+            capture->reset(samples);
+        }
+        readAudio(*mix, position, frequency, channels, samples, buffer);
+        mixdown.write(buffer.samples());
+        for (size_t i = 0; i < stems.size(); ++i) {
+            stems[i]->write(captures[i]->samples());
+        }
+
+        // Same output as melt -progress, parsed by RenderJob
+        int progress = int(qint64(position - in + 1) * 100 / (out - in + 1));
+        if (progress != percentage) {
+            percentage = progress;
+            fprintf(stderr, "Current Frame: %d, percentage: %d\n", position, percentage);
+        }
+    }
+    bool success = mixdown.close();
+    for (auto &stem : stems) {
+        if (!stem->close()) {
+            fprintf(stderr, "Cannot write to %s \n", stem->fileName().toUtf8().constData());
+            success = false;
+        }
+    }
+    return success ? 0 : 1;
+}
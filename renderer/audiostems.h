@@ -0,0 +1,23 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QString>
+
+/** @class AudioStems
+    @brief Renders the audio tracks of a playlist to one wav file per track and a mixdown, in a single pass.
+    The playlist is prepared by Kdenlive: its root tractor lists the audio tracks, with a kdenlive:stem.N property
+    giving the output file of each track, then the rendered tractor at the kdenlive:stem_mix index, whose audio is
+    written to the consumer target. Only the rendered tractor is pulled, the audio of each track is captured while it is mixed.
+    The kdenlive:stem_format property selects 16 bit (s16), 24 bit (s24) or float (f32) samples.
+    Progress is reported on stderr in the same format as melt, so that RenderJob can follow it.
+ */
+class AudioStems
+{
+public:
+    /** @brief Render the stems of @p playlist, @returns the process exit code */
+    static int render(const QString &playlist);
+};
@@ -5,6 +5,7 @@
 */
 
 #include "../src/lib/localeHandling.h"
+#include "audiostems.h"
 #include "mlt++/Mlt.h"
 #include "renderjob.h"
 #include <../config-kdenlive.h>
@@ -31,7 +32,7 @@ int main(int argc, char **argv)
     parser.addHelpOption();
     parser.addVersionOption();
 
-    parser.addPositionalArgument("mode", "Render mode. Either \"delivery\" or \"preview-chunks\".");
+    parser.addPositionalArgument("mode", "Render mode. Either \"delivery\", \"preview-chunks\" or \"audio-stems\".");
     parser.parse(QCoreApplication::arguments());
     QStringList args = parser.positionalArguments();
     const QString mode = args.isEmpty() ? QString() : args.first();
@@ -147,6 +148,21 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    if (mode == "audio-stems") {
+        parser.clearPositionalArguments();
+        parser.addPositionalArgument("audio-stems", "Mode: Render each audio track to a separate file and the mixdown in a single pass.");
+        parser.addPositionalArgument("source", "Source file (MLT XML prepared by Kdenlive).");
+
+        parser.process(app);
+        args = parser.positionalArguments();
+        if (args.count() != 2) {
+            qCritical() << "Error: wrong number of arguments specified\n";
+            parser.showHelp(1);
+            // the command above will quit the app with return 1;
+        }
+        return AudioStems::render(args.at(1));
+    }
+
     if (mode == "delivery") {
         parser.clearPositionalArguments();
         parser.addPositionalArgument("delivery", "Mode: Render to a final output file.");
@@ -165,6 +181,9 @@ int main(int argc, char **argv)
         QCommandLineOption subtitleOption("subtitle", "Subtitle file.", "file");
         parser.addOption(subtitleOption);
 
+        QCommandLineOption stemsOption("audio-stems", "Render the audio tracks of the source to separate files in a single pass instead of using the renderer.");
+        parser.addOption(stemsOption);
+
         parser.process(app);
         args = parser.positionalArguments();
 
@@ -232,10 +251,29 @@ int main(int argc, char **argv)
                 tmp.close();
             }
         }
+        // Frame rate and pass, for the render telemetry
+        double frameRate = 0.;
+        QDomElement profile = doc.documentElement().firstChildElement(QStringLiteral("profile"));
+        if (!profile.isNull() && profile.attribute(QStringLiteral("frame_rate_den")).toInt() > 0) {
+            frameRate = profile.attribute(QStringLiteral("frame_rate_num")).toDouble() / profile.attribute(QStringLiteral("frame_rate_den")).toDouble();
+        }
+        int pass = consumer.isNull() ? 0 : consumer.attribute(QStringLiteral("pass")).toInt();
+        if (consumer.attribute(QStringLiteral("x265-params")).contains(QLatin1String("pass="))) {
+            pass = consumer.attribute(QStringLiteral("x265-params")).section(QLatin1String("pass="), 1).section(QLatin1Char(':'), 0, 0).toInt();
+        }
         int pid = parser.value(pidOption).toInt();
         QString subtitleFile = parser.value(subtitleOption);
 
+        if (parser.isSet(stemsOption)) {
+            // Run ourselves in audio-stems mode as the render process, to keep the progress and abort handling
+            render = QCoreApplication::applicationFilePath();
+        }
         auto *rJob = new RenderJob(render, playlist, target, pid, in, out, subtitleFile, &app);
+        if (parser.isSet(stemsOption)) {
+            rJob->setRenderArguments({QStringLiteral("audio-stems"), playlist});
+        }
+        rJob->setFrameRate(frameRate);
+        rJob->setPass(pass);
         QObject::connect(rJob, &RenderJob::renderingFinished, rJob, [&]() {
             rJob->deleteLater();
             app.quit();
@@ -6,19 +6,20 @@
 
 #include "renderjob.h"
 
+#include <QJsonDocument>
 #include <QStringList>
 #include <QThread>
 #ifndef NODBUS
 #include <QtDBus>
-#else
-#include <QJsonDocument>
-#include <QJsonObject>
 #endif
 #include <QDebug>
 #include <QDir>
 #include <QElapsedTimer>
 #include <QStandardPaths>
 #include <utility>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
 // Can't believe I need to do this to sleep.
 class SleepThread : QThread
 {
@@ -81,6 +82,44 @@ RenderJob::~RenderJob()
     m_logfile.close();
 }
 
+void RenderJob::setRenderArguments(const QStringList &args)
+{
+    m_args = args;
+}
+
+void RenderJob::setFrameRate(double fps)
+{
+    m_frameRate = fps;
+}
+
+void RenderJob::setPass(int pass)
+{
+    m_pass = pass;
+}
+
+/** @brief Processor time used by a process in milliseconds, or -1 if unknown */
+static qint64 processCpuTime(qint64 pid)
+{
+#ifdef Q_OS_LINUX
+    QFile stat(QStringLiteral("/proc/%1/stat").arg(pid));
+    if (pid <= 0 || !stat.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    // The process name can contain spaces, fields are counted after its closing parenthesis
+    const QByteArray data = stat.readAll();
+    const QList<QByteArray> fields = data.mid(data.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 13) {
+        return -1;
+    }
+    // utime and stime, in clock ticks
+    const qint64 ticks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+    return ticks * 1000 / sysconf(_SC_CLK_TCK);
+#else
+    Q_UNUSED(pid)
+    return -1;
+#endif
+}
+
 void RenderJob::slotAbort(const QString &url)
 {
     if (m_dest == url) {
@@ -142,26 +181,107 @@ void RenderJob::receivedStderr()
     } else {
         int progress = result.section(QLatin1Char(' '), -1).toInt();
         int frame = result.section(QLatin1Char(','), 0, 0).section(QLatin1Char(' '), -1).toInt();
-        if (progress <= m_progress || progress <= 0 || progress > 100) {
+        if (progress <= 0 || progress > 100) {
             return;
         }
-        m_progress = progress;
-        if (m_args.contains(QStringLiteral("pass=1"))) {
-            m_progress /= 2;
-        } else if (m_args.contains(QStringLiteral("pass=2"))) {
-            m_progress = 50 + m_progress / 2;
+        // Both passes of a two pass encoding are displayed as a single job
+        if (m_pass == 1) {
+            progress /= 2;
+        } else if (m_pass == 2) {
+            progress = 50 + progress / 2;
         }
+        m_progress = qMax(m_progress, progress);
+        m_frame = frame;
         qint64 elapsedTime = m_startTime.secsTo(QDateTime::currentDateTime());
         if (elapsedTime == m_seconds) {
             return;
         }
-        int speed = (frame - m_frame) / (elapsedTime - m_seconds);
         m_seconds = elapsedTime;
-        m_frame = frame;
-        updateProgress(speed);
+        sampleTelemetry();
+        updateProgress(int(m_fps));
+        sendTelemetry();
     }
 }
 
+void RenderJob::startStage(const QString &stage)
+{
+    m_stage = stage;
+    m_stageTimer.start();
+    m_sampleTime = 0;
+    m_sampleFrame = m_frame;
+    m_sampleCpuTime = -1;
+    m_fps = 0.;
+}
+
+void RenderJob::endStage()
+{
+    if (!m_stage.isEmpty()) {
+        m_stageTimes.insert(m_stage, m_stageTimer.elapsed() / 1000.);
+    }
+}
+
+void RenderJob::sampleTelemetry()
+{
+    const qint64 now = m_stageTimer.elapsed();
+    if (now <= m_sampleTime) {
+        return;
+    }
+    // Smooth the speed a bit, the encoders do not process frames at a regular pace
+    double fps = (m_frame - m_sampleFrame) * 1000. / (now - m_sampleTime);
+    m_fps = m_fps > 0. ? 0.7 * m_fps + 0.3 * fps : fps;
+    // Number of processor cores used by the render process since the last sample
+    const qint64 cpuTime = processCpuTime(m_renderProcess->processId());
+    if (cpuTime >= 0 && m_sampleCpuTime >= 0) {
+        m_cpuUsage = double(cpuTime - m_sampleCpuTime) / (now - m_sampleTime);
+    }
+    m_sampleCpuTime = cpuTime;
+    m_sampleTime = now;
+    m_sampleFrame = m_frame;
+}
+
+void RenderJob::sendTelemetry()
+{
+    QJsonObject args;
+    args["url"] = m_dest;
+    args["stage"] = m_stage;
+    args["pass"] = m_pass;
+    args["frame"] = m_frame;
+    args["frames"] = m_frameout - m_framein + 1;
+    args["progress"] = m_progress;
+    const double seconds = m_stageTimer.elapsed() / 1000.;
+    args["elapsed"] = seconds;
+    args["fps"] = m_fps;
+    if (seconds > 0.) {
+        args["averageFps"] = (m_frame - m_framein) / seconds;
+    }
+    if (m_fps > 0.) {
+        args["eta"] = (m_frameout - m_frame) / m_fps;
+    }
+    if (m_cpuUsage >= 0.) {
+        args["cpu"] = m_cpuUsage;
+    }
+    if (m_frameRate > 0. && m_frame > m_framein) {
+        // Average bitrate of the file written so far, in kbit/s
+        const double duration = (m_frame - m_framein) / m_frameRate;
+        args["bitrate"] = QFileInfo(m_dest).size() * 8 / 1000. / duration;
+    }
+    args["stageTimes"] = m_stageTimes;
+    m_logstream << QJsonDocument(args).toJson(QJsonDocument::Compact) << "\n";
+#ifndef NODBUS
+    if ((m_kdenliveinterface != nullptr) && m_kdenliveinterface->isValid()) {
+        m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingTelemetry"),
+                                                  {m_dest, QString::fromUtf8(QJsonDocument(args).toJson(QJsonDocument::Compact))});
+    }
+#else
+    if (m_kdenlivesocket->state() == QLocalSocket::ConnectedState) {
+        QJsonObject method;
+        method["setRenderingTelemetry"] = args;
+        m_kdenlivesocket->write(QJsonDocument(method).toJson());
+        m_kdenlivesocket->flush();
+    }
+#endif
+}
+
 void RenderJob::updateProgress(int speed)
 {
 #ifndef NODBUS
@@ -200,7 +320,6 @@ void RenderJob::updateProgress(int speed)
         qDebug() << "Progress:" << m_progress << "%,"
                  << "frame" << m_frame;
     }
-    m_logstream << QStringLiteral("%1\t%2\t%3\n").arg(m_seconds).arg(m_frame).arg(m_progress);
 }
 
 void RenderJob::start()
@@ -233,7 +352,7 @@ void RenderJob::start()
             QString dbusView = QStringLiteral("org.kde.JobViewV2");
             m_jobUiserver = new QDBusInterface(QStringLiteral("org.kde.JobViewServer"), reply, dbusView);
             if (m_jobUiserver->isValid()) {
-                if (!m_args.contains(QStringLiteral("pass=2"))) {
+                if (m_pass != 2) {
                     m_jobUiserver->call(QStringLiteral("setPercent"), 0);
                 }
 
@@ -273,6 +392,7 @@ void RenderJob::start()
 
     // Because of the logging, we connect to stderr in all cases.
     connect(m_renderProcess, &QProcess::readyReadStandardError, this, &RenderJob::receivedStderr);
+    startStage(m_pass > 0 ? QStringLiteral("pass %1").arg(m_pass) : QStringLiteral("render"));
     m_renderProcess->start(m_prog, m_args);
     m_logstream << "Started render process: " << m_prog << ' ' << m_args.join(QLatin1Char(' ')) << "\n";
     m_logstream.flush();
@@ -302,7 +422,7 @@ void RenderJob::initKdenliveDbusInterface()
     m_kdenliveinterface =
         new QDBusInterface(kdenliveId, QStringLiteral("/kdenlive/MainWindow_1"), QStringLiteral("org.kde.kdenlive.rendering"), connection, this);
 
-    if (!m_args.contains(QStringLiteral("pass=2"))) {
+    if (m_pass != 2) {
         m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), {m_dest, 0, 0});
     }
     connect(m_kdenliveinterface, SIGNAL(abortRenderJob(QString)), this, SLOT(slotAbort(QString)));
@@ -343,6 +463,7 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
         QProcess::startDetached(QStringLiteral("kdialog"), args);
         Q_EMIT renderingFinished();
     } else {
+        endStage();
         m_logstream << "Rendering of " << m_dest << " finished"
                     << "\n";
         m_logstream.flush();
@@ -360,6 +481,7 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
                         "-y", "-v", "quiet", "-stats", "-i", m_dest, "-i", m_subtitleFile, "-c", "copy", "-f", "matroska", m_temporaryRenderFile};
                     qDebug() << "::: JOB ARGS: " << args;
                     m_progress = 0;
+                    startStage(QStringLiteral("subtitles"));
                     disconnect(m_renderProcess, &QProcess::stateChanged, this, &RenderJob::slotCheckProcess);
                     disconnect(m_renderProcess, &QProcess::readyReadStandardError, this, &RenderJob::receivedStderr);
                     m_subsProcess = new QProcess(&m_looper);
@@ -372,6 +494,7 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
                     return;
                 }
             }
+            sendTelemetry();
             sendFinish(-1, QString());
         }
     }
@@ -424,6 +547,8 @@ void RenderJob::slotCheckSubtitleProcess(int exitCode, QProcess::ExitStatus exit
     } else {
         QFile::remove(m_dest);
         QFile::rename(m_temporaryRenderFile, m_dest);
+        endStage();
+        sendTelemetry();
         sendFinish(-1, QString());
     }
     QFile::remove(m_subtitleFile);
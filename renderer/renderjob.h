@@ -12,8 +12,10 @@
 #include <QDBusInterface>
 #endif
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QFile>
+#include <QJsonObject>
 #include <QObject>
 #include <QProcess>
 // Testing
@@ -27,6 +29,12 @@ public:
     RenderJob(const QString &render, const QString &scenelist, const QString &target, int pid = -1, int in = -1, int out = -1,
               const QString &subtitleFile = QString(), QObject *parent = nullptr);
     ~RenderJob() override;
+    /** @brief Replace the arguments passed to the render process, by default melt arguments to render the scenelist */
+    void setRenderArguments(const QStringList &args);
+    /** @brief Frame rate of the rendered profile, used to compute the output bitrate */
+    void setFrameRate(double fps);
+    /** @brief Pass of a two pass encoding (1 or 2), 0 for a single pass job */
+    void setPass(int pass);
 
 public Q_SLOTS:
     void start();
@@ -72,6 +80,19 @@ private:
     QStringList m_args;
     /** @brief Used to write to the log file. */
     QTextStream m_logstream;
+    double m_frameRate{0.};
+    int m_pass{0};
+    /** @brief Current stage of the job (render or subtitles) and its duration */
+    QString m_stage;
+    QElapsedTimer m_stageTimer;
+    /** @brief Duration in seconds of the finished stages */
+    QJsonObject m_stageTimes;
+    /** @brief Values of the last telemetry sample, to compute the speed and processor usage since */
+    qint64 m_sampleTime{0};
+    int m_sampleFrame{0};
+    qint64 m_sampleCpuTime{-1};
+    double m_fps{0.};
+    double m_cpuUsage{-1.};
 #ifdef NODBUS
     void fromServer();
 #else
@@ -79,6 +100,12 @@ private:
 #endif
     void sendFinish(int status, const QString &error);
     void updateProgress(int speed = -1);
+    /** @brief Update the speed and processor usage from the current frame */
+    void sampleTelemetry();
+    /** @brief Send the detailed state of the job: speed, bitrate, remaining time and stage durations */
+    void sendTelemetry();
+    void startStage(const QString &stage);
+    void endStage();
     void sendProgress();
 
 Q_SIGNALS:
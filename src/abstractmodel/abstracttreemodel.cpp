@@ -121,9 +121,9 @@ QModelIndex AbstractTreeModel::getIndexFromItem(const std::shared_ptr<TreeItem>
     if (item == rootItem) {
         return QModelIndex();
     }
-    if (auto ptr = item->parentItem().lock()) {
-        auto parentIndex = getIndexFromItem(ptr);
-        return index(item->row(), column, parentIndex);
+    if (item->parentItem().lock()) {
+        // The row is cached in the item, no need to walk up the tree
+        return createIndex(item->row(), column, quintptr(item->getId()));
     }
     return QModelIndex();
 }
@@ -12,6 +12,7 @@
 TreeItem::TreeItem(QList<QVariant> data, const std::shared_ptr<AbstractTreeModel> &model, bool isRoot, int id)
     : m_itemData(std::move(data))
     , m_model(model)
+    , m_row(-1)
     , m_depth(0)
     , m_id(id == -1 ? AbstractTreeModel::getNextId() : id)
     , m_isInModel(false)
@@ -70,9 +71,8 @@ bool TreeItem::appendChild(const std::shared_ptr<TreeItem> &child)
     if (auto ptr = m_model.lock()) {
         ptr->notifyRowAboutToAppend(shared_from_this());
         child->updateParent(shared_from_this());
-        int id = child->getId();
-        auto it = m_childItems.insert(m_childItems.end(), child);
-        m_iteratorTable[id] = it;
+        child->m_row = int(m_childItems.size());
+        m_childItems.push_back(child);
         registerSelf(child);
         ptr->notifyRowAppended(child);
         return true;
@@ -86,20 +86,19 @@ void TreeItem::moveChild(int ix, const std::shared_ptr<TreeItem> &child)
 {
     if (auto ptr = m_model.lock()) {
         auto parentPtr = child->m_parentItem.lock();
+        int firstChanged = int(m_childItems.size());
         if (parentPtr && parentPtr->getId() != m_id) {
             parentPtr->removeChild(child);
-        } else {
+        } else if (parentPtr) {
             // deletion of child
-            auto it = m_iteratorTable[child->getId()];
-            m_childItems.erase(it);
+            firstChanged = child->row();
+            m_childItems.erase(m_childItems.begin() + firstChanged);
         }
         ptr->notifyRowAboutToAppend(shared_from_this());
         child->updateParent(shared_from_this());
-        int id = child->getId();
-        auto pos = m_childItems.begin();
-        std::advance(pos, ix);
-        auto it = m_childItems.insert(pos, child);
-        m_iteratorTable[id] = it;
+        ix = qBound(0, ix, int(m_childItems.size()));
+        m_childItems.insert(m_childItems.begin() + ix, child);
+        updateRows(size_t(qMin(firstChanged, ix)));
         ptr->notifyRowAppended(child);
         m_isInModel = true;
     } else {
@@ -111,14 +110,13 @@ void TreeItem::moveChild(int ix, const std::shared_ptr<TreeItem> &child)
 void TreeItem::removeChild(const std::shared_ptr<TreeItem> &child)
 {
     if (auto ptr = m_model.lock()) {
-        ptr->notifyRowAboutToDelete(shared_from_this(), child->row());
-        // get iterator corresponding to child
-        Q_ASSERT(m_iteratorTable.count(child->getId()) > 0);
-        auto it = m_iteratorTable[child->getId()];
-        // deletion of child
-        m_childItems.erase(it);
-        // clean iterator table
-        m_iteratorTable.erase(child->getId());
+        int row = child->row();
+        Q_ASSERT(row >= 0 && row < int(m_childItems.size()) && m_childItems[size_t(row)] == child);
+        ptr->notifyRowAboutToDelete(shared_from_this(), row);
+        // deletion of child, renumber the following children
+        m_childItems.erase(m_childItems.begin() + row);
+        updateRows(size_t(row));
+        child->m_row = -1;
         child->m_depth = 0;
         child->m_parentItem.reset();
         child->deregisterSelf();
@@ -154,9 +152,7 @@ bool TreeItem::changeParent(std::shared_ptr<TreeItem> newParent)
 std::shared_ptr<TreeItem> TreeItem::child(int row) const
 {
     Q_ASSERT(row >= 0 && row < int(m_childItems.size()));
-    auto it = m_childItems.cbegin();
-    std::advance(it, row);
-    return (*it);
+    return m_childItems[size_t(row)];
 }
 
 int TreeItem::childCount() const
@@ -187,13 +183,19 @@ std::weak_ptr<TreeItem> TreeItem::parentItem() const
 int TreeItem::row() const
 {
     if (auto ptr = m_parentItem.lock()) {
-        // we compute the distance in the parent's children list
-        auto it = ptr->m_childItems.begin();
-        return int(std::distance(it, static_cast<decltype(it)>(ptr->m_iteratorTable.at(m_id))));
+        Q_ASSERT(m_row >= 0 && m_row < ptr->childCount() && ptr->m_childItems[size_t(m_row)].get() == this);
+        return m_row;
     }
     return -1;
 }
 
+void TreeItem::updateRows(size_t from)
+{
+    for (size_t i = from; i < m_childItems.size(); ++i) {
+        m_childItems[i]->m_row = int(i);
+    }
+}
+
 int TreeItem::depth() const
 {
     return m_depth;
@@ -10,6 +10,7 @@
 #include <QVariant>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 class AbstractTreeModel;
 
@@ -92,6 +93,7 @@ public:
 
     /** @brief Return the index of current item amongst father's children
        Returns -1 on error (eg: no parent set)
+       The rows are cached and updated when children are inserted or removed, so this is constant time
      */
     int row() const;
 
@@ -139,9 +141,12 @@ protected:
     */
     virtual void updateParent(std::shared_ptr<TreeItem> parent);
 
-    std::list<std::shared_ptr<TreeItem>> m_childItems;
-    std::unordered_map<int, std::list<std::shared_ptr<TreeItem>>::iterator>
-        m_iteratorTable; // this logs the iterator associated which each child id. This allows easy access of a child based on its id.
+    /** @brief Update the cached row of the children from index @p from, after an insertion or a removal */
+    void updateRows(size_t from);
+
+    std::vector<std::shared_ptr<TreeItem>> m_childItems;
+    /** @brief Cached index of this item amongst its parent's children, see row() */
+    int m_row;
 
     QList<QVariant> m_itemData;
     std::weak_ptr<TreeItem> m_parentItem;
@@ -66,6 +66,22 @@ protected:
     void init();
     virtual Mlt::Properties *retrieveListFromMlt() const = 0;
 
+    /** @brief Returns a hash identifying the inputs of the parsed asset list: MLT version and services, language, asset files
+       @param mltAssets is the list of MLT's available assets
+    */
+    QByteArray cacheFingerprint(Mlt::Properties *mltAssets) const;
+    /** @brief Returns the path of the file storing the parsed assets between sessions */
+    QString assetCachePath() const;
+    /** @brief Fill the asset list from the cache file, if it was created with the same fingerprint
+       @return true on success
+    */
+    bool loadCache(const QByteArray &fingerprint);
+    /** @brief Write the parsed asset list to the cache file */
+    void saveCache(const QByteArray &fingerprint) const;
+
+    /** @brief Returns the name of the cache file for this kind of assets */
+    virtual QString assetCacheName() const = 0;
+
     /** @brief Parse some info from a mlt structure
        @param res Datastructure to fill
        @return true on success
@@ -102,6 +118,8 @@ protected:
     virtual QString assetPreferredListPath() const = 0;
 
     std::unordered_map<QString, Info> m_assets;
+    /** @brief True if the asset list was read from the cache instead of parsed */
+    bool m_loadedFromCache{false};
 
     QSet<QString> m_excludedList;
     QSet<QString> m_includedList;
@@ -7,18 +7,27 @@
 #include "kdenlivesettings.h"
 #include "core.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QString>
 #include <QTextStream>
 #include <KLocalizedString>
+#include <config-kdenlive.h>
 
 #include <locale>
 #ifdef Q_OS_MAC
 #include <xlocale.h>
 #endif
 
+// Increase when the Info structure or its serialization changes
+static const int assetCacheVersion = 1;
+
 template <typename AssetType> AbstractAssetsRepository<AssetType>::AbstractAssetsRepository() = default;
 
 template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
@@ -32,6 +41,16 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
 
     // Retrieve the list of MLT's available assets.
     QScopedPointer<Mlt::Properties> assets(retrieveListFromMlt());
+
+    // Parsing MLT metadata and asset files is slow, reuse the result of a previous session if nothing changed
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray fingerprint = cacheFingerprint(assets.data());
+    if (loadCache(fingerprint)) {
+        m_loadedFromCache = true;
+        qDebug() << "Loaded" << m_assets.size() << "assets from cache" << assetCachePath() << "in" << timer.elapsed() << "ms";
+        return;
+    }
     QStringList emptyMetaAssets;
     int max = assets->count();
     QString sox = QStringLiteral("sox.");
@@ -126,6 +145,129 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
     for (const auto &invalid : qAsConst(emptyMetaAssets)) {
         m_assets.erase(invalid);
     }
+    saveCache(fingerprint);
+    qDebug() << "Parsed" << m_assets.size() << "assets in" << timer.elapsed() << "ms";
+}
+
+template <typename AssetType> QByteArray AbstractAssetsRepository<AssetType>::cacheFingerprint(Mlt::Properties *mltAssets) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(assetCacheVersion));
+    hash.addData(QByteArray(KDENLIVE_VERSION));
+    hash.addData(QByteArray(mlt_version_get_string()));
+    // Asset names and descriptions are translated
+    hash.addData(KLocalizedString::languages().join(QLatin1Char(',')).toUtf8());
+    // Installing a plugin does not always change MLT's version
+    int max = mltAssets->count();
+    for (int i = 0; i < max; ++i) {
+        hash.addData(QByteArray(mltAssets->get_name(i)).append('\n'));
+    }
+    // Only file dates are checked, the files are parsed if anything changed
+    QFileInfoList files;
+    QStringList lists = assetExcludedPath() + assetIncludedPath();
+    lists << assetPreferredListPath();
+    for (const QString &path : qAsConst(lists)) {
+        if (!path.isEmpty()) {
+            files << QFileInfo(path);
+        }
+    }
+    const QStringList asset_dirs = assetDirs();
+    for (const QString &dir : asset_dirs) {
+        files << QFileInfo(dir);
+        files << QDir(dir).entryInfoList({QStringLiteral("*.xml")}, QDir::Files, QDir::Name);
+    }
+    for (const QFileInfo &info : qAsConst(files)) {
+        hash.addData(info.absoluteFilePath().toUtf8());
+        hash.addData(QByteArray::number(info.size()));
+        hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    }
+    return hash.result();
+}
+
+template <typename AssetType> QString AbstractAssetsRepository<AssetType>::assetCachePath() const
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    return dir.absoluteFilePath(QStringLiteral("assets/%1.cache").arg(assetCacheName()));
+}
+
+template <typename AssetType> bool AbstractAssetsRepository<AssetType>::loadCache(const QByteArray &fingerprint)
+{
+    QFile file(assetCachePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    // Read everything at once
+    QByteArray data = file.readAll();
+    file.close();
+    QDataStream stream(data);
+    int version;
+    QByteArray cachedFingerprint;
+    stream >> version >> cachedFingerprint;
+    if (version != assetCacheVersion || cachedFingerprint != fingerprint) {
+        return false;
+    }
+    int count;
+    QString xmlData;
+    stream >> count >> xmlData;
+    // All asset descriptions are stored in one document, in the same order as the assets
+    QDomDocument doc;
+    if (stream.status() != QDataStream::Ok || !doc.setContent(xmlData)) {
+        return false;
+    }
+    std::unordered_map<QString, Info> assets;
+    QDomElement xml = doc.documentElement().firstChildElement();
+    for (int i = 0; i < count; ++i) {
+        Info info;
+        int type;
+        bool hasXml;
+        stream >> info.id >> info.mltId >> info.name >> info.description >> info.author >> info.version_str >> info.version >> info.included >> type >>
+            hasXml;
+        info.type = AssetType(type);
+        if (xml.isNull()) {
+            return false;
+        }
+        if (hasXml) {
+            info.xml = xml;
+        }
+        xml = xml.nextSiblingElement();
+        assets[info.id] = info;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    m_assets = std::move(assets);
+    return true;
+}
+
+template <typename AssetType> void AbstractAssetsRepository<AssetType>::saveCache(const QByteArray &fingerprint) const
+{
+    QFileInfo info(assetCachePath());
+    if (!QDir().mkpath(info.absolutePath())) {
+        return;
+    }
+    QDomDocument doc;
+    QDomElement root = doc.createElement(QStringLiteral("assets"));
+    doc.appendChild(root);
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    for (const auto &asset : m_assets) {
+        const Info &a = asset.second;
+        if (a.xml.isNull()) {
+            // Placeholder to keep the descriptions in the same order as the assets
+            root.appendChild(doc.createElement(QStringLiteral("none")));
+        } else {
+            root.appendChild(doc.importNode(a.xml, true));
+        }
+        stream << a.id << a.mltId << a.name << a.description << a.author << a.version_str << a.version << a.included << int(a.type) << !a.xml.isNull();
+    }
+    QSaveFile file(info.absoluteFilePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream out(&file);
+    out << assetCacheVersion << fingerprint << int(m_assets.size()) << doc.toString(-1);
+    out.writeRawData(data.constData(), data.size());
+    file.commit();
 }
 
 template <typename AssetType> void AbstractAssetsRepository<AssetType>::parseAssetList(const QStringList &filePaths, QSet<QString> &destination)
@@ -87,6 +87,13 @@ const QString KeyframeModelList::getAssetRow()
     return QString();
 }
 
+const QString KeyframeModelList::mergeKey(GenTime pos)
+{
+    const ObjectId owner = getOwnerId();
+    return QStringLiteral("%1:%2:%3:%4")
+        .arg(owner.uuid.toString(), QString::number(owner.itemId), getAssetRow(), QString::number(pos.frames(pCore->getCurrentFps())));
+}
+
 void KeyframeModelList::addParameter(const QModelIndex &index, int in, int out)
 {
     std::shared_ptr<KeyframeModel> parameter(new KeyframeModel(m_model, index, m_undoStack, in, out));
@@ -398,7 +405,7 @@ bool KeyframeModelList::moveKeyframe(GenTime oldPos, GenTime pos, bool logUndo,
         return res;
     }
     if (res) {
-        PUSH_UNDO(undo, redo, opText);
+        PUSH_CHAINED_UNDO(undo, redo, opText, UndoMergeId::MoveKeyframe, mergeKey(oldPos), mergeKey(pos));
         return true;
     } else {
         return false;
@@ -499,7 +506,7 @@ bool KeyframeModelList::updateKeyframe(GenTime oldPos, GenTime pos, const QVaria
         }
     }
     if (res) {
-        PUSH_UNDO(undo, redo, opText);
+        PUSH_CHAINED_UNDO(undo, redo, opText, UndoMergeId::MoveKeyframe, mergeKey(oldPos), mergeKey(pos));
         return true;
     } else {
         return false;
@@ -179,6 +179,8 @@ public:
 protected:
     /** @brief Helper function to apply a given operation on all parameters */
     bool applyOperation(const std::function<bool(std::shared_ptr<KeyframeModel>, bool, Fun &, Fun &)> &op, Fun &undo, Fun &redo);
+    /** @brief Key used to merge successive moves of the keyframe at @p pos on this asset into a single undo step */
+    const QString mergeKey(GenTime pos);
 
 Q_SIGNALS:
     void modelChanged();
@@ -7,6 +7,7 @@
 #include "assets/model/assetparametermodel.hpp"
 #include "core.h"
 #include "mainwindow.h"
+#include "mltconnection.h"
 
 #include <QDir>
 #include <QDomDocument>
@@ -148,16 +149,17 @@ void ListDependencyParamWidget::slotRefresh()
         // Create thumbnails
         if (pCore->getCurrentFrameSize().width() > 1000) {
             // HD project
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("16_9"));
+            values = MltConnection::lumaFiles(QStringLiteral("16_9"));
         } else if (pCore->getCurrentFrameSize().height() > 1000) {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("9_16"));
+            values = MltConnection::lumaFiles(QStringLiteral("9_16"));
         } else if (pCore->getCurrentFrameSize().height() == pCore->getCurrentFrameSize().width()) {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("square"));
+            values = MltConnection::lumaFiles(QStringLiteral("square"));
         } else if (pCore->getCurrentFrameSize().height() == 480) {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("NTSC"));
+            values = MltConnection::lumaFiles(QStringLiteral("NTSC"));
         } else {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("PAL"));
+            values = MltConnection::lumaFiles(QStringLiteral("PAL"));
         }
+        pCore->buildLumaThumbs(values);
         m_list->addItem(i18n("None (Dissolve)"));
         for (int j = 0; j < values.count(); ++j) {
             const QString &entry = values.at(j);
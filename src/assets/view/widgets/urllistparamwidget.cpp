@@ -125,15 +125,15 @@ void UrlListParamWidget::slotRefresh()
         names.clear();
         if (pCore->getCurrentFrameSize().width() > 1000) {
             // HD project
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("16_9"));
+            values = MltConnection::lumaFiles(QStringLiteral("16_9"));
         } else if (pCore->getCurrentFrameSize().height() > 1000) {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("9_16"));
+            values = MltConnection::lumaFiles(QStringLiteral("9_16"));
         } else if (pCore->getCurrentFrameSize().height() == pCore->getCurrentFrameSize().width()) {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("square"));
+            values = MltConnection::lumaFiles(QStringLiteral("square"));
         } else if (pCore->getCurrentFrameSize().height() == 480) {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("NTSC"));
+            values = MltConnection::lumaFiles(QStringLiteral("NTSC"));
         } else {
-            values = MainWindow::m_lumaFiles.value(QStringLiteral("PAL"));
+            values = MltConnection::lumaFiles(QStringLiteral("PAL"));
         }
         m_list->addItem(i18n("None (Dissolve)"));
     }
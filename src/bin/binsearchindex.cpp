@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "binsearchindex.hpp"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+QString BinSearchIndex::fold(const QString &text)
+{
+    return text.toCaseFolded();
+}
+
+QSet<quint64> BinSearchIndex::trigrams(const QString &folded)
+{
+    QSet<quint64> result;
+    const int count = folded.size() - 2;
+    if (count <= 0) {
+        return result;
+    }
+    result.reserve(count);
+    const QChar *data = folded.constData();
+    for (int i = 0; i < count; ++i) {
+        result.insert((quint64(data[i].unicode()) << 32) | (quint64(data[i + 1].unicode()) << 16) | quint64(data[i + 2].unicode()));
+    }
+    return result;
+}
+
+void BinSearchIndex::setItem(int id, int parentId, const QString &text)
+{
+    const QString folded = fold(text);
+    QWriteLocker locker(&m_lock);
+    auto it = m_items.find(id);
+    QSet<quint64> previous;
+    if (it != m_items.end()) {
+        if (it->text == folded) {
+            it->parentId = parentId;
+            return;
+        }
+        previous = trigrams(it->text);
+    }
+    const QSet<quint64> current = trigrams(folded);
+    for (quint64 key : qAsConst(previous)) {
+        if (!current.contains(key)) {
+            auto posting = m_postings.find(key);
+            if (posting != m_postings.end()) {
+                posting->remove(id);
+                if (posting->isEmpty()) {
+                    m_postings.erase(posting);
+                }
+            }
+        }
+    }
+    for (quint64 key : current) {
+        if (!previous.contains(key)) {
+            m_postings[key].insert(id);
+        }
+    }
+    m_items.insert(id, {parentId, folded});
+}
+
+void BinSearchIndex::removeItem(int id)
+{
+    QWriteLocker locker(&m_lock);
+    auto it = m_items.find(id);
+    if (it == m_items.end()) {
+        return;
+    }
+    const QSet<quint64> keys = trigrams(it->text);
+    for (quint64 key : keys) {
+        auto posting = m_postings.find(key);
+        if (posting != m_postings.end()) {
+            posting->remove(id);
+            if (posting->isEmpty()) {
+                m_postings.erase(posting);
+            }
+        }
+    }
+    m_items.erase(it);
+}
+
+void BinSearchIndex::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_items.clear();
+    m_postings.clear();
+}
+
+int BinSearchIndex::count() const
+{
+    QReadLocker locker(&m_lock);
+    return m_items.size();
+}
+
+bool BinSearchIndex::matches(int id, const QString &foldedNeedle) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_items.constFind(id);
+    if (it == m_items.constEnd()) {
+        return false;
+    }
+    return it->text.contains(foldedNeedle);
+}
+
+BinSearchIndex::Result BinSearchIndex::query(const QString &needle) const
+{
+    Result result;
+    result.needle = fold(needle);
+    QReadLocker locker(&m_lock);
+    if (result.needle.size() < 3) {
+        // Too short to use the trigrams, check all items
+        for (auto it = m_items.constBegin(); it != m_items.constEnd(); ++it) {
+            if (it->text.contains(result.needle)) {
+                result.matches.insert(it.key());
+            }
+        }
+    } else {
+        // Start from the least common trigram of the search string, then check the candidates
+        const QSet<quint64> keys = trigrams(result.needle);
+        const QSet<int> *candidates = nullptr;
+        for (quint64 key : keys) {
+            auto posting = m_postings.constFind(key);
+            if (posting == m_postings.constEnd()) {
+                return result;
+            }
+            if (candidates == nullptr || posting->size() < candidates->size()) {
+                candidates = &posting.value();
+            }
+        }
+        for (int id : *candidates) {
+            if (m_items.value(id).text.contains(result.needle)) {
+                result.matches.insert(id);
+            }
+        }
+    }
+    for (int id : qAsConst(result.matches)) {
+        int parentId = m_items.value(id).parentId;
+        while (!result.ancestors.contains(parentId)) {
+            auto parent = m_items.constFind(parentId);
+            if (parent == m_items.constEnd()) {
+                break;
+            }
+            result.ancestors.insert(parentId);
+            parentId = parent->parentId;
+        }
+    }
+    return result;
+}
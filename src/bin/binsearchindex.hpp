@@ -0,0 +1,63 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+
+/** @class BinSearchIndex
+    @brief Trigram index over the searchable text of the bin items (name, date, description, tags and markers).
+    It is updated incrementally by the ProjectItemModel when items are inserted, removed or modified, and can
+    be queried from a worker thread so that filtering a large bin does not block the interface.
+    Items are identified by their tree id, and the parent id is stored so that a query also returns the
+    folders containing the matching items.
+ */
+class BinSearchIndex
+{
+public:
+    struct Result
+    {
+        /** @brief The folded search string this result was computed for */
+        QString needle;
+        /** @brief Ids of the items whose text contains the search string */
+        QSet<int> matches;
+        /** @brief Ids of the parents of the matching items, recursively */
+        QSet<int> ancestors;
+    };
+
+    BinSearchIndex() = default;
+
+    /** @brief Normalize a text or a search string for case insensitive comparison */
+    static QString fold(const QString &text);
+
+    /** @brief Store the searchable text of an item, replacing its previous entry */
+    void setItem(int id, int parentId, const QString &text);
+    /** @brief Remove an item from the index */
+    void removeItem(int id);
+    /** @brief Remove all items */
+    void clear();
+    /** @brief Number of indexed items */
+    int count() const;
+
+    /** @brief Returns true if the text of the item contains the given string, which must already be folded */
+    bool matches(int id, const QString &foldedNeedle) const;
+    /** @brief Returns the items containing the given string and their ancestors. This is thread safe. */
+    Result query(const QString &needle) const;
+
+private:
+    struct Entry
+    {
+        int parentId;
+        QString text;
+    };
+    mutable QReadWriteLock m_lock;
+    QHash<int, Entry> m_items;
+    QHash<quint64, QSet<int>> m_postings;
+
+    static QSet<quint64> trigrams(const QString &folded);
+};
@@ -8,12 +8,24 @@
 #include <KDirWatch>
 #include <QFileInfo>
 
+namespace {
+// A file is only reloaded once it was not modified for this delay
+const qint64 modifiedDelay = 2000;
+
+QString parentDir(const QString &url)
+{
+    return QFileInfo(url).absolutePath();
+}
+} // namespace
+
 FileWatcher::FileWatcher(QObject *parent)
     : QObject(parent)
     , m_fileWatcher(new KDirWatch)
+    , m_watchDirs(m_fileWatcher->internalMethod() == KDirWatch::INotify)
 {
     // Init clip modification tracker
-    m_modifiedTimer.setInterval(2000);
+    m_clock.start();
+    m_modifiedTimer.setSingleShot(true);
     connect(m_fileWatcher.get(), &KDirWatch::dirty, this, &FileWatcher::slotUrlModified);
     connect(m_fileWatcher.get(), &KDirWatch::deleted, this, &FileWatcher::slotUrlMissing);
     connect(m_fileWatcher.get(), &KDirWatch::created, this, &FileWatcher::slotUrlAdded);
@@ -25,22 +37,18 @@ FileWatcher::FileWatcher(QObject *parent)
 
 void FileWatcher::slotProcessQueue()
 {
-    if (m_pendingUrls.size() == 0) {
-        return;
-    }
-    auto iter = m_pendingUrls.begin();
-    doAddFile(iter->first, iter->second);
-    m_pendingUrls.erase(iter->first);
-    if (m_pendingUrls.size() > 0 && !m_queueTimer.isActive()) {
-        m_queueTimer.start();
+    // Clips of a project are usually stored in a few folders, so with inotify this only adds a few directory watches
+    for (const auto &pending : m_pendingUrls) {
+        doAddFile(pending.first, pending.second);
     }
+    m_pendingUrls.clear();
 }
 
 void FileWatcher::addFile(const QString &binId, const QString &url)
 {
     std::unordered_map<QString, std::unordered_set<QString>>::const_iterator pos = m_occurences.find(url);
     if (pos != m_occurences.end()) {
-        // Url already queued, only add ref to binId if necessary
+        // Url already watched, only add ref to binId if necessary
         if (pos->second.find(binId) == pos->second.end()) {
             m_occurences[url].insert(binId);
             m_binClipPaths[binId] = url;
@@ -59,8 +67,15 @@ void FileWatcher::doAddFile(const QString &binId, const QString &url)
         return;
     }
     if (m_occurences.count(url) == 0) {
-        // QtConcurrent::run([=] { KDirWatch::self()->addFile(url); });
-        m_fileWatcher->addFile(url);
+        if (m_watchDirs) {
+            // Watching the folder with its files reports changes on each file, with the file path
+            const QString dir = parentDir(url);
+            if (m_watchedDirs[dir]++ == 0) {
+                m_fileWatcher->addDir(dir, KDirWatch::WatchFiles);
+            }
+        } else {
+            m_fileWatcher->addFile(url);
+        }
     }
     m_occurences[url].insert(binId);
     m_binClipPaths[binId] = url;
@@ -68,6 +83,7 @@ void FileWatcher::doAddFile(const QString &binId, const QString &url)
 
 void FileWatcher::removeFile(const QString &binId)
 {
+    m_pendingUrls.erase(binId);
     if (m_binClipPaths.count(binId) == 0) {
         return;
     }
@@ -75,62 +91,115 @@ void FileWatcher::removeFile(const QString &binId)
     m_occurences[url].erase(binId);
     m_binClipPaths.erase(binId);
     if (m_occurences[url].empty()) {
-        m_fileWatcher->removeFile(url);
         m_occurences.erase(url);
+        m_modifiedUrls.erase(url);
+        if (!m_watchDirs) {
+            m_fileWatcher->removeFile(url);
+            return;
+        }
+        const QString dir = parentDir(url);
+        auto it = m_watchedDirs.find(dir);
+        if (it != m_watchedDirs.end() && --it->second == 0) {
+            m_fileWatcher->removeDir(dir);
+            m_watchedDirs.erase(it);
+        }
     }
 }
 
 void FileWatcher::slotUrlModified(const QString &path)
 {
-    if (m_modifiedUrls.insert(path).second) {
-        for (const QString &id : m_occurences[path]) {
+    // Folder watches also report the other files of the folder, and the folder itself
+    auto occurences = m_occurences.find(path);
+    if (occurences == m_occurences.end()) {
+        return;
+    }
+    if (m_modifiedUrls.count(path) == 0) {
+        for (const QString &id : occurences->second) {
             Q_EMIT binClipWaiting(id);
         }
     }
+    m_modifiedUrls[path] = m_clock.elapsed();
     if (!m_modifiedTimer.isActive()) {
-        m_modifiedTimer.start();
+        scheduleModifiedUrls();
     }
 }
 
 void FileWatcher::slotUrlAdded(const QString &path)
 {
-    for (const QString &id : m_occurences[path]) {
+    auto occurences = m_occurences.find(path);
+    if (occurences == m_occurences.end()) {
+        return;
+    }
+    for (const QString &id : occurences->second) {
         Q_EMIT binClipModified(id);
     }
 }
 
 void FileWatcher::slotUrlMissing(const QString &path)
 {
-    for (const QString &id : m_occurences[path]) {
+    auto occurences = m_occurences.find(path);
+    if (occurences == m_occurences.end()) {
+        return;
+    }
+    m_modifiedUrls.erase(path);
+    for (const QString &id : occurences->second) {
         Q_EMIT binClipMissing(id);
     }
 }
 
+void FileWatcher::scheduleModifiedUrls()
+{
+    if (m_modifiedUrls.empty()) {
+        return;
+    }
+    qint64 first = m_modifiedUrls.begin()->second;
+    for (const auto &modified : m_modifiedUrls) {
+        first = qMin(first, modified.second);
+    }
+    m_modifiedTimer.start(int(qMax(qint64(0), first + modifiedDelay - m_clock.elapsed())));
+}
+
 void FileWatcher::slotProcessModifiedUrls()
 {
-    auto checkList = m_modifiedUrls;
-    for (const QString &path : checkList) {
-        if (m_fileWatcher->ctime(path).msecsTo(QDateTime::currentDateTime()) > 2000) {
-            for (const QString &id : m_occurences[path]) {
-                Q_EMIT binClipModified(id);
+    const qint64 now = m_clock.elapsed();
+    QStringList reloadIds;
+    for (auto it = m_modifiedUrls.begin(); it != m_modifiedUrls.end();) {
+        if (now - it->second < modifiedDelay) {
+            ++it;
+            continue;
+        }
+        auto occurences = m_occurences.find(it->first);
+        if (occurences != m_occurences.end()) {
+            for (const QString &id : occurences->second) {
+                reloadIds << id;
             }
-            m_modifiedUrls.erase(path);
         }
+        it = m_modifiedUrls.erase(it);
     }
-    if (m_modifiedUrls.empty()) {
-        m_modifiedTimer.stop();
+    scheduleModifiedUrls();
+    // Reloading a clip updates its watched url, so only emit once we are done with the lists
+    for (const QString &id : qAsConst(reloadIds)) {
+        Q_EMIT binClipModified(id);
     }
 }
 
 void FileWatcher::clear()
 {
     m_queueTimer.stop();
+    m_modifiedTimer.stop();
     m_fileWatcher->stopScan();
-    for (const auto &f : m_occurences) {
-        m_fileWatcher->removeFile(f.first);
+    if (m_watchDirs) {
+        for (const auto &dir : m_watchedDirs) {
+            m_fileWatcher->removeDir(dir.first);
+        }
+    } else {
+        for (const auto &url : m_occurences) {
+            m_fileWatcher->removeFile(url.first);
+        }
     }
     m_pendingUrls.clear();
     m_occurences.clear();
+    m_watchedDirs.clear();
     m_modifiedUrls.clear();
     m_binClipPaths.clear();
     m_fileWatcher->startScan();
@@ -138,5 +207,5 @@ void FileWatcher::clear()
 
 bool FileWatcher::contains(const QString &path) const
 {
-    return m_fileWatcher->contains(path);
+    return m_occurences.count(path) > 0;
 }
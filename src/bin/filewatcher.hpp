@@ -7,6 +7,7 @@
 
 #include "definitions.h"
 #include <KDirWatch>
+#include <QElapsedTimer>
 #include <QTimer>
 #include <unordered_map>
 #include <unordered_set>
@@ -14,6 +15,9 @@
 /** @class FileWatcher
     @brief This class is responsible for watching all files used in the project
     and triggers a reload notification when a file changes.
+    With inotify, files are watched through their parent folder, so that a project with thousands of clips
+    only needs one watch descriptor per media folder. Other backends would poll every file of the folder,
+    so they watch each used file instead.
  */
 class FileWatcher : public QObject
 {
@@ -32,8 +36,8 @@ public:
     void clear();
 
 Q_SIGNALS:
-    /** @brief This signal is triggered whenever the file corresponding to a bin clip has been modified and should be reloaded. Note that this signal is sent no
-     * more than every 1500 ms. We also make sure that at least 1000ms has passed since the last modification of the file. */
+    /** @brief This signal is triggered whenever the file corresponding to a bin clip has been modified and should be reloaded.
+     * It is only sent once no modification of the file was reported for 2000ms, so that a file being written triggers a single reload. */
     void binClipModified(const QString &binId);
     /** @brief Same signal than binClipModified, but triggers immediately. Can be useful to refresh UI without actually reloading the file (yet)*/
     void binClipWaiting(const QString &binId);
@@ -54,14 +58,22 @@ private:
     /// keys are binId, keys are stored paths
     std::unordered_map<QString, QString> m_binClipPaths;
 
-    /// List of files for which we received an update since the last send
-    std::unordered_set<QString> m_modifiedUrls;
+    /// True if files are watched through their parent folder, only with the inotify backend
+    bool m_watchDirs;
+    /// Watched folders, with the number of watched urls they contain
+    std::unordered_map<QString, int> m_watchedDirs;
 
-    /// When loading a project or adding many clips, adding many files to the watcher causes a freeze, so queue them
+    /// Files for which we received an update since the last send, with the time of their last update
+    std::unordered_map<QString, qint64> m_modifiedUrls;
+    QElapsedTimer m_clock;
+
+    /// When loading a project or adding many clips, files are queued and registered together on the next event loop run
     std::unordered_map<QString, QString> m_pendingUrls;
 
     QTimer m_modifiedTimer;
     QTimer m_queueTimer;
     /// Add a file to the list of watched items
     void doAddFile(const QString &binId, const QString &url);
+    /// Start the modified timer for the first file that will have settled
+    void scheduleModifiedUrls();
 };
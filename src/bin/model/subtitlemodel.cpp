@@ -185,7 +185,7 @@ void SubtitleModel::importSubtitle(const QString &filePath, int offset, bool ext
         Q_EMIT modelChanged();
         return true;
     };
-    ulong initialCount = m_subtitleList.size();
+    QList<SubtitledTime> parsedSubtitles;
     GenTime subtitleOffset(offset, pCore->getCurrentFps());
     if (filePath.endsWith(".srt") || filePath.endsWith(".vtt") || filePath.endsWith(".sbv")) {
         // if (!filePath.endsWith(".vtt") || !filePath.endsWith(".sbv")) {defaultTurn = -10;}
@@ -255,7 +255,7 @@ void SubtitleModel::importSubtitle(const QString &filePath, int offset, bool ext
                 turn++;
             } else {
                 if (endPos > startPos) {
-                    addSubtitle(startPos + subtitleOffset, endPos + subtitleOffset, comment, undo, redo, false);
+                    parsedSubtitles << SubtitledTime(startPos + subtitleOffset, comment, endPos + subtitleOffset);
                     // qDebug() << "Adding Subtitle: \n  Start time: " << start << "\n  End time: " << end << "\n  Text: " << comment;
                 } else {
                     qDebug() << "===== INVALID SUBTITLE FOUND: " << start << "-" << end << ", " << comment;
@@ -270,7 +270,7 @@ void SubtitleModel::importSubtitle(const QString &filePath, int offset, bool ext
         }
         // Ensure last subtitle is read
         if (endPos > startPos && !comment.isEmpty()) {
-            addSubtitle(startPos + subtitleOffset, endPos + subtitleOffset, comment, undo, redo, false);
+            parsedSubtitles << SubtitledTime(startPos + subtitleOffset, comment, endPos + subtitleOffset);
         }
         srtFile.close();
     } else if (filePath.endsWith(QLatin1String(".ass"))) {
@@ -368,7 +368,7 @@ void SubtitleModel::importSubtitle(const QString &filePath, int offset, bool ext
                             comment = line.section(",", numEventFields - 1);
                             // qDebug()<<"Start: "<< start << "End: "<<end << comment;
                             if (endPos > startPos) {
-                                addSubtitle(startPos + subtitleOffset, endPos + subtitleOffset, comment, undo, redo, false);
+                                parsedSubtitles << SubtitledTime(startPos + subtitleOffset, comment, endPos + subtitleOffset);
                             } else {
                                 qDebug() << "==== FOUND INVALID SUBTITLE ITEM: " << start << "-" << end << ", " << comment;
                             }
@@ -384,7 +384,7 @@ void SubtitleModel::importSubtitle(const QString &filePath, int offset, bool ext
         assFile.close();
     } else {
         if (endPos > startPos) {
-            addSubtitle(startPos + subtitleOffset, endPos + subtitleOffset, comment, undo, redo, false);
+            parsedSubtitles << SubtitledTime(startPos + subtitleOffset, comment, endPos + subtitleOffset);
         } else {
             qDebug() << "===== INVALID VTT SUBTITLE FOUND: " << start << "-" << end << ", " << comment;
         }
@@ -394,7 +394,7 @@ void SubtitleModel::importSubtitle(const QString &filePath, int offset, bool ext
         turn = 0;
         r = 0;
     }
-    if (initialCount == m_subtitleList.size() && externalImport) {
+    if (!addSubtitles(parsedSubtitles, undo, redo) && externalImport) {
         // Nothing imported
         pCore->displayMessage(i18n("The selected file %1 is invalid.", filePath), ErrorMessage);
         return;
@@ -487,6 +487,89 @@ bool SubtitleModel::addSubtitle(GenTime start, GenTime end, const QString &str,
     return true;
 }
 
+bool SubtitleModel::addSubtitles(const QList<SubtitledTime> &subtitles, Fun &undo, Fun &redo)
+{
+    if (isLocked() || subtitles.isEmpty()) {
+        return false;
+    }
+    std::vector<std::pair<int, SubtitledTime>> items;
+    items.reserve(size_t(subtitles.size()));
+    GenTime rangeStart = subtitles.first().start();
+    GenTime rangeEnd = subtitles.first().end();
+    for (const auto &sub : subtitles) {
+        items.emplace_back(TimelineModel::getNextId(), sub);
+        rangeStart = qMin(rangeStart, sub.start());
+        rangeEnd = qMax(rangeEnd, sub.end());
+    }
+    QPair<int, int> range = {rangeStart.frames(pCore->getCurrentFps()), rangeEnd.frames(pCore->getCurrentFps())};
+    Fun local_redo = [this, items, range]() {
+        insertSubtitles(items);
+        pCore->invalidateRange(range);
+        pCore->refreshProjectRange(range);
+        return true;
+    };
+    Fun local_undo = [this, items, range]() {
+        std::vector<int> ids;
+        ids.reserve(items.size());
+        for (const auto &item : items) {
+            ids.push_back(item.first);
+        }
+        removeSubtitles(ids);
+        pCore->invalidateRange(range);
+        pCore->refreshProjectRange(range);
+        return true;
+    };
+    size_t initialCount = m_subtitleList.size();
+    local_redo();
+    if (m_subtitleList.size() == initialCount) {
+        return false;
+    }
+    UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+    return true;
+}
+
+void SubtitleModel::insertSubtitles(const std::vector<std::pair<int, SubtitledTime>> &subtitles)
+{
+    const double fps = pCore->getCurrentFps();
+    int maxFrame = 0;
+    beginResetModel();
+    for (const auto &item : subtitles) {
+        const SubtitledTime &sub = item.second;
+        if (sub.start().frames(fps) < 0 || sub.start().frames(fps) > sub.end().frames(fps) || m_subtitleList.count(sub.start()) > 0) {
+            qDebug() << "==== SKIPPING INVALID SUBTITLE AT: " << sub.start().frames(fps);
+            continue;
+        }
+        registerSubtitle(item.first, sub.start());
+        m_subtitleList[sub.start()] = {sub.subtitle(), sub.end()};
+        updateMaxDuration(sub.start(), sub.end());
+        addSnapPoint(sub.start());
+        addSnapPoint(sub.end());
+        maxFrame = qMax(maxFrame, sub.end().frames(fps));
+    }
+    endResetModel();
+    if (maxFrame > m_timeline->duration()) {
+        m_timeline->updateDuration();
+    }
+}
+
+void SubtitleModel::removeSubtitles(const std::vector<int> &ids)
+{
+    beginResetModel();
+    for (int id : ids) {
+        if (m_allSubtitles.count(id) == 0) {
+            continue;
+        }
+        GenTime start = m_allSubtitles.at(id);
+        GenTime end = m_subtitleList.at(start).second;
+        deregisterSubtitle(id);
+        m_subtitleList.erase(start);
+        removeSnapPoint(start);
+        removeSnapPoint(end);
+    }
+    endResetModel();
+    m_timeline->updateDuration();
+}
+
 bool SubtitleModel::addSubtitle(int id, GenTime start, GenTime end, const QString &str, bool temporary, bool updateFilter)
 {
     if (start.frames(pCore->getCurrentFps()) < 0 || end.frames(pCore->getCurrentFps()) < 0 || isLocked()) {
@@ -508,6 +591,7 @@ bool SubtitleModel::addSubtitle(int id, GenTime start, GenTime end, const QStrin
     int row = getSubtitleIndex(id);
     beginInsertRows(QModelIndex(), row, row);
     m_subtitleList[start] = {str, end};
+    updateMaxDuration(start, end);
     endInsertRows();
     addSnapPoint(start);
     addSnapPoint(end);
@@ -585,10 +669,9 @@ QList<SubtitledTime> SubtitleModel::getAllSubtitles() const
 
 SubtitledTime SubtitleModel::getSubtitle(GenTime startFrame) const
 {
-    for (const auto &subtitles : m_subtitleList) {
-        if (subtitles.first == startFrame) {
-            return SubtitledTime(subtitles.first, subtitles.second.first, subtitles.second.second);
-        }
+    auto it = m_subtitleList.find(startFrame);
+    if (it != m_subtitleList.end()) {
+        return SubtitledTime(it->first, it->second.first, it->second.second);
     }
     return SubtitledTime(GenTime(), QString(), GenTime());
 }
@@ -638,10 +721,11 @@ std::unordered_set<int> SubtitleModel::getItemsInRange(int startFrame, int endFr
     GenTime startTime(startFrame, pCore->getCurrentFps());
     GenTime endTime(endFrame, pCore->getCurrentFps());
     std::unordered_set<int> matching;
-    for (const auto &subtitles : m_subtitleList) {
+    for (auto it = firstOverlapCandidate(startTime); it != m_subtitleList.cend(); ++it) {
+        const auto &subtitles = *it;
         if (endFrame > -1 && subtitles.first > endTime) {
-            // Outside range
-            continue;
+            // Outside range, subtitles are sorted by start position
+            break;
         }
         if (subtitles.first >= startTime || subtitles.second.second > startTime) {
             int sid = getIdForStartPos(subtitles.first);
@@ -673,9 +757,9 @@ int SubtitleModel::cutSubtitle(int position, Fun &undo, Fun &redo)
     }
     GenTime pos(position, pCore->getCurrentFps());
     GenTime start = GenTime(-1);
-    for (const auto &subtitles : m_subtitleList) {
-        if (subtitles.first <= pos && subtitles.second.second > pos) {
-            start = subtitles.first;
+    for (auto it = firstOverlapCandidate(pos); it != m_subtitleList.cend() && it->first <= pos; ++it) {
+        if (it->second.second > pos) {
+            start = it->first;
             break;
         }
     }
@@ -780,6 +864,7 @@ void SubtitleModel::editEndPos(GenTime startPos, GenTime newEndPos, bool refresh
         return;
     }
     m_subtitleList[startPos].second = newEndPos;
+    updateMaxDuration(startPos, newEndPos);
     // Trigger update of the qml view
     int id = getIdForStartPos(startPos);
     int row = getSubtitleIndex(id);
@@ -844,6 +929,7 @@ bool SubtitleModel::requestResize(int id, int size, bool right, Fun &undo, Fun &
         GenTime newEndPos = startPos + GenTime(size, pCore->getCurrentFps());
         operation = [this, id, startPos, endPos, newEndPos, logUndo]() {
             m_subtitleList[startPos].second = newEndPos;
+            updateMaxDuration(startPos, newEndPos);
             removeSnapPoint(endPos);
             addSnapPoint(newEndPos);
             // Trigger update of the qml view
@@ -890,9 +976,10 @@ bool SubtitleModel::requestResize(int id, int size, bool right, Fun &undo, Fun &
         }
         const QString text = m_subtitleList.at(startPos).first;
         operation = [this, id, startPos, newStartPos, endPos, text, logUndo]() {
-            m_allSubtitles[id] = newStartPos;
+            updateSubtitleStart(id, newStartPos);
             m_subtitleList.erase(startPos);
             m_subtitleList[newStartPos] = {text, endPos};
+            updateMaxDuration(newStartPos, endPos);
             // Trigger update of the qml view
             removeSnapPoint(startPos);
             addSnapPoint(newStartPos);
@@ -912,7 +999,7 @@ bool SubtitleModel::requestResize(int id, int size, bool right, Fun &undo, Fun &
             return true;
         };
         reverse = [this, id, startPos, newStartPos, endPos, text, logUndo]() {
-            m_allSubtitles[id] = startPos;
+            updateSubtitleStart(id, startPos);
             m_subtitleList.erase(newStartPos);
             m_subtitleList[startPos] = {text, endPos};
             removeSnapPoint(newStartPos);
@@ -1038,8 +1125,8 @@ bool SubtitleModel::moveSubtitle(int subId, GenTime newPos, bool updateModel, bo
     removeSnapPoint(m_subtitleList[oldPos].second);
     GenTime duration = m_subtitleList[oldPos].second - oldPos;
     GenTime endPos = newPos + duration;
-    int id = getIdForStartPos(oldPos);
-    m_allSubtitles[id] = newPos;
+    int id = subId;
+    updateSubtitleStart(id, newPos);
     m_subtitleList.erase(oldPos);
     m_subtitleList[newPos] = {subtitleText, endPos};
     addSnapPoint(newPos);
@@ -1068,10 +1155,9 @@ bool SubtitleModel::moveSubtitle(int subId, GenTime newPos, bool updateModel, bo
 
 int SubtitleModel::getIdForStartPos(GenTime startTime) const
 {
-    auto findResult =
-        std::find_if(std::begin(m_allSubtitles), std::end(m_allSubtitles), [&](const std::pair<int, GenTime> &pair) { return pair.second == startTime; });
-    if (findResult != std::end(m_allSubtitles)) {
-        return findResult->first;
+    auto findResult = m_startIndex.find(startTime);
+    if (findResult != m_startIndex.end()) {
+        return findResult->second;
     }
     return -1;
 }
@@ -1087,13 +1173,9 @@ GenTime SubtitleModel::getStartPosForId(int id) const
 int SubtitleModel::getPreviousSub(int id) const
 {
     GenTime start = getStartPosForId(id);
-    int row = static_cast<int>(std::distance(m_subtitleList.begin(), m_subtitleList.find(start)));
-    if (row > 0) {
-        row--;
-        auto it = m_subtitleList.begin();
-        std::advance(it, row);
-        const GenTime res = it->first;
-        return getIdForStartPos(res);
+    auto it = m_startIndex.find(start);
+    if (it != m_startIndex.end() && it != m_startIndex.begin()) {
+        return std::prev(it)->second;
     }
     return -1;
 }
@@ -1101,13 +1183,9 @@ int SubtitleModel::getPreviousSub(int id) const
 int SubtitleModel::getNextSub(int id) const
 {
     GenTime start = getStartPosForId(id);
-    int row = static_cast<int>(std::distance(m_subtitleList.begin(), m_subtitleList.find(start)));
-    if (row < static_cast<int>(m_subtitleList.size()) - 1) {
-        row++;
-        auto it = m_subtitleList.begin();
-        std::advance(it, row);
-        const GenTime res = it->first;
-        return getIdForStartPos(res);
+    auto it = m_startIndex.find(start);
+    if (it != m_startIndex.end() && std::next(it) != m_startIndex.end()) {
+        return std::next(it)->second;
     }
     return -1;
 }
@@ -1478,30 +1556,19 @@ QDomElement SubtitleModel::toXml(int sid, QDomDocument &document)
 bool SubtitleModel::isBlankAt(int pos) const
 {
     GenTime matchPos(pos, pCore->getCurrentFps());
-    for (const auto &subtitles : m_subtitleList) {
-        if (subtitles.first > matchPos) {
-            continue;
-        }
-        if (subtitles.second.second > matchPos) {
+    for (auto it = firstOverlapCandidate(matchPos); it != m_subtitleList.cend() && it->first <= matchPos; ++it) {
+        if (it->second.second > matchPos) {
             return false;
         }
     }
     return true;
-    ;
 }
 
 int SubtitleModel::getBlankEnd(int pos) const
 {
     GenTime matchPos(pos, pCore->getCurrentFps());
-    bool found = false;
-    GenTime min;
-    for (const auto &subtitles : m_subtitleList) {
-        if (subtitles.first > matchPos && (min == GenTime() || subtitles.first < min)) {
-            min = subtitles.first;
-            found = true;
-        }
-    }
-    return found ? min.frames(pCore->getCurrentFps()) : 0;
+    auto it = m_subtitleList.upper_bound(matchPos);
+    return it != m_subtitleList.end() ? it->first.frames(pCore->getCurrentFps()) : 0;
 }
 
 int SubtitleModel::getBlankSizeAtPos(int frame) const
@@ -1809,7 +1876,9 @@ void SubtitleModel::activateSubtitle(int ix)
     }
     beginRemoveRows(QModelIndex(), 0, m_allSubtitles.size());
     m_allSubtitles.clear();
+    m_startIndex.clear();
     m_subtitleList.clear();
+    m_maxDuration = GenTime();
     endRemoveRows();
     pCore->currentDoc()->setSequenceProperty(m_timeline->uuid(), QStringLiteral("kdenlive:activeSubtitleIndex"), ix);
     parseSubtitle(workPath);
@@ -1819,6 +1888,7 @@ void SubtitleModel::registerSubtitle(int id, GenTime startTime, bool temporary)
 {
     Q_ASSERT(m_allSubtitles.count(id) == 0);
     m_allSubtitles.emplace(id, startTime);
+    m_startIndex[startTime] = id;
     if (!temporary) {
         m_timeline->m_groups->createGroupItem(id);
     }
@@ -1830,12 +1900,42 @@ void SubtitleModel::deregisterSubtitle(int id, bool temporary)
     if (!temporary && isSelected(id)) {
         m_timeline->requestClearSelection(true);
     }
+    auto it = m_startIndex.find(m_allSubtitles.at(id));
+    if (it != m_startIndex.end() && it->second == id) {
+        m_startIndex.erase(it);
+    }
     m_allSubtitles.erase(id);
+    if (m_allSubtitles.empty()) {
+        m_maxDuration = GenTime();
+    }
     if (!temporary) {
         m_timeline->m_groups->destructGroupItem(id);
     }
 }
 
+void SubtitleModel::updateSubtitleStart(int id, GenTime newStart)
+{
+    auto it = m_startIndex.find(m_allSubtitles.at(id));
+    if (it != m_startIndex.end() && it->second == id) {
+        m_startIndex.erase(it);
+    }
+    m_allSubtitles[id] = newStart;
+    m_startIndex[newStart] = id;
+}
+
+void SubtitleModel::updateMaxDuration(GenTime start, GenTime end)
+{
+    if (end - start > m_maxDuration) {
+        m_maxDuration = end - start;
+    }
+}
+
+std::map<GenTime, std::pair<QString, GenTime>>::const_iterator SubtitleModel::firstOverlapCandidate(GenTime startTime) const
+{
+    // No subtitle is longer than m_maxDuration, so the ones starting earlier cannot reach startTime
+    return m_subtitleList.lower_bound(startTime - m_maxDuration);
+}
+
 int SubtitleModel::positionForIndex(int id) const
 {
     return int(std::distance(m_allSubtitles.begin(), m_allSubtitles.find(id)));
@@ -1877,13 +1977,7 @@ std::pair<int, GenTime> SubtitleModel::getSubtitleIdFromIndex(int index) const
 
 int SubtitleModel::getSubtitleIdByPosition(int pos)
 {
-    GenTime startTime(pos, pCore->getCurrentFps());
-    auto findResult =
-        std::find_if(std::begin(m_allSubtitles), std::end(m_allSubtitles), [&](const std::pair<int, GenTime> &pair) { return pair.second == startTime; });
-    if (findResult != std::end(m_allSubtitles)) {
-        return findResult->first;
-    }
-    return -1;
+    return getIdForStartPos(GenTime(pos, pCore->getCurrentFps()));
 }
 
 int SubtitleModel::getSubtitleIdAtPosition(int pos)
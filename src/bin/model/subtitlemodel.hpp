@@ -44,6 +44,10 @@ public:
     /** @brief Function that parses through a subtitle file */
     bool addSubtitle(int id, GenTime start, GenTime end, const QString &str, bool temporary = false, bool updateFilter = true);
     bool addSubtitle(GenTime start, GenTime end, const QString &str, Fun &undo, Fun &redo, bool updateFilter = true);
+    /** @brief Add a list of subtitles in one operation, the views are only refreshed once
+     *  @returns false if none of the subtitles could be added
+     */
+    bool addSubtitles(const QList<SubtitledTime> &subtitles, Fun &undo, Fun &redo);
     /** @brief Converts string of time to GenTime */
     GenTime stringtoTime(QString &str, const double factor = 1.);
     /** @brief Return model data item according to the role passed */
@@ -224,6 +228,10 @@ private:
     QMap<std::pair<int, QString>, QString> m_subtitlesList;
     /** @brief A list of subtitles as: item id, start time */
     std::map<int, GenTime> m_allSubtitles;
+    /** @brief Reverse index of m_allSubtitles as: start time, item id */
+    std::map<GenTime, int> m_startIndex;
+    /** @brief Upper bound of the subtitle durations, used to find the subtitles starting before a range that overlap it */
+    GenTime m_maxDuration;
     /** @brief A list of subtitles as: item index, fake start time */
     std::map<int, int> m_subtitlesFakePos;
     QString scriptInfoSection, styleSection, eventSection;
@@ -253,6 +261,16 @@ protected:
     void setup();
     void registerSubtitle(int id, GenTime startTime, bool temporary = false);
     void deregisterSubtitle(int id, bool temporary = false);
+    /** @brief Change the registered start position of a subtitle */
+    void updateSubtitleStart(int id, GenTime newStart);
+    /** @brief Make sure the duration bound covers a subtitle */
+    void updateMaxDuration(GenTime start, GenTime end);
+    /** @brief Insert a list of subtitles with a single model reset, subtitles colliding with an existing start position are skipped */
+    void insertSubtitles(const std::vector<std::pair<int, SubtitledTime>> &subtitles);
+    /** @brief Remove a list of subtitles with a single model reset */
+    void removeSubtitles(const std::vector<int> &ids);
+    /** @brief Returns an iterator on the first subtitle that can overlap a range starting at @param startTime */
+    std::map<GenTime, std::pair<QString, GenTime>>::const_iterator firstOverlapCandidate(GenTime startTime) const;
     /** @brief Returns the index for a subtitle's id (it's position in the list
      */
     int positionForIndex(int id) const;
@@ -31,6 +31,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "projectitemmodel.h"
 #include "projectsubclip.h"
 #include "timeline2/model/snapmodel.hpp"
+#include "utils/cachemanager.hpp"
 #include "utils/thumbnailcache.hpp"
 #include "utils/timecode.h"
 #include "xml/xml.hpp"
@@ -129,8 +130,12 @@ ProjectClip::ProjectClip(const QString &id, const QIcon &thumb, const std::share
     if (hasLimitedDuration()) {
         connect(&m_boundaryTimer, &QTimer::timeout, this, &ProjectClip::refreshBounds);
     }
-    connect(m_markerModel.get(), &MarkerListModel::modelChanged, this,
-            [&]() { setProducerProperty(QStringLiteral("kdenlive:markers"), m_markerModel->toJson()); });
+    connect(m_markerModel.get(), &MarkerListModel::modelChanged, this, [&]() {
+        setProducerProperty(QStringLiteral("kdenlive:markers"), m_markerModel->toJson());
+        if (auto ptr = m_model.lock()) {
+            std::static_pointer_cast<ProjectItemModel>(ptr)->updateSearchData(std::static_pointer_cast<ProjectClip>(shared_from_this()));
+        }
+    });
     QString markers = getProducerProperty(QStringLiteral("kdenlive:markers"));
     if (!markers.isEmpty()) {
         QMetaObject::invokeMethod(m_markerModel.get(), "importFromJson", Qt::QueuedConnection, Q_ARG(QString, markers), Q_ARG(bool, true), Q_ARG(bool, false));
@@ -196,6 +201,8 @@ ProjectClip::ProjectClip(const QString &id, const QDomElement &description, cons
     const QString proxy = getXmlProperty(description, QStringLiteral("kdenlive:proxy"));
     if (proxy.length() > 3) {
         m_temporaryUrl = getXmlProperty(description, QStringLiteral("kdenlive:originalurl"));
+        // The proxy is used by the open project, keep it in the cache
+        CacheManager::get()->recordAccess(proxy);
     }
     if (m_temporaryUrl.isEmpty()) {
         m_temporaryUrl = getXmlProperty(description, QStringLiteral("resource"));
@@ -213,8 +220,12 @@ ProjectClip::ProjectClip(const QString &id, const QDomElement &description, cons
     m_date = QFileInfo(m_temporaryUrl).lastModified();
     m_boundaryTimer.setSingleShot(true);
     m_boundaryTimer.setInterval(500);
-    connect(m_markerModel.get(), &MarkerListModel::modelChanged, this,
-            [&]() { setProducerProperty(QStringLiteral("kdenlive:markers"), m_markerModel->toJson()); });
+    connect(m_markerModel.get(), &MarkerListModel::modelChanged, this, [&]() {
+        setProducerProperty(QStringLiteral("kdenlive:markers"), m_markerModel->toJson());
+        if (auto ptr = m_model.lock()) {
+            std::static_pointer_cast<ProjectItemModel>(ptr)->updateSearchData(std::static_pointer_cast<ProjectClip>(shared_from_this()));
+        }
+    });
 }
 
 std::shared_ptr<ProjectClip> ProjectClip::construct(const QString &id, const QDomElement &description, const QIcon &thumb,
@@ -9,7 +9,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "projectitemmodel.h"
 #include "abstractprojectitem.h"
+#include "bin/model/markerlistmodel.hpp"
 #include "binplaylist.hpp"
+#include "binsearchindex.hpp"
 #include "core.h"
 #include "cropcalculator.h"
 #include "doc/kdenlivedoc.h"
@@ -49,6 +51,7 @@ ProjectItemModel::ProjectItemModel(QObject *parent)
     , m_lock(QReadWriteLock::Recursive)
     , m_binPlaylist(nullptr)
     , m_fileWatcher(new FileWatcher())
+    , m_searchIndex(std::make_shared<BinSearchIndex>())
     , m_nextId(1)
     , m_blankThumb()
     , m_dragType(PlaylistState::Disabled)
@@ -201,6 +204,7 @@ bool ProjectItemModel::setData(const QModelIndex &index, const QVariant &value,
     QWriteLocker locker(&m_lock);
     std::shared_ptr<AbstractProjectItem> item = getBinItemByIndex(index);
     if (item->rename(value.toString(), index.column())) {
+        updateSearchData(item);
         Q_EMIT dataChanged(index, index, {role});
         return true;
     }
@@ -445,6 +449,9 @@ QMimeData *ProjectItemModel::mimeData(const QModelIndexList &indices) const
 
 void ProjectItemModel::onItemUpdated(const std::shared_ptr<AbstractProjectItem> &item, const QVector<int> &roles)
 {
+    if (item->isInModel()) {
+        updateSearchData(item);
+    }
     int minColumn = -1;
     int maxColumn = -1;
     for (auto &r : roles) {
@@ -718,6 +725,13 @@ bool ProjectItemModel::requestBinClipDeletion(const std::shared_ptr<AbstractProj
         parentBinId = ptr->clipId();
     }
     bool isSubClip = clip->itemType() == AbstractProjectItem::SubClipItem;
+    if (clip->itemType() == AbstractProjectItem::ClipItem) {
+        // The undo keeps the clip and its producer alive
+        std::shared_ptr<Mlt::Producer> producer = std::static_pointer_cast<ProjectClip>(clip)->originalProducer();
+        if (producer) {
+            UndoMemory::account(UndoMemory::serviceCost(*producer.get()));
+        }
+    }
     if (!clip->selfSoftDelete(undo, redo)) {
         return false;
     }
@@ -759,6 +773,7 @@ void ProjectItemModel::registerItem(const std::shared_ptr<TreeItem> &item)
     Q_ASSERT(m_binPlaylist != nullptr);
     m_binPlaylist->manageBinItemInsertion(clip);
     m_allIds.append(clip->clipId().toInt());
+    updateSearchData(clip);
     if (clip->itemType() == AbstractProjectItem::ClipItem) {
         auto clipItem = std::static_pointer_cast<ProjectClip>(clip);
         m_allClipItems[clip->clipId().toInt()] = clipItem;
@@ -778,6 +793,7 @@ void ProjectItemModel::deregisterItem(int id, TreeItem *item)
     m_allIds.removeAll(clip->clipId().toInt());
     m_allClipItems.erase(clip->clipId().toInt());
     m_binPlaylist->manageBinItemDeletion(clip);
+    m_searchIndex->removeItem(id);
     // TODO : here, we should suspend jobs belonging to the item we delete. They can be restarted if the item is reinserted by undo
     AbstractTreeModel::deregisterItem(id, item);
     if (clip->itemType() == AbstractProjectItem::ClipItem) {
@@ -792,6 +808,31 @@ void ProjectItemModel::deregisterItem(int id, TreeItem *item)
     }
 }
 
+std::shared_ptr<BinSearchIndex> ProjectItemModel::searchIndex() const
+{
+    return m_searchIndex;
+}
+
+void ProjectItemModel::updateSearchData(const std::shared_ptr<AbstractProjectItem> &item)
+{
+    auto parent = item->parentItem().lock();
+    if (!parent) {
+        return;
+    }
+    // Fields are separated by a line break so that a search string cannot match across them
+    QStringList fields = {item->name(), item->getData(AbstractProjectItem::DataDate).toString(), item->description(), item->tags()};
+    if (item->itemType() == AbstractProjectItem::ClipItem) {
+        auto clip = std::static_pointer_cast<ProjectClip>(item);
+        if (auto markers = clip->getMarkerModel()) {
+            const QList<CommentedTime> allMarkers = markers->getAllMarkers();
+            for (const CommentedTime &marker : allMarkers) {
+                fields << marker.comment();
+            }
+        }
+    }
+    m_searchIndex->setItem(item->getId(), parent->getId(), fields.join(QLatin1Char('\n')));
+}
+
 bool ProjectItemModel::hasSequenceId(const QUuid &uuid) const
 {
     return m_binPlaylist->hasSequenceId(uuid);
@@ -882,6 +923,8 @@ bool ProjectItemModel::requestAddBinClip(QString &id, const QDomElement &descrip
     }
     Q_ASSERT(isIdFree(id));
     QWriteLocker locker(&m_lock);
+    // The redo keeps the clip built from this description alive
+    UndoMemory::account(UndoMemory::xmlCost(description));
     std::shared_ptr<ProjectClip> new_clip =
         ProjectClip::construct(id, description, m_blankThumb, std::static_pointer_cast<ProjectItemModel>(shared_from_this()));
     locker.unlock();
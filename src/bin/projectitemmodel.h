@@ -22,6 +22,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QUuid>
 
 class BinPlaylist;
+class BinSearchIndex;
 class FileWatcher;
 class MarkerListModel;
 class ProjectClip;
@@ -256,6 +257,10 @@ public:
     /** @brief Check that all sequences are correctly stored in the model */
     void checkSequenceIntegrity(const QString activeSequenceId);
     std::shared_ptr<EffectStackModel> getClipEffectStack(int itemId);
+    /** @brief Returns the index used to filter the bin items by text */
+    std::shared_ptr<BinSearchIndex> searchIndex() const;
+    /** @brief Refresh the searchable text of an item (name, date, description, tags and markers) */
+    void updateSearchData(const std::shared_ptr<AbstractProjectItem> &item);
 
 protected:
     bool closing;
@@ -300,6 +305,7 @@ private:
     std::unique_ptr<BinPlaylist> m_binPlaylist;
 
     std::unique_ptr<FileWatcher> m_fileWatcher;
+    std::shared_ptr<BinSearchIndex> m_searchIndex;
     std::unordered_map<QString, std::shared_ptr<Mlt::Tractor>> m_extraPlaylists;
     std::shared_ptr<Mlt::Tractor> m_projectTractor;
     std::map<int, std::shared_ptr<ProjectClip>> m_allClipItems;
@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "abstractprojectitem.h"
 
 #include <QItemSelectionModel>
+#include <QtConcurrent>
 
 ProjectSortProxyModel::ProjectSortProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent)
@@ -19,11 +20,44 @@ ProjectSortProxyModel::ProjectSortProxyModel(QObject *parent)
     m_selection = new QItemSelectionModel(this);
     connect(m_selection, &QItemSelectionModel::selectionChanged, this, &ProjectSortProxyModel::onCurrentRowChanged);
     setDynamicSortFilter(true);
+    // Don't filter on every keystroke
+    m_searchTimer.setSingleShot(true);
+    m_searchTimer.setInterval(150);
+    connect(&m_searchTimer, &QTimer::timeout, this, &ProjectSortProxyModel::startSearch);
+    connect(&m_searchWatcher, &QFutureWatcher<BinSearchIndex::Result>::finished, this, &ProjectSortProxyModel::applySearchResult);
+}
+
+void ProjectSortProxyModel::setSearchIndex(std::shared_ptr<BinSearchIndex> index)
+{
+    m_searchIndex = std::move(index);
+    // The folders containing matches have to be recomputed when the bin changes
+    auto refresh = [this]() {
+        if (!m_searchString.isEmpty() && !m_searchTimer.isActive()) {
+            m_searchTimer.start();
+        }
+    };
+    connect(sourceModel(), &QAbstractItemModel::rowsInserted, this, refresh);
+    connect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, refresh);
+    connect(sourceModel(), &QAbstractItemModel::dataChanged, this, refresh);
+}
+
+bool ProjectSortProxyModel::hasPropertyFilters() const
+{
+    return m_usageFilter != UsageFilter::All || !m_searchRating.isEmpty() || !m_searchType.isEmpty() || !m_searchTag.isEmpty();
 }
 
 // Responsible for item sorting!
 bool ProjectSortProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
+    if (m_searchIndex && !hasPropertyFilters()) {
+        if (m_searchString.isEmpty()) {
+            return true;
+        }
+        // The search index already knows the matching items and their folders, no need to check the children
+        QModelIndex ix = sourceModel()->index(sourceRow, 0, sourceParent);
+        int id = int(ix.internalId());
+        return m_searchAncestors.contains(id) || m_searchIndex->matches(id, m_foldedSearch);
+    }
     if (filterAcceptsRowItself(sourceRow, sourceParent)) {
         return true;
     }
@@ -85,6 +119,10 @@ bool ProjectSortProxyModel::filterAcceptsRowItself(int sourceRow, const QModelIn
     if (result && m_searchString.isEmpty()) {
         return true;
     }
+    if (m_searchIndex) {
+        QModelIndex ix = sourceModel()->index(sourceRow, 0, sourceParent);
+        return ix.isValid() && (result || m_searchIndex->matches(int(ix.internalId()), m_foldedSearch));
+    }
     for (int i = 0; i < 3; i++) {
         QModelIndex index0 = sourceModel()->index(sourceRow, i, sourceParent);
         if (!index0.isValid()) {
@@ -171,8 +209,45 @@ QItemSelectionModel *ProjectSortProxyModel::selectionModel()
 
 void ProjectSortProxyModel::slotSetSearchString(const QString &str)
 {
-    m_searchString = str;
-    invalidateFilter();
+    m_pendingSearch = str;
+    if (str.isEmpty() || !m_searchIndex) {
+        // Clearing the search is immediate
+        m_searchTimer.stop();
+        startSearch();
+        return;
+    }
+    m_searchTimer.start();
+}
+
+void ProjectSortProxyModel::startSearch()
+{
+    if (m_pendingSearch.isEmpty() || !m_searchIndex) {
+        m_searchString = m_pendingSearch;
+        m_foldedSearch = BinSearchIndex::fold(m_pendingSearch);
+        m_searchAncestors.clear();
+        invalidateFilter();
+        return;
+    }
+    // Setting a new future discards the result of a query that is still running
+    std::shared_ptr<BinSearchIndex> index = m_searchIndex;
+    const QString needle = m_pendingSearch;
+    m_searchWatcher.setFuture(QtConcurrent::run([index, needle]() { return index->query(needle); }));
+}
+
+void ProjectSortProxyModel::applySearchResult()
+{
+    const BinSearchIndex::Result result = m_searchWatcher.result();
+    if (result.needle != BinSearchIndex::fold(m_pendingSearch)) {
+        // The search string was modified in the meantime
+        return;
+    }
+    bool changed = result.needle != m_foldedSearch || result.ancestors != m_searchAncestors;
+    m_searchString = m_pendingSearch;
+    m_foldedSearch = result.needle;
+    m_searchAncestors = result.ancestors;
+    if (changed) {
+        invalidateFilter();
+    }
 }
 
 void ProjectSortProxyModel::slotSetFilters(const QStringList &tagFilters, const QList<int> rateFilters, const QList<int> typeFilters, UsageFilter unusedFilter)
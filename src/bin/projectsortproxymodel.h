@@ -7,8 +7,13 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #pragma once
 
+#include "binsearchindex.hpp"
+
 #include <QCollator>
+#include <QFutureWatcher>
 #include <QSortFilterProxyModel>
+#include <QTimer>
+#include <memory>
 
 class QItemSelectionModel;
 
@@ -25,6 +30,8 @@ public:
 
     explicit ProjectSortProxyModel(QObject *parent = nullptr);
     QItemSelectionModel *selectionModel();
+    /** @brief Use the project's search index to filter by text. Must be called after setting the source model */
+    void setSearchIndex(std::shared_ptr<BinSearchIndex> index);
 
 public Q_SLOTS:
     /** @brief Set search string that will filter the view */
@@ -41,6 +48,10 @@ public Q_SLOTS:
 private Q_SLOTS:
     /** @brief Called when a row change is detected by selection model */
     void onCurrentRowChanged(const QItemSelection &current, const QItemSelection &previous);
+    /** @brief Query the search index for the last search string in a worker thread */
+    void startSearch();
+    /** @brief The search index query finished, update the filter */
+    void applySearchResult();
 
 protected:
     /** @brief Decide which items should be displayed depending on the search string  */
@@ -50,10 +61,20 @@ protected:
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
     bool filterAcceptsRowItself(int source_row, const QModelIndex &source_parent) const;
     bool hasAcceptedChildren(int source_row, const QModelIndex &source_parent) const;
+    /** @brief Returns true if a tag, rating, type or usage filter is active */
+    bool hasPropertyFilters() const;
 
 private:
     QItemSelectionModel *m_selection;
     QString m_searchString;
+    /** @brief The search string as typed by the user, applied once the search index was queried */
+    QString m_pendingSearch;
+    QString m_foldedSearch;
+    std::shared_ptr<BinSearchIndex> m_searchIndex;
+    /** @brief Folders containing items that match the search string */
+    QSet<int> m_searchAncestors;
+    QTimer m_searchTimer;
+    QFutureWatcher<BinSearchIndex::Result> m_searchWatcher;
     QStringList m_searchTag;
     QList<int> m_searchType;
     QList<int> m_searchRating;
@@ -30,6 +30,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "timeline2/model/timelineitemmodel.hpp"
 #include "timeline2/view/timelinecontroller.h"
 #include "timeline2/view/timelinewidget.h"
+#include "utils/cachemanager.hpp"
+#include "utils/startupprofiler.hpp"
+#include "utils/tracing.hpp"
 #include <mlt++/MltRepository.h>
 
 #include <KIO/OpenFileManagerWindowJob>
@@ -41,6 +44,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QImageReader>
 #include <QInputDialog>
 #include <QQuickStyle>
+#include <QtConcurrent>
 #include <locale>
 #ifdef Q_OS_MAC
 #include <xlocale.h>
@@ -73,6 +77,7 @@ void Core::finishShutdown()
         delete m_projectManager;
     }
     ClipController::mediaUnavailable.reset();
+    CacheManager::get()->save();
 }
 
 Core::~Core() {}
@@ -82,6 +87,9 @@ bool Core::build(LinuxPackageType packageType, bool testMode)
     if (m_self) {
         return true;
     }
+    Tracing::init();
+    StartupProfiler::start();
+    StartupPhase buildPhase(QStringLiteral("core"));
     m_self.reset(new Core(packageType));
     m_self->initLocale();
 
@@ -150,6 +158,7 @@ void Core::initHeadless(const QUrl &url)
 
 void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clipsToLoad)
 {
+    std::unique_ptr<StartupPhase> phase = std::make_unique<StartupPhase>(QStringLiteral("mainwindow"));
     m_mainWindow = new MainWindow();
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 
@@ -164,6 +173,7 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
 
     connect(this, &Core::showConfigDialog, m_mainWindow, &MainWindow::slotShowPreferencePage);
 
+    phase = std::make_unique<StartupPhase>(QStringLiteral("bins"));
     Bin *bin = new Bin(m_projectItemModel, m_mainWindow);
     connect(bin, &Bin::requestShowClipProperties, bin, &Bin::showClipProperties);
     m_mainWindow->addBin(bin, QString(), false);
@@ -183,10 +193,12 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
     connect(m_projectItemModel.get(), &ProjectItemModel::addTag, m_mainWindow->activeBin(), &Bin::slotTagDropped);
     connect(m_projectItemModel.get(), &QAbstractItemModel::dataChanged, m_mainWindow->activeBin(), &Bin::slotItemEdited);
 
+    phase = std::make_unique<StartupPhase>(QStringLiteral("monitors"));
     m_monitorManager = new MonitorManager(this);
     projectManager()->init(Url, clipsToLoad);
 
     // The MLT Factory will be initiated there, all MLT classes will be usable only after this
+    phase = std::make_unique<StartupPhase>(QStringLiteral("mainwindow.init"));
     bool inSandbox = m_packageType == LinuxPackageType::AppImage || m_packageType == LinuxPackageType::Flatpak || m_packageType == LinuxPackageType::Snap;
     if (inSandbox) {
         // In a sandbox environment we need to search some paths recursively
@@ -200,9 +212,9 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
         // Open connection with Mlt
         m_mainWindow->init(MltPath);
     }
+    phase = std::make_unique<StartupPhase>(QStringLiteral("profile"));
     m_projectItemModel->buildPlaylist(QUuid());
-    // load the profiles from disk
-    ProfileRepository::get()->refresh();
+    // The profiles were loaded from disk when the MLT connection was initialized
     // load default profile
     m_profile = KdenliveSettings::default_profile();
     // load default profile and ask user to select one if not found.
@@ -251,6 +263,7 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
     ClipController::mediaUnavailable = std::make_shared<Mlt::Producer>(ProfileRepository::get()->getProfile(m_self->m_profile)->profile(), "color:blue");
     ClipController::mediaUnavailable->set("length", 99999999);
 
+    phase = std::make_unique<StartupPhase>(QStringLiteral("show"));
     if (qApp->isSessionRestored()) {
         // NOTE: we are restoring only one window, because Kdenlive only uses one MainWindow
         m_mainWindow->restore(1, false);
@@ -259,6 +272,8 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
     // bin->slotUpdatePalette();
     Q_EMIT m_mainWindow->GUISetupDone();
     m_guiConstructed = true;
+    phase.reset();
+    StartupProfiler::report();
     if (!Url.isEmpty()) {
         Q_EMIT loadingMessageNewStage(i18n("Loading project…"));
     }
@@ -309,13 +324,23 @@ void Core::buildDocks()
 
 void Core::buildLumaThumbs(const QStringList &values)
 {
+    QStringList missing;
     for (auto &entry : values) {
-        if (MainWindow::m_lumacache.contains(entry)) {
-            continue;
+        if (!MainWindow::m_lumacache.contains(entry) && (entry.endsWith(QLatin1String(".png")) || entry.endsWith(QLatin1String(".pgm")))) {
+            missing << entry;
         }
-        QImage pix(entry);
-        if (!pix.isNull()) {
-            MainWindow::m_lumacache.insert(entry, pix.scaled(50, 30, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    }
+    if (missing.isEmpty()) {
+        return;
+    }
+    // Decode the luma images in parallel, the cache itself is only modified from the main thread
+    const QList<QImage> thumbs = QtConcurrent::blockingMapped<QList<QImage>>(missing, [](const QString &path) {
+        QImage pix(path);
+        return pix.isNull() ? pix : pix.scaled(50, 30, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    });
+    for (int i = 0; i < missing.count(); ++i) {
+        if (!thumbs.at(i).isNull()) {
+            MainWindow::m_lumacache.insert(missing.at(i), thumbs.at(i));
         }
     }
 }
@@ -1196,6 +1221,7 @@ void Core::addActionToCollection(const QString &name, QAction *action)
 void Core::clean()
 {
     m_self.reset();
+    Tracing::flush();
 }
 
 void Core::startMediaCapture(const QUuid &uuid, int tid, bool checkAudio, bool checkVideo)
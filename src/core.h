@@ -393,7 +393,7 @@ public Q_SLOTS:
     void displayBinMessage(const QString &text, int type, const QList<QAction *> &actions = QList<QAction *>(), bool showClose = false,
                            BinMessage::BinCategory messageCategory = BinMessage::BinCategory::NoMessage);
     void displayBinLogMessage(const QString &text, int type, const QString logInfo);
-    /** @brief Create small thumbnails for luma used in compositions */
+    /** @brief Create the missing small thumbnails for lumas used in compositions, in parallel. Must be called from the main thread */
     void buildLumaThumbs(const QStringList &values);
     /** @brief Try to find a display name for the given filename.
      *  This is especially helpful for mlt's dynamically created luma files without thumb (luma01.pgm, luma02.pgm,...),
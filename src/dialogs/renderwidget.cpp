@@ -44,6 +44,7 @@
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QJsonArray>
+#include <QJsonDocument>
 #include <QJsonObject>
 #include <QKeyEvent>
 #include <QMenu>
@@ -61,6 +62,8 @@
 #include <Purpose/AlternativesModel>
 #include <Purpose/Menu>
 
+#include <algorithm>
+#include <climits>
 #include <locale>
 #ifdef Q_OS_MAC
 #include <xlocale.h>
@@ -77,7 +80,11 @@ enum {
     LastTimeRole,
     LastFrameRole,
     OpenBrowserRole,
-    PlayAfterRole
+    PlayAfterRole,
+    PriorityRole,
+    ThreadsRole,
+    MemoryRole,
+    TelemetryRole
 };
 
 // Running job status
@@ -768,6 +775,7 @@ RenderJobItem *RenderWidget::createRenderJob(const RenderRequest::RenderJob &job
     QStringList argsJob = RenderRequest::argsByJob(job);
 
     renderItem->setData(1, ParametersRole, argsJob);
+    setJobCost(renderItem);
     qDebug() << "* CREATED JOB WITH ARGS: " << argsJob;
     renderItem->setData(1, OpenBrowserRole, m_view.open_browser->isChecked());
     renderItem->setData(1, PlayAfterRole, m_view.play_after->isChecked());
@@ -781,6 +789,33 @@ RenderJobItem *RenderWidget::createRenderJob(const RenderRequest::RenderJob &job
     return renderItem;
 }
 
+void RenderWidget::setJobCost(RenderJobItem *item)
+{
+    // The playlist is the third argument of a delivery job
+    const QStringList jobData = item->data(1, ParametersRole).toStringList();
+    RenderRequest::RenderCost cost = RenderRequest::estimateCost(jobData.value(2));
+    item->setData(1, ThreadsRole, cost.threads);
+    item->setData(1, MemoryRole, cost.memory);
+}
+
+RenderJobItem *RenderWidget::firstPassJob(RenderJobItem *item) const
+{
+    const QStringList jobData = item->data(1, ParametersRole).toStringList();
+    if (jobData.size() < 3 || !jobData.at(2).endsWith(QStringLiteral("-pass2.mlt"))) {
+        return nullptr;
+    }
+    const QString firstPassName = jobData.at(2).section(QLatin1Char('-'), 0, -2) + QStringLiteral(".mlt");
+    auto *above = static_cast<RenderJobItem *>(m_view.running_jobs->itemAbove(item));
+    while (above) {
+        QStringList aboveData = above->data(1, ParametersRole).toStringList();
+        if (aboveData.size() > 2 && aboveData.at(2) == firstPassName) {
+            return above;
+        }
+        above = static_cast<RenderJobItem *>(m_view.running_jobs->itemAbove(above));
+    }
+    return nullptr;
+}
+
 void RenderWidget::checkRenderStatus()
 {
     // check if we have a job waiting to render
@@ -788,46 +823,74 @@ void RenderWidget::checkRenderStatus()
         return;
     }
 
-    // Make sure no other rendering is running
-    if (runningJobsCount() > 0) {
+    // Collect the resources used by the running jobs and the waiting jobs
+    int runningJobs = 0;
+    int usedThreads = 0;
+    int usedMemory = 0;
+    QList<RenderJobItem *> waitingJobs;
+    auto *item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
+    while (item != nullptr) {
+        if (item->status() == RUNNINGJOB || item->status() == STARTINGJOB) {
+            runningJobs++;
+            usedThreads += item->data(1, ThreadsRole).toInt();
+            usedMemory += item->data(1, MemoryRole).toInt();
+        } else if (item->status() == WAITINGJOB) {
+            waitingJobs << item;
+        }
+        item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
+    }
+    if (waitingJobs.isEmpty()) {
+        if (runningJobs == 0 && m_view.shutdown->isChecked()) {
+            Q_EMIT shutdown();
+        }
         return;
     }
 
-    auto *item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
-
-    bool waitingJob = false;
+    // Highest priority first, then in queue order
+    std::stable_sort(waitingJobs.begin(), waitingJobs.end(), [](RenderJobItem *a, RenderJobItem *b) {
+        return a->data(1, PriorityRole).toInt() > b->data(1, PriorityRole).toInt();
+    });
+    const int maxJobs = qMax(1, KdenliveSettings::renderconcurrentjobs());
+    const int threadBudget = KdenliveSettings::renderthreadbudget() > 0 ? KdenliveSettings::renderthreadbudget() : QThread::idealThreadCount();
+    int memoryLeft = INT_MAX;
+    if (KdenliveSettings::rendermemorybudget() > 0) {
+        memoryLeft = KdenliveSettings::rendermemorybudget() - usedMemory;
+    } else {
+        // The running jobs already use their share of the system memory
+        KMemoryInfo memInfo;
+        if (!memInfo.isNull()) {
+            memoryLeft = int(memInfo.availablePhysical() / 1024 / 1024) - LOW_MEMORY_THRESHOLD;
+        }
+    }
 
-    // Find first waiting job
-    while (item != nullptr) {
-        if (item->status() == WAITINGJOB) {
-            QDateTime t = QDateTime::currentDateTime();
-            item->setData(1, StartTimeRole, t);
-            item->setData(1, LastTimeRole, t);
-            waitingJob = true;
-            startRendering(item);
-            // Check for 2 pass encoding
-            QStringList jobData = item->data(1, ParametersRole).toStringList();
-            if (jobData.size() > 2 && jobData.at(1).endsWith(QStringLiteral("-pass2.mlt"))) {
-                // Find and remove 1st pass job
-                QTreeWidgetItem *above = m_view.running_jobs->itemAbove(item);
-                QString firstPassName = jobData.at(1).section(QLatin1Char('-'), 0, -2) + QStringLiteral(".mlt");
-                while (above) {
-                    QStringList aboveData = above->data(1, ParametersRole).toStringList();
-                    qDebug() << "// GOT  JOB: " << aboveData.at(1);
-                    if (aboveData.size() > 2 && aboveData.at(1) == firstPassName) {
-                        delete above;
-                        break;
-                    }
-                    above = m_view.running_jobs->itemAbove(above);
-                }
-            }
-            item->setStatus(STARTINGJOB);
+    for (RenderJobItem *job : qAsConst(waitingJobs)) {
+        if (runningJobs >= maxJobs) {
             break;
         }
-        item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
-    }
-    if (!waitingJob && m_view.shutdown->isChecked()) {
-        Q_EMIT shutdown();
+        RenderJobItem *firstPass = firstPassJob(job);
+        if (firstPass && firstPass->status() <= RUNNINGJOB) {
+            // The second pass needs the log of the first one
+            continue;
+        }
+        const int threads = job->data(1, ThreadsRole).toInt();
+        const int memory = job->data(1, MemoryRole).toInt();
+        // A job always starts when nothing else is running. Otherwise stop at the first job that does not fit in the budget,
+        // so that smaller jobs further in the queue cannot delay it forever
+        if (runningJobs > 0 && (usedThreads + threads > threadBudget || memory > memoryLeft)) {
+            break;
+        }
+        QDateTime t = QDateTime::currentDateTime();
+        job->setData(1, StartTimeRole, t);
+        job->setData(1, LastTimeRole, t);
+        startRendering(job);
+        if (firstPass) {
+            // Remove the finished 1st pass job
+            delete firstPass;
+        }
+        job->setStatus(STARTINGJOB);
+        runningJobs++;
+        usedThreads += threads;
+        memoryLeft -= memory;
     }
 }
 
@@ -1216,7 +1279,8 @@ void RenderWidget::setRenderProgress(const QString &dest, int progress, int fram
     if (progress == 0) {
         item->setIcon(0, QIcon::fromTheme(QStringLiteral("media-record")));
         slotCheckJob();
-    } else {
+    } else if (!item->data(1, TelemetryRole).isValid()) {
+        // Renderers sending telemetry get a more detailed status in setRenderTelemetry
         QDateTime startTime = item->data(1, StartTimeRole).toDateTime();
         qint64 elapsedTime = startTime.secsTo(QDateTime::currentDateTime());
         int dt = elapsedTime - item->data(1, LastTimeRole).toInt();
@@ -1255,6 +1319,54 @@ void RenderWidget::setRenderProgress(const QString &dest, int progress, int fram
     }
 }
 
+void RenderWidget::setRenderTelemetry(const QString &dest, const QJsonObject &telemetry)
+{
+    QList<QTreeWidgetItem *> existing = m_view.running_jobs->findItems(dest, Qt::MatchExactly, 1);
+    if (existing.isEmpty()) {
+        return;
+    }
+    auto *item = static_cast<RenderJobItem *>(existing.at(0));
+    item->setData(1, TelemetryRole, telemetry.toVariantMap());
+    if (item->status() != RUNNINGJOB) {
+        return;
+    }
+    QStringList details;
+    details << i18n("frame %1 @ %2 fps", telemetry.value(QLatin1String("frame")).toInt(),
+                    QString::number(telemetry.value(QLatin1String("fps")).toDouble(), 'f', 1));
+    if (telemetry.contains(QLatin1String("bitrate"))) {
+        details << i18n("%1 kb/s", qRound(telemetry.value(QLatin1String("bitrate")).toDouble()));
+    }
+    if (telemetry.contains(QLatin1String("cpu"))) {
+        // A low processor usage means the render waits on decoding or disk access
+        details << i18n("CPU %1", QString::number(telemetry.value(QLatin1String("cpu")).toDouble(), 'f', 1));
+    }
+    QString status;
+    const int pass = telemetry.value(QLatin1String("pass")).toInt();
+    if (pass > 0) {
+        status = i18n("Pass %1: ", pass);
+    }
+    if (telemetry.contains(QLatin1String("eta"))) {
+        qint64 remaining = qint64(telemetry.value(QLatin1String("eta")).toDouble());
+        int days = int(remaining / 86400);
+        QTime when = QTime(0, 0, 0, 0).addSecs(int(remaining % 86400));
+        status.append(i18n("Remaining time "));
+        if (days > 0) {
+            status.append(i18np("%1 day ", "%1 days ", days));
+        }
+        status.append(when.toString(QStringLiteral("hh:mm:ss")));
+    }
+    status.append(QStringLiteral(" (%1)").arg(details.join(QStringLiteral(", "))));
+    item->setData(1, Qt::UserRole, status);
+
+    // Durations of the finished stages
+    QStringList stages;
+    const QJsonObject stageTimes = telemetry.value(QLatin1String("stageTimes")).toObject();
+    for (auto it = stageTimes.constBegin(); it != stageTimes.constEnd(); ++it) {
+        stages << i18n("%1: %2 s", it.key(), QString::number(it.value().toDouble(), 'f', 1));
+    }
+    item->setToolTip(1, stages.join(QLatin1Char('\n')));
+}
+
 void RenderWidget::setRenderStatus(const QString &dest, int status, const QString &error)
 {
     RenderJobItem *item = nullptr;
@@ -1279,6 +1391,13 @@ void RenderWidget::setRenderStatus(const QString &dest, int status, const QStrin
         QString est = (days > 0) ? i18np("%1 day ", "%1 days ", days) : QString();
         est.append(when.toString(QStringLiteral("hh:mm:ss")));
         QString t = i18n("Rendering finished in %1", est);
+        const QJsonObject telemetry = QJsonObject::fromVariantMap(item->data(1, TelemetryRole).toMap());
+        if (!telemetry.isEmpty()) {
+            if (telemetry.contains(QLatin1String("averageFps"))) {
+                t.append(i18n(" (%1 fps)", QString::number(telemetry.value(QLatin1String("averageFps")).toDouble(), 'f', 1)));
+            }
+            qCDebug(KDENLIVE_LOG) << "Render telemetry of" << dest << QJsonDocument(telemetry).toJson(QJsonDocument::Compact);
+        }
         item->setData(1, Qt::UserRole, t);
 
         m_shareMenu->model()->setInputData(QJsonObject{{QStringLiteral("mimeType"), QMimeDatabase().mimeTypeForFile(item->text(1)).name()},
@@ -1491,6 +1610,7 @@ void RenderWidget::slotStartScript()
         QStringList argsJob = {QStringLiteral("delivery"), KdenliveSettings::meltpath(), path, QStringLiteral("--pid"),
                                QString::number(QCoreApplication::applicationPid())};
         renderItem->setData(1, ParametersRole, argsJob);
+        setJobCost(renderItem);
         checkRenderStatus();
         m_view.tabWidget->setCurrentIndex(Tabs::JobsTab);
     }
@@ -1852,6 +1972,16 @@ void RenderWidget::prepareJobContextMenu(const QPoint &pos)
     if (!renderItem) {
         return;
     }
+    if (renderItem->status() == WAITINGJOB) {
+        QMenu menu(this);
+        const int priority = renderItem->data(1, PriorityRole).toInt();
+        QAction *raise = menu.addAction(QIcon::fromTheme(QStringLiteral("go-up")), i18n("Raise Priority"));
+        connect(raise, &QAction::triggered, this, [this, renderItem, priority]() { setJobPriority(renderItem, priority + 1); });
+        QAction *lower = menu.addAction(QIcon::fromTheme(QStringLiteral("go-down")), i18n("Lower Priority"));
+        connect(lower, &QAction::triggered, this, [this, renderItem, priority]() { setJobPriority(renderItem, priority - 1); });
+        menu.exec(m_view.running_jobs->mapToGlobal(pos));
+        return;
+    }
     if (renderItem->status() != FINISHEDJOB) {
         return;
     }
@@ -1866,6 +1996,19 @@ void RenderWidget::prepareJobContextMenu(const QPoint &pos)
     menu.exec(m_view.running_jobs->mapToGlobal(pos));
 }
 
+void RenderWidget::setJobPriority(RenderJobItem *item, int priority)
+{
+    if (item->status() != WAITINGJOB) {
+        return;
+    }
+    item->setData(1, PriorityRole, priority);
+    if (priority == 0) {
+        item->setData(1, Qt::UserRole, i18n("Waiting…"));
+    } else {
+        item->setData(1, Qt::UserRole, i18n("Waiting… (priority %1)", priority));
+    }
+}
+
 void RenderWidget::resetRenderPath(const QString &path)
 {
     QString extension;
@@ -23,6 +23,7 @@ class Menu;
 #include <KNSWidgets/Button>
 
 class QDomElement;
+class QJsonObject;
 class QKeyEvent;
 
 // RenderViewDelegate is used to draw the progress bars.
@@ -114,6 +115,8 @@ public:
     void setGuides(std::weak_ptr<MarkerListModel> guidesModel);
     void focusItem(const QString &profile = QString());
     void setRenderProgress(const QString &dest, int progress = 0, int frame = 0);
+    /** @brief Display the detailed state sent by a render job: speed, bitrate, processor usage and stage durations. */
+    void setRenderTelemetry(const QString &dest, const QJsonObject &telemetry);
     void setRenderStatus(const QString &dest, int status, const QString &error);
     void setRenderProfile(const QMap<QString, QString> &props);
     void saveRenderProfile();
@@ -220,9 +223,15 @@ private:
     Purpose::Menu *m_shareMenu;
     void parseProfiles(const QString &selectedProfile = QString());
     QUrl filenameWithExtension(QUrl url, const QString &extension);
-    /** @brief Check if a job needs to be started. */
+    /** @brief Start the waiting jobs, by priority, while they fit in the concurrent jobs and resources budget. */
     void checkRenderStatus();
     void startRendering(RenderJobItem *item);
+    /** @brief Store the estimated resources used by a job, from its playlist. */
+    void setJobCost(RenderJobItem *item);
+    /** @brief Returns the first pass job of a second pass job, or nullptr. */
+    RenderJobItem *firstPassJob(RenderJobItem *item) const;
+    /** @brief Waiting jobs with a higher priority start first. */
+    void setJobPriority(RenderJobItem *item, int priority);
     /** @brief Create a rendering profile from MLT preset. */
     QTreeWidgetItem *loadFromMltPreset(const QString &groupName, const QString &path, QString profileName, bool codecInName = false);
     RenderJobItem *createRenderJob(const RenderRequest::RenderJob &job);
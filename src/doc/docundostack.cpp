@@ -4,12 +4,28 @@
 */
 
 #include "docundostack.hpp"
+#include "kdenlive_debug.h"
+#include "kdenlivesettings.h"
+#include "undohelper.hpp"
+
+#include <KLocalizedString>
 #include <QUndoCommand>
 #include <QUndoGroup>
+#include <QVector>
+#include <algorithm>
 
 DocUndoStack::DocUndoStack(QUndoGroup *parent)
     : QUndoStack(parent)
+    , m_memoryBudget(qint64(KdenliveSettings::undomemorylimit()) * 1024 * 1024)
+    , m_memoryUsage(0)
+    , m_mergeInterval(KdenliveSettings::undomergeinterval())
 {
+    connect(this, &QUndoStack::indexChanged, this, [this](int ix) {
+        if (ix > 0 && command(ix - 1)->isObsolete()) {
+            // Everything above the compacted steps was undone, they can be removed
+            QMetaObject::invokeMethod(this, &DocUndoStack::dropCompacted, Qt::QueuedConnection);
+        }
+    });
 }
 
 // TODO: custom undostack everywhere do that
@@ -18,5 +34,119 @@ void DocUndoStack::push(QUndoCommand *cmd)
     if (index() < count()) {
         Q_EMIT invalidate(index());
     }
+    if (auto *functional = dynamic_cast<FunctionalUndoCommand *>(cmd)) {
+        functional->setMergeInterval(m_mergeInterval);
+    }
     QUndoStack::push(cmd);
+    enforceBudget();
+}
+
+void DocUndoStack::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = bytes;
+    enforceBudget();
+}
+
+qint64 DocUndoStack::memoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+void DocUndoStack::setMergeInterval(int interval)
+{
+    m_mergeInterval = interval;
+}
+
+qint64 DocUndoStack::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+int DocUndoStack::compactedCount() const
+{
+    int compacted = 0;
+    while (compacted < count() && command(compacted)->isObsolete()) {
+        compacted++;
+    }
+    return compacted;
+}
+
+qint64 DocUndoStack::commandCost(const QUndoCommand *cmd)
+{
+    qint64 cost = 0;
+    if (auto *functional = dynamic_cast<const FunctionalUndoCommand *>(cmd)) {
+        cost = functional->cost();
+    } else {
+        cost = qint64(sizeof(QUndoCommand)) + cmd->text().size() * qint64(sizeof(QChar));
+    }
+    for (int i = 0; i < cmd->childCount(); i++) {
+        cost += commandCost(cmd->child(i));
+    }
+    return cost;
+}
+
+void DocUndoStack::enforceBudget()
+{
+    const int max = count();
+    QVector<qint64> costs(max);
+    qint64 total = 0;
+    for (int i = 0; i < max; i++) {
+        costs[i] = commandCost(command(i));
+        total += costs[i];
+    }
+    if (m_memoryBudget > 0 && total > m_memoryBudget) {
+        // Always keep the last undo step, and never touch the steps that can be redone
+        const int last = index() - 1;
+        int compacted = 0;
+        for (int i = 0; i < last && total > m_memoryBudget; i++) {
+            auto *cmd = const_cast<QUndoCommand *>(command(i));
+            if (cmd->isObsolete()) {
+                continue;
+            }
+            if (auto *functional = dynamic_cast<FunctionalUndoCommand *>(cmd)) {
+                functional->release();
+            } else {
+                cmd->setObsolete(true);
+            }
+            cmd->setText(i18nc("@info:undo step that cannot be undone anymore", "%1 (compacted)", cmd->text()));
+            total += commandCost(cmd) - costs[i];
+            compacted++;
+        }
+        if (compacted > 0) {
+            qCDebug(KDENLIVE_LOG) << "Undo history over budget, compacted" << compacted << "steps, estimated usage now" << total << "bytes";
+        }
+    }
+    if (total != m_memoryUsage) {
+        m_memoryUsage = total;
+        Q_EMIT memoryUsageChanged(m_memoryUsage);
+    }
+}
+
+void DocUndoStack::dropCompacted()
+{
+    // Undoing an obsolete command deletes it from the stack without running it
+    while (index() > 0 && command(index() - 1)->isObsolete()) {
+        undo();
+    }
+    enforceBudget();
+}
+
+QString DocUndoStack::memoryReport(int maxEntries) const
+{
+    // This is debug information, not translated
+    QVector<QPair<qint64, int>> costs;
+    costs.reserve(count());
+    for (int i = 0; i < count(); i++) {
+        costs.append({commandCost(command(i)), i});
+    }
+    std::sort(costs.begin(), costs.end(), [](const QPair<qint64, int> &a, const QPair<qint64, int> &b) { return a.first > b.first; });
+    QString report = QStringLiteral("Undo history: %1 steps (%2 compacted), %3 KiB estimated, budget %4 KiB\n")
+                         .arg(count())
+                         .arg(compactedCount())
+                         .arg(m_memoryUsage / 1024)
+                         .arg(m_memoryBudget / 1024);
+    for (int i = 0; i < qMin(maxEntries, costs.size()); i++) {
+        report.append(QStringLiteral("  #%1 %2: %3 KiB\n").arg(costs.at(i).second).arg(command(costs.at(i).second)->text()).arg(costs.at(i).first / 1024.0, 0, 'f', 1));
+    }
+    return report;
 }
@@ -10,12 +10,43 @@
 class QUndoGroup;
 class QUndoCommand;
 
+/** @class DocUndoStack
+    @brief The undo stack of a document.
+    On top of QUndoStack, it keeps an estimate of the memory held by the history. When it exceeds the budget (see
+    KdenliveSettings::undomemorylimit), the oldest steps are compacted: their operations are released and they can no longer be undone.
+    Successive moves of the same item are merged into one step (see KdenliveSettings::undomergeinterval).
+ */
 class DocUndoStack : public QUndoStack
 {
     Q_OBJECT
 public:
     explicit DocUndoStack(QUndoGroup *parent = Q_NULLPTR);
     void push(QUndoCommand *cmd);
+    /** @brief Set the maximum estimated memory used by the history, in bytes. 0 disables the limit */
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+    /** @brief Set the maximum delay in ms between two moves of the same item for them to form a single undo step. 0 disables merging */
+    void setMergeInterval(int interval);
+    /** @brief Estimated memory used by all the commands of the stack, in bytes */
+    qint64 memoryUsage() const;
+    /** @brief Number of steps at the bottom of the stack that were compacted */
+    int compactedCount() const;
+    /** @brief Estimated memory used by a command and its children, in bytes */
+    static qint64 commandCost(const QUndoCommand *cmd);
+    /** @brief Returns a text summary of the history memory usage, listing the most expensive steps. Used for debugging */
+    QString memoryReport(int maxEntries = 10) const;
+
+private:
+    qint64 m_memoryBudget;
+    qint64 m_memoryUsage;
+    int m_mergeInterval;
+    /** @brief Compact the oldest steps until the estimated usage fits in the budget */
+    void enforceBudget();
+    /** @brief Remove the compacted steps once everything above them was undone */
+    void dropCompacted();
+
 Q_SIGNALS:
     void invalidate(int ix);
+    /** @brief Emitted when the estimated memory used by the history changed */
+    void memoryUsageChanged(qint64 bytes);
 };
@@ -30,6 +30,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "timeline2/model/timelineitemmodel.hpp"
 #include "titler/titlewidget.h"
 #include "transitions/transitionsrepository.hpp"
+#include "utils/tracing.hpp"
 #include <config-kdenlive.h>
 
 #include <KBookmark>
@@ -153,6 +154,7 @@ KdenliveDoc::KdenliveDoc(std::shared_ptr<DocUndoStack> undoStack, std::pair<int,
 DocOpenResult KdenliveDoc::Open(const QUrl &url, const QString &projectFolder, QUndoGroup *undoGroup,
     bool recoverCorruption, MainWindow *parent)
 {
+    TRACE_SCOPE("io", "open project", url.toDisplayString());
 
     DocOpenResult result = DocOpenResult{};
 
@@ -713,6 +715,7 @@ QDomDocument KdenliveDoc::xmlSceneList(const QString &scene)
 
 bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene, bool saveOverExistingFile)
 {
+    TRACE_SCOPE("io", "save project", path);
     QDomDocument sceneList = xmlSceneList(scene);
     if (sceneList.isNull()) {
         // Make sure we don't save if scenelist is corrupted
@@ -196,6 +196,11 @@ std::unique_ptr<EffectsRepository> &EffectsRepository::get()
     return instance;
 }
 
+QString EffectsRepository::assetCacheName() const
+{
+    return QStringLiteral("effects");
+}
+
 QStringList EffectsRepository::assetDirs() const
 {
     QStringList dirs = QStandardPaths::locateAll(QStandardPaths::AppDataLocation, QStringLiteral("effect-templates"), QStandardPaths::LocateDirectory);
@@ -67,6 +67,8 @@ protected:
 
     QStringList assetDirs() const override;
 
+    QString assetCacheName() const override;
+
     void parseType(Mlt::Properties *metadata, Info &res) override;
 
     /** @brief Returns the metadata associated with the given asset*/
@@ -181,6 +181,8 @@ void EffectStackModel::removeEffectWithUndo(const std::shared_ptr<EffectItemMode
         setActiveEffect(current - 1);
     }
     int currentRow = effect->row();
+    // The undo keeps the effect and its parameters alive
+    UndoMemory::account(UndoMemory::serviceCost(effect->filter()));
     Fun local_undo = addItem_lambda(effect, parentId);
     if (currentRow != rowCount() - 1) {
         Fun move = moveItem_lambda(effect->getId(), currentRow, true);
@@ -322,6 +324,8 @@ QDomElement EffectStackModel::rowToXml(int row, QDomDocument &document)
 
 bool EffectStackModel::fromXml(const QDomElement &effectsXml, Fun &undo, Fun &redo)
 {
+    // The redo keeps the created effects alive
+    UndoMemory::account(UndoMemory::xmlCost(effectsXml));
     QDomNodeList nodeList = effectsXml.elementsByTagName(QStringLiteral("effect"));
     int parentIn = effectsXml.attribute(QStringLiteral("parentIn")).toInt();
     qDebug() << "// GOT PREVIOUS PARENTIN: " << parentIn << "\n\n=======\n=======\n\n";
@@ -11,6 +11,7 @@
 #include "bin/projectitemmodel.h"
 #include "core.h"
 #include "kdenlivesettings.h"
+#include "utils/tracing.hpp"
 
 #ifdef Q_OS_UNIX
 // on Unix systems we can use setpriority() to make proxy-rendering tasks lower
@@ -43,7 +44,9 @@ AbstractTask::AbstractTask(const ObjectId &owner, JOBTYPE type, QObject *object)
     , m_softDelete(false)
     , m_isForce(false)
     , m_running(false)
+    , m_usesEncoder(type == TRANSCODEJOB || type == PROXYJOB)
     , m_type(type)
+    , m_queuedAt(-1)
 {
     setAutoDelete(false);
     m_uuid = QUuid::createUuid();
@@ -127,6 +130,49 @@ void AbstractTask::setPreferredPriority(qint64 pid)
 #endif
 }
 
+const char *AbstractTask::typeName(JOBTYPE type)
+{
+    switch (type) {
+    case PROXYJOB:
+        return "proxy";
+    case CUTJOB:
+        return "cut";
+    case STABILIZEJOB:
+        return "stabilize";
+    case TRANSCODEJOB:
+        return "transcode";
+    case FILTERCLIPJOB:
+        return "filter";
+    case THUMBJOB:
+        return "thumbnail";
+    case ANALYSECLIPJOB:
+        return "analyse";
+    case LOADJOB:
+        return "load";
+    case AUDIOTHUMBJOB:
+        return "audio thumbnail";
+    case SPEEDJOB:
+        return "speed";
+    case CACHEJOB:
+        return "cache";
+    default:
+        return "task";
+    }
+}
+
+AbstractTaskDone::AbstractTaskDone(int cid, AbstractTask *task)
+    : m_cid(cid)
+    , m_task(task)
+    , m_start(Tracing::isEnabled() ? Tracing::now() : -1)
+{
+    if (m_start >= 0 && task->m_queuedAt >= 0) {
+        Tracing::span("tasks", "queued", qint64(quintptr(task)), task->m_queuedAt, QLatin1String(AbstractTask::typeName(task->m_type)));
+    }
+}
+
 AbstractTaskDone::~AbstractTaskDone() {
+    if (m_start >= 0) {
+        Tracing::complete("tasks", AbstractTask::typeName(m_task->m_type), m_start, QString::number(m_cid));
+    }
     pCore->taskManager.taskDone(m_cid, m_task);
 }
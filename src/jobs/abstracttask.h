@@ -18,6 +18,7 @@ class AbstractTask : public QObject, public QRunnable
 {
     Q_OBJECT
     friend class TaskManager;
+    friend class AbstractTaskDone;
 
 public:
     enum JOBTYPE {
@@ -52,6 +53,8 @@ protected:
     QMutex m_runMutex;
     bool m_isForce;
     bool m_running;
+    /** @brief The task runs an external encoder, so it goes to the transcode pool that limits concurrent encodings */
+    bool m_usesEncoder;
     QUuid m_uuid;
     void run() override;
     void cleanup();
@@ -60,6 +63,9 @@ private:
     //QString cacheKey();
     JOBTYPE m_type;
     int m_priority;
+    /** @brief Trace timestamp of the task submission, -1 when not tracing */
+    qint64 m_queuedAt;
+    static const char *typeName(JOBTYPE type);
     void cancelJob(bool softDelete = false);
     bool isCanceled() const;
 
@@ -72,11 +78,10 @@ Q_SIGNALS:
  */
 class AbstractTaskDone {
 public:
-    AbstractTaskDone(int cid, AbstractTask *task)
-        : m_cid(cid)
-        , m_task(task) {}
+    AbstractTaskDone(int cid, AbstractTask *task);
     ~AbstractTaskDone();
 private:
     int m_cid;
     AbstractTask *m_task;
+    qint64 m_start;
 };
@@ -10,11 +10,13 @@
 #include "bin/projectclip.h"
 #include "bin/projectitemmodel.h"
 #include "core.h"
+#include "utils/cachemanager.hpp"
 
 #include <KLocalizedString>
 #include <KMessageWidget>
 #include <QElapsedTimer>
 #include <QFile>
+#include <QFuture>
 #include <QImage>
 #include <QList>
 #include <QMutex>
@@ -23,6 +25,9 @@
 #include <QThreadPool>
 #include <QTime>
 #include <QVariantList>
+#include <QtConcurrent>
+#include <algorithm>
+#include <list>
 
 static QList<AudioLevelsTask *> tasksList;
 static QMutex tasksListMutex;
@@ -103,6 +108,8 @@ void AudioLevelsTask::run()
     QMapIterator<int, QString> st(streams);
     bool audioCreated = false;
     int streamIndex = -1;
+    // Streams that are not cached yet, the list must not be resized once the segments point to it
+    std::list<StreamLevels> pending;
     while (st.hasNext() && !m_isCanceled) {
         st.next();
         int stream = st.key();
@@ -112,12 +119,13 @@ void AudioLevelsTask::run()
         streamIndex++;
         // Generate one thumb per stream
         QString cachePath = binClip->getAudioThumbPath(stream);
-        QVector<uint8_t> mltLevels;
         if (!m_isForce && QFile::exists(cachePath)) {
             // Audio thumb already exists
+            CacheManager::get()->recordAccess(cachePath);
             QImage image(cachePath);
             if (!m_isCanceled && !image.isNull()) {
                 // convert cached image
+                QVector<uint8_t> mltLevels;
                 int n = image.width() * image.height();
                 for (int i = 0; n > 1 && i < n; i++) {
                     QRgb p = image.pixel(i / channels, i % channels);
@@ -127,132 +135,173 @@ void AudioLevelsTask::run()
                     mltLevels << qAlpha(p);
                 }
                 if (mltLevels.size() > 0) {
-                    QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(mltLevels);
-                    producer = binClip->originalProducer();
-                    producer->lock();
-                    QString key = QString("_kdenlive:audio%1").arg(stream);
-                    producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
-                    producer->unlock();
-                    producer.reset();
+                    storeLevels(binClip.get(), stream, mltLevels, -1);
                     continue;
                 }
             }
         }
+        pending.push_back({stream, streamIndex, channels, cachePath, std::vector<uint8_t>(size_t(lengthInFrames) * size_t(channels), 0)});
+    }
 
-        Mlt::Producer *aProd = new Mlt::Producer(pCore->getProjectProfile(), service.toUtf8().constData(), res.toUtf8().constData());
-        if (!aProd->is_valid()) {
-            QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Audio thumbs: cannot open file %1", res)),
-                                      Q_ARG(int, int(KMessageWidget::Warning)));
-            delete aProd;
-            return;
-        }
-        aProd->set("video_index", -1);
-        aProd->set("audio_index", stream);
-        aProd->set("vstream", -1);
-        aProd->set("astream", streamIndex);
-        Mlt::Filter chans(pCore->getProjectProfile(), "audiochannels");
-        Mlt::Filter converter(pCore->getProjectProfile(), "audioconvert");
-        Mlt::Filter levels(pCore->getProjectProfile(), "audiolevel");
-        aProd->attach(chans);
-        aProd->attach(converter);
-        aProd->attach(levels);
-        std::unique_ptr<Mlt::Producer> audioProducer;
-        audioProducer.reset(aProd);
-
-        double framesPerSecond = audioProducer->get_fps();
-        mlt_audio_format audioFormat = mlt_audio_s16;
-        QStringList keys;
-        keys.reserve(channels);
-        for (int i = 0; i < channels; i++) {
-            keys << "meta.media.audio_level." + QString::number(i);
+    if (!pending.empty() && !m_isCanceled) {
+        // Long clips are split in segments processed in parallel, each with its own producer, and all the streams are processed
+        // at the same time. The segments are ordered by position, so that the beginning of the clip is ready first
+        const int minLength = qMax(1, qRound(pCore->getCurrentFps() * 60));
+        const int count = qBound(1, (lengthInFrames + minLength - 1) / minLength, QThread::idealThreadCount());
+        const int length = (lengthInFrames + count - 1) / count;
+        QVector<Segment> segments;
+        for (int start = 0; start < lengthInFrames; start += length) {
+            for (StreamLevels &levels : pending) {
+                segments.append({&levels, start, qMin(start + length, lengthInFrames), 1, false});
+            }
         }
-        uint maxLevel = 1;
+        std::atomic<int> processed{0};
+        QFuture<void> future =
+            QtConcurrent::map(segments, [this, &service, &res, frequency, &processed](Segment &segment) { processSegment(service, res, frequency, segment, processed); });
+        const double total = double(lengthInFrames) * pending.size();
         QElapsedTimer updateTime;
         updateTime.start();
-        for (int z = 0; z < lengthInFrames && !m_isCanceled; ++z) {
-            int val = int(100.0 * z / lengthInFrames);
+        while (!future.isFinished()) {
+            QThread::msleep(100);
+            int val = int(100. * processed / total);
             if (m_progress != val) {
                 m_progress = val;
                 QMetaObject::invokeMethod(m_object, "updateJobProgress");
             }
-            QScopedPointer<Mlt::Frame> mltFrame(audioProducer->get_frame());
-            if ((mltFrame != nullptr) && mltFrame->is_valid() && (mltFrame->get_int("test_audio") == 0)) {
-                int samples = mlt_audio_calculate_frame_samples(float(framesPerSecond), frequency, z);
-                mltFrame->get_audio(audioFormat, frequency, channels, samples);
-                for (int channel = 0; channel < channels; ++channel) {
-                    uint lev = 256 * qMin(mltFrame->get_double(keys.at(channel).toUtf8().constData()) * 0.9, 1.0);
-                    mltLevels << lev;
-                    // double lev = mltFrame->get_double(keys.at(channel).toUtf8().constData());
-                    // mltLevels << lev;
-                    maxLevel = qMax(lev, maxLevel);
-                }
-            } else if (!mltLevels.isEmpty()) {
-                for (int channel = 0; channel < channels; channel++) {
-                    mltLevels << mltLevels.last();
-                }
-            }
             // Incrementally update the audio levels every 3 seconds.
             if (updateTime.elapsed() > 3000 && !m_isCanceled) {
                 updateTime.restart();
-                QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(mltLevels);
-                producer = binClip->originalProducer();
-                producer->lock();
-                QString key = QString("_kdenlive:audio%1").arg(stream);
-                producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
-                producer->unlock();
-                producer.reset();
+                for (const StreamLevels &levels : pending) {
+                    storeLevels(binClip.get(), levels.stream, QVector<uint8_t>(levels.levels.cbegin(), levels.levels.cend()), -1);
+                }
                 QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
             }
         }
+        future.waitForFinished();
+        bool openFailed = false;
+        for (const Segment &segment : qAsConst(segments)) {
+            segment.levels->maxLevel = qMax(segment.levels->maxLevel, segment.maxLevel);
+            segment.levels->failed = segment.levels->failed || segment.failed;
+            openFailed = openFailed || segment.failed;
+        }
+        if (openFailed && !m_isCanceled) {
+            QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Audio thumbs: cannot open file %1", res)),
+                                      Q_ARG(int, int(KMessageWidget::Warning)));
+        }
+    }
 
-        /*// Normalize
-        for (double &v : mltLevels) {
-            m_audioLevels << uchar(255 * v / maxLevel);
-        }*/
-        if (m_isCanceled) {
-            mltLevels.clear();
-            m_progress = 100;
-            QMetaObject::invokeMethod(m_object, "updateJobProgress");
+    if (m_isCanceled) {
+        m_progress = 100;
+        QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        pending.clear();
+    }
+    bool failed = false;
+    for (const StreamLevels &levels : pending) {
+        if (levels.failed) {
+            // Don't keep or cache levels with missing segments, so that they are computed again next time
+            failed = true;
+            continue;
         }
-        if (mltLevels.size() > 0) {
-            QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(mltLevels);
-            producer = binClip->originalProducer();
-            producer->lock();
-            QString key = QString("_kdenlive:audio%1").arg(stream);
-            QString key2 = QString("kdenlive:audio_max%1").arg(stream);
-            producer->set(key2.toUtf8().constData(), int(maxLevel));
-            producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
-            producer->unlock();
-            producer.reset();
-            // qDebug()<<"=== FINISHED PRODUCING AUDIO FOR: "<<key<<", SIZE: "<<levelsCopy->size();
-            m_progress = 100;
-            QMetaObject::invokeMethod(m_object, "updateJobProgress");
-            // Put into an image for caching.
-            int count = mltLevels.size();
-            QImage image((count + 3) / 4 / channels, channels, QImage::Format_ARGB32);
-            int n = image.width() * image.height();
-            for (int i = 0; i < n; i++) {
-                QRgb p;
-                if ((4 * i + 3) < count) {
-                    p = qRgba(mltLevels.at(4 * i), mltLevels.at(4 * i + 1), mltLevels.at(4 * i + 2), mltLevels.at(4 * i + 3));
-                } else {
-                    int last = mltLevels.last();
-                    int r = (4 * i + 0) < count ? mltLevels.at(4 * i + 0) : last;
-                    int g = (4 * i + 1) < count ? mltLevels.at(4 * i + 1) : last;
-                    int b = (4 * i + 2) < count ? mltLevels.at(4 * i + 2) : last;
-                    int a = last;
-                    p = qRgba(r, g, b, a);
-                }
-                image.setPixel(i / channels, i % channels, p);
+        const QVector<uint8_t> mltLevels(levels.levels.cbegin(), levels.levels.cend());
+        if (mltLevels.isEmpty()) {
+            continue;
+        }
+        storeLevels(binClip.get(), levels.stream, mltLevels, int(levels.maxLevel));
+        // qDebug()<<"=== FINISHED PRODUCING AUDIO FOR: "<<key<<", SIZE: "<<levelsCopy->size();
+        m_progress = 100;
+        QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        // Put into an image for caching.
+        int count = mltLevels.size();
+        QImage image((count + 3) / 4 / levels.channels, levels.channels, QImage::Format_ARGB32);
+        int n = image.width() * image.height();
+        for (int i = 0; i < n; i++) {
+            QRgb p;
+            if ((4 * i + 3) < count) {
+                p = qRgba(mltLevels.at(4 * i), mltLevels.at(4 * i + 1), mltLevels.at(4 * i + 2), mltLevels.at(4 * i + 3));
+            } else {
+                int last = mltLevels.last();
+                int r = (4 * i + 0) < count ? mltLevels.at(4 * i + 0) : last;
+                int g = (4 * i + 1) < count ? mltLevels.at(4 * i + 1) : last;
+                int b = (4 * i + 2) < count ? mltLevels.at(4 * i + 2) : last;
+                int a = last;
+                p = qRgba(r, g, b, a);
             }
-            image.save(cachePath);
-            audioCreated = true;
-            QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
+            image.setPixel(i / levels.channels, i % levels.channels, p);
+        }
+        if (image.save(levels.cachePath)) {
+            CacheManager::get()->recordWrite(CacheAudio, levels.cachePath);
         }
+        audioCreated = true;
+        QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
     }
-    if (!audioCreated && !m_isCanceled) {
+    if (!audioCreated && !failed && !m_isCanceled) {
         // Audio was cached, ensure the bin thumbnail is loaded
         QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, true));
     }
     QMetaObject::invokeMethod(m_object, "updateJobProgress");
 }
+
+void AudioLevelsTask::storeLevels(ProjectClip *clip, int stream, const QVector<uint8_t> &levels, int maxLevel)
+{
+    QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(levels);
+    std::shared_ptr<Mlt::Producer> producer = clip->originalProducer();
+    producer->lock();
+    if (maxLevel >= 0) {
+        QString key2 = QString("kdenlive:audio_max%1").arg(stream);
+        producer->set(key2.toUtf8().constData(), maxLevel);
+    }
+    QString key = QString("_kdenlive:audio%1").arg(stream);
+    producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
+    producer->unlock();
+}
+
+void AudioLevelsTask::processSegment(const QString &service, const QString &resource, int frequency, Segment &segment, std::atomic<int> &processed)
+{
+    StreamLevels *stream = segment.levels;
+    Mlt::Producer producer(pCore->getProjectProfile(), service.toUtf8().constData(), resource.toUtf8().constData());
+    if (!producer.is_valid()) {
+        // Reported once for the task by run()
+        segment.failed = true;
+        processed += segment.end - segment.start;
+        return;
+    }
+    producer.set("video_index", -1);
+    producer.set("audio_index", stream->stream);
+    producer.set("vstream", -1);
+    producer.set("astream", stream->streamIndex);
+    Mlt::Filter chans(pCore->getProjectProfile(), "audiochannels");
+    Mlt::Filter converter(pCore->getProjectProfile(), "audioconvert");
+    Mlt::Filter levels(pCore->getProjectProfile(), "audiolevel");
+    producer.attach(chans);
+    producer.attach(converter);
+    producer.attach(levels);
+
+    const int channels = stream->channels;
+    double framesPerSecond = producer.get_fps();
+    mlt_audio_format audioFormat = mlt_audio_s16;
+    QList<QByteArray> keys;
+    keys.reserve(channels);
+    for (int i = 0; i < channels; i++) {
+        keys << QByteArray("meta.media.audio_level.") + QByteArray::number(i);
+    }
+    for (int z = segment.start; z < segment.end && !m_isCanceled; ++z) {
+        uint8_t *frameLevels = stream->levels.data() + size_t(z) * size_t(channels);
+        producer.seek(z);
+        QScopedPointer<Mlt::Frame> mltFrame(producer.get_frame());
+        if ((mltFrame != nullptr) && mltFrame->is_valid() && (mltFrame->get_int("test_audio") == 0)) {
+            int samples = mlt_audio_calculate_frame_samples(float(framesPerSecond), frequency, z);
+            int audioFrequency = frequency;
+            int audioChannels = channels;
+            mltFrame->get_audio(audioFormat, audioFrequency, audioChannels, samples);
+            for (int channel = 0; channel < channels; ++channel) {
+                uint lev = qMin(uint(256 * qMin(mltFrame->get_double(keys.at(channel).constData()) * 0.9, 1.0)), 255u);
+                frameLevels[channel] = uint8_t(lev);
+                segment.maxLevel = qMax(lev, segment.maxLevel);
+            }
+        } else if (z > segment.start) {
+            // Repeat the previous levels
+            std::copy(frameLevels - channels, frameLevels, frameLevels);
+        }
+        processed++;
+    }
+}
@@ -12,6 +12,11 @@
 
 #include <QRunnable>
 #include <QObject>
+#include <QVector>
+#include <atomic>
+#include <vector>
+
+class ProjectClip;
 
 class AudioLevelsTask : public AbstractTask
 {
@@ -22,4 +27,29 @@ public:
 protected:
     void run() override;
 
+private:
+    /** @brief The levels of an audio stream being computed, one value per channel and per frame */
+    struct StreamLevels
+    {
+        int stream;
+        int streamIndex;
+        int channels;
+        QString cachePath;
+        std::vector<uint8_t> levels;
+        uint maxLevel{1};
+        /** @brief True if the file could not be opened for a segment, the levels are then incomplete and not cached */
+        bool failed{false};
+    };
+    /** @brief A range of frames of a stream, processed by its own producer */
+    struct Segment
+    {
+        StreamLevels *levels;
+        int start;
+        int end;
+        uint maxLevel;
+        bool failed;
+    };
+    void processSegment(const QString &service, const QString &resource, int frequency, Segment &segment, std::atomic<int> &processed);
+    /** @brief Attach the levels of a stream to the clip producer, @p maxLevel is only stored if positive */
+    static void storeLevels(ProjectClip *clip, int stream, const QVector<uint8_t> &levels, int maxLevel);
 };
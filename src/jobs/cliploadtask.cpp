@@ -15,6 +15,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kdenlivesettings.h"
 #include "mltcontroller/clipcontroller.h"
 #include "project/dialogs/slideshowclip.h"
+#include "utils/mediaprobecache.hpp"
 #include "utils/thumbnailcache.hpp"
 
 #include "xml/xml.hpp"
@@ -317,6 +318,10 @@ void ClipLoadTask::run()
         service.clear();
     }
     std::shared_ptr<Mlt::Producer> producer;
+    // Properties of a previous probe of this file, if it did not change since
+    QMap<QString, QString> cachedProbe;
+    // The probe result of the file, before the clip properties of the project are applied
+    QMap<QString, QString> probedProperties;
     switch (type) {
     case ClipType::Color:
         producer = loadResource(resource, QStringLiteral("color:"));
@@ -446,7 +451,20 @@ void ClipLoadTask::run()
             if (service == QLatin1String("avformat-novalidate:")) {
                 service = QStringLiteral("avformat:");
             }
+            if (service == QLatin1String("avformat:")) {
+                cachedProbe = MediaProbeCache::get()->probeData(resource, pCore->getCurrentFps());
+                if (!cachedProbe.isEmpty()) {
+                    // File was already probed, don't open it
+                    service = QStringLiteral("avformat-novalidate:");
+                }
+            }
             producer = loadResource(resource, service);
+            if (!cachedProbe.isEmpty() && producer->is_valid()) {
+                MediaProbeCache::applyProbeData(cachedProbe, *producer.get());
+                producer->set("mute_on_pause", 0);
+            } else if (service == QLatin1String("avformat:") && producer->is_valid()) {
+                probedProperties = MediaProbeCache::probeProperties(*producer.get());
+            }
         } else {
             producer = std::make_shared<Mlt::Producer>(pCore->getProjectProfile(), nullptr, resource.toUtf8().constData());
         }
@@ -631,6 +649,10 @@ void ClipLoadTask::run()
             producer->set("out", fixedLength - 1);
         }
     } else if (mltService.startsWith(QLatin1String("avformat"))) {
+        if (!probedProperties.isEmpty() && mltService == QLatin1String("avformat")) {
+            // Remember the probe result for the next time this file is loaded
+            MediaProbeCache::get()->storeProbeData(resource, pCore->getCurrentFps(), probedProperties);
+        }
         // Start probe to init properties
         int vindex = producer->get_int("video_index");
         bool hasAudio = false;
@@ -651,7 +673,9 @@ void ClipLoadTask::run()
             }
         }
         // Check audio / video
-        producer->probe();
+        if (cachedProbe.isEmpty()) {
+            producer->probe();
+        }
         hasAudio = producer->get_int("video_index") > -1;
         hasVideo = producer->get_int("audio_index") > -1;
         if (hasAudio) {
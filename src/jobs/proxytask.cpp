@@ -13,7 +13,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kdenlive_debug.h"
 #include "kdenlivesettings.h"
 #include "macros.hpp"
+#include "utils/cachemanager.hpp"
 
+#include <QImageReader>
 #include <QProcess>
 #include <QTemporaryFile>
 #include <QThread>
@@ -38,6 +40,11 @@ void ProxyTask::start(const ObjectId &owner, QObject *object, bool force)
     ProxyTask *task = new ProxyTask(owner, object);
     // Otherwise, start a new proxy generation thread.
     task->m_isForce = force;
+    auto *clip = qobject_cast<ProjectClip *>(object);
+    if (clip && clip->clipType() == ClipType::Image) {
+        // Image proxies are decoded and scaled in process, they don't need to wait for an encoder slot
+        task->m_usesEncoder = false;
+    }
     pCore->taskManager.startTask(owner.itemId, task);
 }
 
@@ -57,6 +64,7 @@ void ProxyTask::run()
     QFileInfo fInfo(dest);
     if (binClip->getProducerIntProperty(QStringLiteral("_overwriteproxy")) == 0 && fInfo.exists() && fInfo.size() > 0) {
         // Proxy clip already created
+        CacheManager::get()->recordAccess(dest);
         m_progress = 100;
         QMetaObject::invokeMethod(m_object, "updateJobProgress");
         QMetaObject::invokeMethod(binClip.get(), "updateProxyProducer", Qt::QueuedConnection, Q_ARG(QString, dest));
@@ -190,67 +198,22 @@ void ProxyTask::run()
         delete playlist;
     } else if (type == ClipType::Image) {
         m_isFfmpegJob = false;
-        // Image proxy
-        QImage i(source);
-        if (i.isNull()) {
+        // Image proxy, scaled to predefined size
+        switch (createImageProxy(source, dest, KdenliveSettings::proxyimagesize(), exif, m_logDetails)) {
+        case ImageProxyResult::Created:
+            result = true;
+            break;
+        case ImageProxyResult::TooSmall:
+            m_logDetails = i18n("Image too small to be proxied.");
             result = false;
+            break;
+        case ImageProxyResult::Failed:
             QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Cannot load image %1.", source)),
                                       Q_ARG(int, int(KMessageWidget::Warning)));
             m_progress = 100;
             QMetaObject::invokeMethod(m_object, "updateJobProgress");
             return;
         }
-
-        QImage proxy;
-        // Images are scaled to predefined size.
-        int maxSize = qMax(i.width(), i.height());
-        if (KdenliveSettings::proxyimagesize() < maxSize) {
-            if (i.width() > i.height()) {
-                proxy = i.scaledToWidth(KdenliveSettings::proxyimagesize());
-            } else {
-                proxy = i.scaledToHeight(KdenliveSettings::proxyimagesize());
-            }
-            if (exif > 1) {
-                // Rotate image according to exif data
-                QImage processed;
-                QTransform matrix;
-
-                switch (exif) {
-                case 2:
-                    matrix.scale(-1, 1);
-                    break;
-                case 3:
-                    matrix.rotate(180);
-                    break;
-                case 4:
-                    matrix.scale(1, -1);
-                    break;
-                case 5:
-                    matrix.rotate(270);
-                    matrix.scale(-1, 1);
-                    break;
-                case 6:
-                    matrix.rotate(90);
-                    break;
-                case 7:
-                    matrix.rotate(90);
-                    matrix.scale(-1, 1);
-                    break;
-                case 8:
-                    matrix.rotate(270);
-                    break;
-                }
-                processed = proxy.transformed(matrix);
-                processed.save(dest);
-            } else {
-                proxy.save(dest);
-            }
-            result = true;
-        } else {
-            // Image is too small to be proxied
-            m_logDetails = i18n("Image too small to be proxied.");
-            result = false;
-        }
     } else {
         m_isFfmpegJob = true;
         if (!QFileInfo(KdenliveSettings::ffmpegpath()).isFile()) {
@@ -403,6 +366,7 @@ void ProxyTask::run()
             }
         } else if (binClip) {
             // Job successful
+            CacheManager::get()->recordWrite(CacheProxy, dest);
             QMetaObject::invokeMethod(binClip.get(), "updateProxyProducer", Qt::QueuedConnection, Q_ARG(QString, dest));
         }
     } else {
@@ -417,6 +381,79 @@ void ProxyTask::run()
     return;
 }
 
+QTransform ProxyTask::orientationMatrix(int orientation)
+{
+    QTransform matrix;
+    switch (orientation) {
+    case 2:
+        matrix.scale(-1, 1);
+        break;
+    case 3:
+        matrix.rotate(180);
+        break;
+    case 4:
+        matrix.scale(1, -1);
+        break;
+    case 5:
+        matrix.rotate(270);
+        matrix.scale(-1, 1);
+        break;
+    case 6:
+        matrix.rotate(90);
+        break;
+    case 7:
+        matrix.rotate(90);
+        matrix.scale(-1, 1);
+        break;
+    case 8:
+        matrix.rotate(270);
+        break;
+    default:
+        break;
+    }
+    return matrix;
+}
+
+ProxyTask::ImageProxyResult ProxyTask::createImageProxy(const QString &source, const QString &dest, int maxSize, int orientation, QString &error)
+{
+    QImageReader reader(source);
+    // The orientation comes from the clip properties, so that it matches the producer
+    reader.setAutoTransform(false);
+    // Only the header is read here, so we don't decode images that don't need a proxy
+    const QSize size = reader.size();
+    if (size.isValid() && qMax(size.width(), size.height()) <= maxSize) {
+        return ImageProxyResult::TooSmall;
+    }
+    QImage proxy;
+    if (size.isValid() && reader.supportsOption(QImageIOHandler::ScaledSize)) {
+        // The decoder skips the unneeded resolution, for example JPEG images are decoded at 1/2, 1/4 or 1/8 of their size
+        // before being smoothly scaled to the requested size
+        reader.setScaledSize(size.scaled(maxSize, maxSize, Qt::KeepAspectRatio).expandedTo(QSize(1, 1)));
+        proxy = reader.read();
+    } else {
+        proxy = reader.read();
+        if (!proxy.isNull()) {
+            if (qMax(proxy.width(), proxy.height()) <= maxSize) {
+                return ImageProxyResult::TooSmall;
+            }
+            proxy = proxy.scaled(maxSize, maxSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+    }
+    if (proxy.isNull()) {
+        error = reader.errorString();
+        return ImageProxyResult::Failed;
+    }
+    if (orientation > 1) {
+        // Rotate image according to exif data, cheap now that the image is small
+        proxy = proxy.transformed(orientationMatrix(orientation));
+    }
+    if (!proxy.save(dest)) {
+        error = i18n("Cannot write proxy image %1.", dest);
+        return ImageProxyResult::Failed;
+    }
+    return ImageProxyResult::Created;
+}
+
 void ProxyTask::processLogInfo()
 {
     const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardError());
@@ -8,6 +8,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstracttask.h"
 
+#include <QTransform>
+
 class QProcess;
 
 class ProxyTask : public AbstractTask
@@ -16,6 +18,16 @@ public:
     ProxyTask(const ObjectId &owner, QObject* object);
     static void start(const ObjectId &owner, QObject* object, bool force = false);
 
+    enum class ImageProxyResult { Created, TooSmall, Failed };
+    /** @brief Write a copy of @p source scaled to fit in @p maxSize pixels to @p dest.
+     *  Images that already fit are not decoded nor re-encoded. Formats supporting it (JPEG) are decoded at reduced resolution.
+     *  @param orientation the EXIF orientation of the source, applied to the proxy
+     *  @param error set to the reason of a failure
+     */
+    static ImageProxyResult createImageProxy(const QString &source, const QString &dest, int maxSize, int orientation, QString &error);
+    /** @brief The transform applying an EXIF orientation (1 to 8) */
+    static QTransform orientationMatrix(int orientation);
+
 protected:
     void run() override;
 
@@ -0,0 +1,172 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "scenedetector.h"
+
+#include <QFuture>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mlt++/MltFrame.h>
+#include <mlt++/MltProducer.h>
+#include <mlt++/MltProfile.h>
+#include <vector>
+
+SceneDetector::SceneDetector(Mlt::Profile &profile, const QString &resource, double threshold)
+    : m_profile(profile)
+    , m_resource(resource)
+    , m_threshold(threshold)
+{
+}
+
+SceneDetector::Signature SceneDetector::signature(const uint8_t *luma, int width, int height, int pixelStride, int lineStride)
+{
+    Signature result;
+    result.histogram.fill(0.f);
+    result.edges.fill(0.f);
+    if (width < 2 || height < 2) {
+        return result;
+    }
+    std::array<uint32_t, HistogramBins> histogram{};
+    std::array<uint32_t, GridSize * GridSize> edges{};
+    std::array<uint32_t, GridSize * GridSize> samples{};
+    std::vector<int> cellColumn(size_t(width - 1));
+    for (int x = 0; x < width - 1; ++x) {
+        cellColumn[size_t(x)] = x * GridSize / width;
+    }
+    std::vector<uint16_t> gradient(size_t(width - 1));
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *line = luma + y * lineStride;
+        for (int x = 0; x < width; ++x) {
+            histogram[line[x * pixelStride] * HistogramBins / 256]++;
+        }
+        if (y == height - 1) {
+            break;
+        }
+        // Gradients are computed in a separate branchless loop that the compiler can vectorize
+        const uint8_t *next = line + lineStride;
+        for (int x = 0; x < width - 1; ++x) {
+            const int value = line[x * pixelStride];
+            gradient[size_t(x)] = uint16_t(std::abs(line[(x + 1) * pixelStride] - value) + std::abs(next[x * pixelStride] - value));
+        }
+        const int row = y * GridSize / height * GridSize;
+        for (int x = 0; x < width - 1; ++x) {
+            edges[size_t(row + cellColumn[size_t(x)])] += gradient[size_t(x)];
+            samples[size_t(row + cellColumn[size_t(x)])]++;
+        }
+    }
+    const float pixels = float(width) * float(height);
+    for (int i = 0; i < HistogramBins; ++i) {
+        result.histogram[size_t(i)] = float(histogram[size_t(i)]) / pixels;
+    }
+    for (size_t i = 0; i < edges.size(); ++i) {
+        if (samples[i] > 0) {
+            result.edges[i] = float(edges[i]) / float(samples[i]);
+        }
+    }
+    return result;
+}
+
+double SceneDetector::difference(const Signature &a, const Signature &b)
+{
+    // Histograms catch changes of lighting and colors, edges catch changes of content with a similar exposure
+    double histogram = 0.;
+    for (size_t i = 0; i < a.histogram.size(); ++i) {
+        histogram += std::fabs(a.histogram[i] - b.histogram[i]);
+    }
+    histogram /= 2.;
+    double change = 0.;
+    double total = 0.;
+    for (size_t i = 0; i < a.edges.size(); ++i) {
+        change += std::fabs(a.edges[i] - b.edges[i]);
+        total += std::max(a.edges[i], b.edges[i]);
+    }
+    // Below one level per cell, both frames are flat and their noise is not meaningful
+    const double edges = total > double(GridSize * GridSize) ? change / total : 0.;
+    return (histogram + edges) / 2.;
+}
+
+void SceneDetector::analyseSegment(Segment &segment)
+{
+    Mlt::Producer producer(m_profile, nullptr, m_resource.toUtf8().constData());
+    if (!producer.is_valid()) {
+        m_failed = true;
+        m_processed += segment.end - segment.start;
+        return;
+    }
+    // Only the video is needed
+    producer.set("audio_index", -1);
+    producer.set("astream", -1);
+    Signature previous;
+    bool hasPrevious = false;
+    // Start one frame early so that a cut on the first frame of the segment is found
+    for (int pos = qMax(0, segment.start - 1); pos < segment.end && !m_canceled; ++pos) {
+        producer.seek(pos);
+        std::unique_ptr<Mlt::Frame> frame(producer.get_frame());
+        Signature current;
+        bool valid = false;
+        if (frame != nullptr && frame->is_valid()) {
+            frame->set("consumer.deinterlacer", "onefield");
+            frame->set("consumer.top_field_first", -1);
+            frame->set("consumer.rescale", "nearest");
+            mlt_image_format format = mlt_image_yuv422;
+            int width = m_profile.width();
+            int height = m_profile.height();
+            const uint8_t *image = frame->get_image(format, width, height);
+            if (image != nullptr && format == mlt_image_yuv422) {
+                current = signature(image, width, height, 2, 2 * width);
+                valid = true;
+            } else if (image != nullptr && format == mlt_image_yuv420p) {
+                current = signature(image, width, height, 1, width);
+                valid = true;
+            }
+        }
+        if (valid && hasPrevious && pos >= segment.start && difference(previous, current) > m_threshold) {
+            segment.cuts.append(pos);
+        }
+        if (valid) {
+            previous = current;
+        }
+        hasPrevious = valid;
+        if (pos >= segment.start) {
+            m_processed++;
+        }
+    }
+}
+
+QList<int> SceneDetector::detect(int duration, const std::function<bool(int)> &progress)
+{
+    QList<int> cuts;
+    m_processed = 0;
+    m_canceled = false;
+    m_failed = false;
+    if (duration <= 0 || !progress(0)) {
+        return cuts;
+    }
+    const int count = qBound(1, (duration + m_segmentLength - 1) / m_segmentLength, QThread::idealThreadCount());
+    const int length = (duration + count - 1) / count;
+    QVector<Segment> segments;
+    for (int start = 0; start < duration; start += length) {
+        segments.append({start, qMin(start + length, duration), {}});
+    }
+    QFuture<void> future = QtConcurrent::map(segments, [this](Segment &segment) { analyseSegment(segment); });
+    while (!future.isFinished()) {
+        if (!m_canceled && !progress(int(100. * m_processed / duration))) {
+            m_canceled = true;
+        }
+        QThread::msleep(100);
+    }
+    future.waitForFinished();
+    if (m_canceled) {
+        return cuts;
+    }
+    for (const Segment &segment : qAsConst(segments)) {
+        cuts << segment.cuts;
+    }
+    return cuts;
+}
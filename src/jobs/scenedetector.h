@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace Mlt {
+class Profile;
+}
+
+/** @class SceneDetector
+    @brief Finds the scene changes of a video clip through MLT, without an external process.
+    Frames are decoded at the resolution of the given profile (usually the thumbnail profile). Each frame is reduced to a luma
+    histogram and a grid of edge strengths, a scene starts when the difference between two consecutive frames exceeds the threshold.
+    Long clips are split in segments that are analysed in parallel, each with its own producer.
+ */
+class SceneDetector
+{
+public:
+    static constexpr int HistogramBins = 64;
+    static constexpr int GridSize = 8;
+
+    /** @brief The reduced representation of a frame used to compare it with its neighbours */
+    struct Signature
+    {
+        /** @brief Luma histogram, normalized so that the bins sum to 1 */
+        std::array<float, HistogramBins> histogram;
+        /** @brief Mean gradient magnitude in each cell of a GridSize x GridSize grid */
+        std::array<float, GridSize * GridSize> edges;
+    };
+
+    /** @param threshold the minimum difference between two frames, between 0 and 1, to detect a scene change */
+    SceneDetector(Mlt::Profile &profile, const QString &resource, double threshold);
+
+    /** @brief Analyse the frames 0 to @p duration - 1 and return the first frame of each new scene, sorted.
+     *  @param progress called regularly from the calling thread with a percentage, returns false to abort the analysis
+     */
+    QList<int> detect(int duration, const std::function<bool(int)> &progress);
+    /** @brief Returns true if the last analysis could not open the clip */
+    bool hasFailed() const { return m_failed; }
+
+    /** @brief Compute the signature of a luma plane
+     *  @param pixelStride the distance in bytes between two luma samples of a line (2 for packed yuv422)
+     */
+    static Signature signature(const uint8_t *luma, int width, int height, int pixelStride, int lineStride);
+    /** @brief Difference between two frames, 0 for identical frames and 1 for completely different ones */
+    static double difference(const Signature &a, const Signature &b);
+
+private:
+    struct Segment
+    {
+        int start;
+        int end;
+        QList<int> cuts;
+    };
+    Mlt::Profile &m_profile;
+    QString m_resource;
+    double m_threshold;
+    /** @brief Clips shorter than this many frames are analysed in a single segment */
+    int m_segmentLength{1500};
+    std::atomic<int> m_processed{0};
+    std::atomic<bool> m_canceled{false};
+    std::atomic<bool> m_failed{false};
+    void analyseSegment(Segment &segment);
+};
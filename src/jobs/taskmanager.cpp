@@ -13,6 +13,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kdenlivesettings.h"
 #include "macros.hpp"
 #include "undohelper.hpp"
+#include "utils/tracing.hpp"
 
 #include <KMessageWidget>
 #include <QFuture>
@@ -44,6 +45,22 @@ void TaskManager::updateConcurrency()
     m_transcodePool.setMaxThreadCount(KdenliveSettings::proxythreads());
 }
 
+void TaskManager::setMaxThreadCount(int threads)
+{
+    m_taskPool.setMaxThreadCount(qMax(threads, 1));
+    m_transcodePool.setMaxThreadCount(qMax(threads, 1));
+}
+
+int TaskManager::pendingTaskCount() const
+{
+    QReadLocker lk(&m_tasksListLock);
+    int count = 0;
+    for (const auto &task : m_taskList) {
+        count += task.second.size();
+    }
+    return count;
+}
+
 void TaskManager::discardJobs(const ObjectId &owner, AbstractTask::JOBTYPE type, bool softDelete, const QVector<AbstractTask::JOBTYPE> exceptions)
 {
     qDebug() << "========== READY FOR TASK DISCARD ON: " << owner.itemId;
@@ -73,7 +90,7 @@ void TaskManager::discardJobs(const ObjectId &owner, AbstractTask::JOBTYPE type,
             ix--;
             continue;
         }
-        if (taskType != AbstractTask::TRANSCODEJOB && taskType != AbstractTask::PROXYJOB) {
+        if (!t->m_usesEncoder) {
             if (m_taskPool.tryTake(t)) {
                 // Task was not started yet, we can simply delete
                 delete t;
@@ -114,12 +131,11 @@ void TaskManager::discardJob(const ObjectId &owner, const QUuid &uuid)
     int ix = taskList.size() - 1;
     while (ix >= 0) {
         AbstractTask *t = taskList.at(ix);
-        AbstractTask::JOBTYPE taskType = t->m_type;
         if ((t->m_uuid != uuid) || t->m_progress == 100 || t->isCanceled()) {
             ix--;
             continue;
         }
-        if (taskType != AbstractTask::TRANSCODEJOB && taskType != AbstractTask::PROXYJOB) {
+        if (!t->m_usesEncoder) {
             if (m_taskPool.tryTake(t)) {
                 // Task was not started yet, we can simply delete
                 delete t;
@@ -186,6 +202,7 @@ void TaskManager::updateJobCount()
         count += task.second.size();
     }
     // Set jobs count
+    Tracing::counter("tasks", "jobs", count);
     Q_EMIT jobCount(count);
 }
 
@@ -225,7 +242,7 @@ void TaskManager::slotCancelJobs(bool leaveBlocked, const QVector<AbstractTask::
                 ix--;
                 continue;
             }
-            if (taskType != AbstractTask::TRANSCODEJOB && taskType != AbstractTask::PROXYJOB) {
+            if (!t->m_usesEncoder) {
                 if (m_taskPool.tryTake(t)) {
                     // Task was not started yet, we can simply delete
                     delete t;
@@ -283,7 +300,10 @@ void TaskManager::startTask(int ownerId, AbstractTask *task)
         m_taskList[ownerId].emplace_back(task);
     }
     m_tasksListLock.unlock();
-    if (task->m_type == AbstractTask::TRANSCODEJOB || task->m_type == AbstractTask::PROXYJOB) {
+    if (Tracing::isEnabled()) {
+        task->m_queuedAt = Tracing::now();
+    }
+    if (task->m_usesEncoder) {
         // We only want a limited concurrent jobs for those as for example GPU usually only accept 2 concurrent encoding jobs
         m_transcodePool.start(task, task->m_priority);
     } else {
@@ -64,6 +64,10 @@ public:
 
     /** @brief Update the number of concurrent jobs allowed */
     void updateConcurrency();
+    /** @brief Set the number of concurrent jobs for all task types, used in batch mode */
+    void setMaxThreadCount(int threads);
+    /** @brief Number of tasks waiting or running */
+    int pendingTaskCount() const;
 
     /** @brief We are aborting all tasks and don't want them to send any updates */
     bool isBlocked() const;
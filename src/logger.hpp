@@ -21,6 +21,8 @@
 #include <rttr/variant.h>
 #pragma GCC diagnostic pop
 
+#include "utils/tracing.hpp"
+
 /** @brief This class is meant to provide an easy way to reproduce bugs involving the model.
  * The idea is to log any modifier function involving a model class, and trace the parameters that were passed, to be able to generate a test-case producing the
  * same behaviour. Note that many modifier functions of the models are nested. We are only interested in the top-most call, and we must ignore bottom calls.
@@ -118,7 +120,9 @@ protected:
     }
 
 /// See Logger::log. Note that the macro fills the ptr instance and the method name for you.
+/// The call is also recorded as a trace event when tracing is enabled, see Tracing.
 #define TRACE(...)                                                                                                                                             \
+    TraceScope __traceScope("model", __FUNCTION__);                                                                                                            \
     LogGuard __guard;                                                                                                                                          \
     if (__guard.hasGuard()) {                                                                                                                                  \
         Logger::log(this, __FUNCTION__, {__VA_ARGS__});                                                                                                        \
@@ -126,6 +130,7 @@ protected:
 
 /// Same as TRACE, but called from a static function
 #define TRACE_STATIC(ptr, ...)                                                                                                                                 \
+    TraceScope __traceScope("model", __FUNCTION__);                                                                                                            \
     LogGuard __guard;                                                                                                                                          \
     if (__guard.hasGuard()) {                                                                                                                                  \
         Logger::log(ptr.get(), __FUNCTION__, {__VA_ARGS__});                                                                                                   \
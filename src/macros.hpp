@@ -55,11 +55,28 @@ reading a Read-protected property. In that case, we try to write lock it first (
         Q_ASSERT(false);                                                                                                                                       \
     }
 
+/** @brief Same as PUSH_UNDO, but the command can absorb the next one of the same kind on the same item (mergeKey), see FunctionalUndoCommand::setMergeKey
+ */
+#define PUSH_MERGEABLE_UNDO(undo, redo, text, mergeId, mergeKey) PUSH_CHAINED_UNDO(undo, redo, text, mergeId, mergeKey, QString())
+
+/** @brief Same as PUSH_MERGEABLE_UNDO, for operations that change the key of the item: the next command is merged if its key is nextMergeKey
+ */
+#define PUSH_CHAINED_UNDO(undo, redo, text, mergeId, mergeKey, nextMergeKey)                                                                                   \
+    if (auto ptr = m_undoStack.lock()) {                                                                                                                       \
+        auto *mergeableCommand = new FunctionalUndoCommand(undo, redo, text);                                                                                  \
+        mergeableCommand->setMergeKey(mergeId, mergeKey, nextMergeKey);                                                                                        \
+        ptr->push(mergeableCommand);                                                                                                                           \
+    } else {                                                                                                                                                   \
+        qDebug() << "ERROR : unable to access undo stack";                                                                                                     \
+        Q_ASSERT(false);                                                                                                                                       \
+    }
+
 /** @brief This macro takes as parameter one atomic operation and its reverse, and update
  * the undo and redo functional stacks/queue accordingly
  * This should be used in the rare case where we don't need a lock mutex. In general, prefer the other version
  */
 #define UPDATE_UNDO_REDO_NOLOCK(operation, reverse, undo, redo)                                                                                                \
+    UndoMemory::recordOperation();                                                                                                                             \
     undo = [reverse, undo]() {                                                                                                                                 \
         bool v = reverse();                                                                                                                                    \
         return undo() && v;                                                                                                                                    \
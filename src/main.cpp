@@ -14,6 +14,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kdenlive_debug.h"
 #include "kdenlivesettings.h"
 #include "mainwindow.h"
+#include "project/headlessbatch.h"
 #include "render/renderrequest.h"
 #include <config-kdenlive.h>
 #include <project/projectmanager.h>
@@ -386,6 +387,21 @@ int main(int argc, char *argv[])
                                   i18n("Exit after (detached) render process started, without this flag it exists only after it finished."));
     parser.addOption(exitOption);
 
+    // batch options
+    QCommandLineOption batchOption(QStringLiteral("batch"),
+                                   i18n("Open the project, run the comma separated jobs (proxy, audio, thumbs, preview, all or none), print the timings and exit."),
+                                   QStringLiteral("jobs"));
+    parser.addOption(batchOption);
+    QCommandLineOption batchThreadsOption(QStringLiteral("batch-threads"), i18n("Number of jobs running at the same time in batch mode."),
+                                          QStringLiteral("count"));
+    parser.addOption(batchThreadsOption);
+    QCommandLineOption batchSaveOption(QStringLiteral("batch-save"), i18n("Save a copy of the project after the batch jobs, to measure the save time."),
+                                       QStringLiteral("file"));
+    parser.addOption(batchSaveOption);
+    QCommandLineOption batchReportOption(QStringLiteral("batch-report"), i18n("Also write the batch timings and cache statistics to a JSON file."),
+                                         QStringLiteral("file"));
+    parser.addOption(batchReportOption);
+
     parser.addPositionalArgument(QStringLiteral("file"), i18n("Kdenlive document to open."));
     parser.addPositionalArgument(QStringLiteral("rendering"), i18n("Output file for rendered video."));
 
@@ -415,6 +431,34 @@ int main(int argc, char *argv[])
 
     qApp->processEvents(QEventLoop::AllEvents);
 
+    if (parser.isSet(batchOption)) {
+        if (url.isEmpty()) {
+            qCritical() << "You need to give a valid project file to run batch jobs.";
+            return EXIT_FAILURE;
+        }
+        HeadlessBatch batch;
+        HeadlessBatch::Jobs jobs;
+        QString error;
+        if (!HeadlessBatch::parseJobs(parser.value(batchOption), jobs, error)) {
+            qCritical() << error;
+            return EXIT_FAILURE;
+        }
+        batch.setJobs(jobs);
+        batch.setConcurrency(parser.value(batchThreadsOption).toInt());
+        batch.setSaveCopy(parser.value(batchSaveOption));
+        batch.setReportFile(parser.value(batchReportOption));
+        if (!Core::build(packageType, true)) {
+            return EXIT_FAILURE;
+        }
+        pCore->initHeadless(QUrl());
+        app.processEvents();
+        int exitCode = batch.run(url);
+        app.processEvents();
+        Core::clean();
+        app.processEvents();
+        return exitCode;
+    }
+
     if (parser.isSet(renderOption)) {
         if (url.isEmpty()) {
             qCritical() << "You need to give a valid file if you want to render from the command line.";
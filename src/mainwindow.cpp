@@ -26,6 +26,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "docktitlebarmanager.h"
 #include "effects/effectbasket.h"
 #include "effects/effectlist/view/effectlistwidget.hpp"
+#include "effects/effectsrepository.hpp"
 #include "jobs/audiolevelstask.h"
 #include "jobs/customjobtask.h"
 #include "jobs/scenesplittask.h"
@@ -65,6 +66,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "titler/titlewidget.h"
 #include "transitions/transitionlist/view/transitionlistwidget.hpp"
 #include "transitions/transitionsrepository.hpp"
+#include "utils/cachemanager.hpp"
+#include "utils/startupprofiler.hpp"
 #include "utils/thememanager.h"
 #include "widgets/progressbutton.h"
 #include <config-kdenlive.h>
@@ -92,6 +95,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <KCoreAddons>
 #include <KDualAction>
 #include <KEditToolBar>
+#include <KIO/Global>
 #include <KIconTheme>
 #include <KLocalizedString>
 #include <KMessageBox>
@@ -114,6 +118,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QDesktopServices>
 #include <QDialogButtonBox>
 #include <QFileDialog>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMenu>
 #include <QMenuBar>
 #include <QPushButton>
@@ -241,8 +247,23 @@ void MainWindow::init(const QString &mltPath)
     QString defaultProfile = KdenliveSettings::default_profile();
 
     // Initialise MLT connection
-    MltConnection::construct(mltPath);
-    pCore->setCurrentProfile(defaultProfile.isEmpty() ? ProjectManager::getDefaultProjectFormat() : defaultProfile);
+    {
+        StartupPhase phase(QStringLiteral("mlt"));
+        MltConnection::construct(mltPath);
+    }
+    {
+        // Scan the luma folders once before anything runs concurrently, thumbnails are still built on demand
+        StartupPhase phase(QStringLiteral("lumas"));
+        MltConnection::refreshLumas();
+    }
+    // The asset repositories only depend on MLT, parse them on the thread pool while the profiles and widgets
+    // are set up. The first use of a repository from the GUI waits for its construction to finish.
+    StartupProfiler::runConcurrently(QStringLiteral("effects"), [] { EffectsRepository::get(); });
+    StartupProfiler::runConcurrently(QStringLiteral("transitions"), [] { TransitionsRepository::get(); });
+    {
+        StartupPhase phase(QStringLiteral("profiles"));
+        pCore->setCurrentProfile(defaultProfile.isEmpty() ? ProjectManager::getDefaultProjectFormat() : defaultProfile);
+    }
     m_commandStack = new QUndoGroup();
 
     // If using a custom profile, make sure the file exists or fallback to default
@@ -2406,17 +2427,40 @@ void MainWindow::slotCheckRenderStatus()
         m_renderWidget->missingClips(pCore->bin()->hasMissingClips());*/
 }
 
+void MainWindow::updateRenderProgress()
+{
+    // Several jobs can run at the same time, show their average progress
+    if (m_renderProgress.isEmpty()) {
+        Q_EMIT setRenderProgress(100);
+        return;
+    }
+    int total = 0;
+    for (int progress : qAsConst(m_renderProgress)) {
+        total += progress;
+    }
+    Q_EMIT setRenderProgress(total / m_renderProgress.count());
+}
+
 void MainWindow::setRenderingProgress(const QString &url, int progress, int frame)
 {
-    Q_EMIT setRenderProgress(progress);
+    m_renderProgress.insert(url, progress);
+    updateRenderProgress();
     if (m_renderWidget) {
         m_renderWidget->setRenderProgress(url, progress, frame);
     }
 }
 
+void MainWindow::setRenderingTelemetry(const QString &url, const QString &telemetry)
+{
+    if (m_renderWidget) {
+        m_renderWidget->setRenderTelemetry(url, QJsonDocument::fromJson(telemetry.toUtf8()).object());
+    }
+}
+
 void MainWindow::setRenderingFinished(const QString &url, int status, const QString &error)
 {
-    Q_EMIT setRenderProgress(100);
+    m_renderProgress.remove(url);
+    updateRenderProgress();
     if (m_renderWidget) {
         m_renderWidget->setRenderStatus(url, status, error);
     }
@@ -2559,6 +2603,9 @@ void MainWindow::connectDocument()
     }
 
     m_commandStack->setActiveStack(project->commandStack().get());
+    connect(project->commandStack().get(), &DocUndoStack::memoryUsageChanged, m_undoView, [this](qint64 bytes) {
+        m_undoView->setToolTip(i18n("Estimated memory used by the undo history: %1", KIO::convertSize(KIO::filesize_t(bytes))));
+    });
     m_timelineTabs->updateWindowTitle();
     setWindowModified(project->isModified());
     m_saveAction->setEnabled(project->isModified());
@@ -4798,6 +4845,9 @@ void MainWindow::slotCopyDebugInfo()
     }
     debuginfo.append(QStringLiteral("Movit (GPU): %1\n").arg(KdenliveSettings::gpu_accel() ? QStringLiteral("enabled") : QStringLiteral("disabled")));
     debuginfo.append(QStringLiteral("Track Compositing: %1\n").arg(TransitionsRepository::get()->getCompositingTransition()));
+    if (pCore->currentDoc()) {
+        debuginfo.append(pCore->currentDoc()->commandStack()->memoryReport());
+    }
     QClipboard *clipboard = QApplication::clipboard();
     clipboard->setText(debuginfo);
 }
@@ -5018,6 +5068,8 @@ void MainWindow::processRestoreState(const QByteArray &state)
 
 void MainWindow::checkMaxCacheSize()
 {
+    // Enforce the cache budgets in the background, this doesn't need to walk the cache folders once they are indexed
+    CacheManager::get()->start();
     if (KdenliveSettings::lastCacheCheck().daysTo(QDateTime::currentDateTime()) < 14) {
         return;
     }
@@ -277,6 +277,9 @@ private:
     QShortcut *m_shortcutRemoveFocus;
 
     RenderWidget *m_renderWidget{nullptr};
+    /** Progress of the running render jobs, by output url */
+    QMap<QString, int> m_renderProgress;
+    void updateRenderProgress();
     StatusBarMessageLabel *m_messageLabel{nullptr};
     QList<QAction *> m_transitions;
     QAction *m_buttonAudioThumbs;
@@ -343,6 +346,7 @@ private:
 public Q_SLOTS:
     void slotReloadEffects(const QStringList &paths);
     Q_SCRIPTABLE void setRenderingProgress(const QString &url, int progress, int frame);
+    Q_SCRIPTABLE void setRenderingTelemetry(const QString &url, const QString &telemetry);
     Q_SCRIPTABLE void setRenderingFinished(const QString &url, int status, const QString &error);
     Q_SCRIPTABLE void addProjectClip(const QString &url, const QString &folder = QStringLiteral("-1"));
     Q_SCRIPTABLE void addTimelineClip(const QString &url);
@@ -12,7 +12,10 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <KLocalizedString>
 #include <KUrlRequester>
 #include <KUrlRequesterDialog>
-#include <QtConcurrent>
+#include <QApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QStandardPaths>
 
 #include <clocale>
 #include <lib/localeHandling.h>
@@ -49,6 +52,8 @@ static void mlt_log_handler(void *service, int mlt_level, const char *format, va
 }
 
 std::unique_ptr<MltConnection> MltConnection::m_self;
+bool MltConnection::m_lumasLoaded = false;
+
 MltConnection::MltConnection(const QString &mltPath)
 {
     // Disable VDPAU that crashes in multithread environment.
@@ -78,7 +83,6 @@ MltConnection::MltConnection(const QString &mltPath)
     KdenliveSettings::setProducerslist(producersList);
     mlt_log_set_level(MLT_LOG_WARNING);
     mlt_log_set_callback(mlt_log_handler);
-    refreshLumas();
 }
 
 void MltConnection::construct(const QString &mltPath)
@@ -263,6 +267,7 @@ void MltConnection::refreshLumas()
     // Check for Kdenlive installed luma files, add empty string at start for no luma
     if (qEnvironmentVariableIsSet("MLT_TESTS")) {
         // No need for luma list / thumbs in tests
+        m_lumasLoaded = true;
         return;
     }
     QStringList fileFilters;
@@ -276,7 +281,6 @@ void MltConnection::refreshLumas()
     QStringList ntscLumas;
     QStringList verticalLumas;
     QStringList squareLumas;
-    QStringList allImagefiles;
     for (const QString &folder : qAsConst(customLumas)) {
         QDir topDir(folder);
         QStringList folders = topDir.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
@@ -306,7 +310,6 @@ void MltConnection::refreshLumas()
             } else if (f == QLatin1String("SQUARE")) {
                 squareLumas << imagefiles;
             }
-            allImagefiles << imagefiles;
         }
     }
     // Insert MLT builtin lumas (created on the fly)
@@ -325,10 +328,13 @@ void MltConnection::refreshLumas()
     MainWindow::m_lumaFiles.insert(QStringLiteral("square"), squareLumas);
     MainWindow::m_lumaFiles.insert(QStringLiteral("PAL"), sdLumas);
     MainWindow::m_lumaFiles.insert(QStringLiteral("NTSC"), ntscLumas);
-    allImagefiles.removeDuplicates();
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    QtConcurrent::run(pCore.get(), &Core::buildLumaThumbs, allImagefiles);
-#else
-    (void)QtConcurrent::run(&Core::buildLumaThumbs, pCore.get(), allImagefiles);
-#endif
+    m_lumasLoaded = true;
+}
+
+QStringList MltConnection::lumaFiles(const QString &format)
+{
+    if (!m_lumasLoaded) {
+        refreshLumas();
+    }
+    return MainWindow::m_lumaFiles.value(format);
 }
@@ -34,6 +34,11 @@ public:
      */
     static void refreshLumas();
 
+    /** @brief Returns the luma files available for a frame format (16_9, 9_16, square, PAL or NTSC).
+     *  The luma folders are scanned at startup, before the asset repositories are loaded concurrently.
+     */
+    static QStringList lumaFiles(const QString &format);
+
 protected:
     /** @brief Open connection to the MLT framework
         This constructor should be called only once
@@ -49,6 +54,7 @@ protected:
     void locateMeltAndProfilesPath(const QString &mltPath = QString());
 
     static std::unique_ptr<MltConnection> m_self;
+    static bool m_lumasLoaded;
 
     /** @brief The MLT repository, useful for filter/producer requests */
     std::unique_ptr<Mlt::Repository> m_repository;
@@ -34,6 +34,7 @@
 #include "profiles/profilemodel.hpp"
 #include "timeline2/view/qml/timelineitems.h"
 #include "timeline2/view/qmltypes/thumbnailprovider.h"
+#include "utils/tracing.hpp"
 #include <lib/localeHandling.h>
 #include <mlt++/Mlt.h>
 
@@ -1379,6 +1380,9 @@ void VideoWidget::on_frame_show(mlt_consumer, VideoWidget *widget, mlt_event_dat
 {
     auto frame = Mlt::EventData(data).to_frame();
     if (frame.is_valid() && frame.get_int("rendered")) {
+        if (Tracing::isEnabled()) {
+            Tracing::instant("monitor", "frame rendered", QString::number(frame.get_position()));
+        }
         int timeout = (widget->consumer()->get_int("real_time") > 0) ? 0 : 1000;
         if ((widget->m_frameRenderer != nullptr) && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
             QMetaObject::invokeMethod(widget->m_frameRenderer, "showFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
@@ -1390,6 +1394,9 @@ void VideoWidget::on_gl_nosync_frame_show(mlt_consumer, VideoWidget *widget, mlt
 {
     auto frame = Mlt::EventData(data).to_frame();
     if (frame.get_int("rendered") != 0) {
+        if (Tracing::isEnabled()) {
+            Tracing::instant("monitor", "frame rendered", QString::number(frame.get_position()));
+        }
         int timeout = (widget->consumer()->get_int("real_time") > 0) ? 0 : 1000;
         if ((widget->m_frameRenderer != nullptr) && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
             QMetaObject::invokeMethod(widget->m_frameRenderer, "showGLNoSyncFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
@@ -1401,6 +1408,9 @@ void VideoWidget::on_gl_frame_show(mlt_consumer, VideoWidget *widget, mlt_event_
 {
     auto frame = Mlt::EventData(data).to_frame();
     if (frame.get_int("rendered") != 0) {
+        if (Tracing::isEnabled()) {
+            Tracing::instant("monitor", "frame rendered", QString::number(frame.get_position()));
+        }
         int timeout = (widget->consumer()->get_int("real_time") > 0) ? 0 : 1000;
         if ((widget->m_frameRenderer != nullptr) && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
             QMetaObject::invokeMethod(widget->m_frameRenderer, "showGLFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
@@ -1478,6 +1488,7 @@ FrameRenderer::~FrameRenderer()
 
 void FrameRenderer::showFrame(Mlt::Frame frame)
 {
+    TRACE_SCOPE("monitor", "show frame");
     // Save this frame for future use and to keep a reference to the GL Texture.
     m_displayFrame = SharedFrame(frame);
 
@@ -1504,6 +1515,7 @@ void FrameRenderer::showFrame(Mlt::Frame frame)
 
 void FrameRenderer::showGLFrame(Mlt::Frame frame)
 {
+    TRACE_SCOPE("monitor", "show frame");
     if ((m_context != nullptr) && m_context->isValid()) {
         m_context->makeCurrent(m_surface);
         pipelineSyncToFrame(frame);
@@ -1522,6 +1534,7 @@ void FrameRenderer::showGLFrame(Mlt::Frame frame)
 
 void FrameRenderer::showGLNoSyncFrame(Mlt::Frame frame)
 {
+    TRACE_SCOPE("monitor", "show frame");
     if ((m_context != nullptr) && m_context->isValid()) {
 
         frame.set("movit.convert.use_texture", 1);
@@ -47,6 +47,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "timeline2/view/timelinewidget.h"
 #include "transitions/transitionsrepository.hpp"
 #include "utils/thumbnailcache.hpp"
+#include "utils/tracing.hpp"
 
 #include "KLocalizedString"
 #include <KActionMenu>
@@ -2293,6 +2294,7 @@ void Monitor::updateAudioForAnalysis()
 
 void Monitor::onFrameDisplayed(const SharedFrame &frame)
 {
+    TRACE_SCOPE("monitor", "frame displayed");
     Q_EMIT m_monitorManager->frameDisplayed(frame);
     if (m_id == Kdenlive::ProjectMonitor) {
         Q_EMIT pCore->updateMixerLevels(frame.get_position());
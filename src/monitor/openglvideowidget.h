@@ -9,7 +9,6 @@
 
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
-#include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions>
 #include <QOpenGLShaderProgram>
 
@@ -40,7 +39,6 @@ private:
     GLint m_textureLocation[3];
     QOpenGLContext *m_quickContext;
     std::unique_ptr<QOpenGLContext> m_context;
-    QOpenGLFramebufferObject *m_fbo{nullptr};
     GLuint m_renderTexture[3];
     GLuint m_displayTexture[3];
     bool m_isThreadedOpenGL;
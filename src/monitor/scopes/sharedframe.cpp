@@ -12,6 +12,11 @@ void destroyFrame(void *p)
     delete static_cast<Mlt::Frame *>(p);
 }
 
+static void releaseImageFrame(void *p)
+{
+    delete static_cast<SharedFrame *>(p);
+}
+
 class FrameData : public QSharedData
 {
 public:
@@ -238,3 +243,19 @@ const int16_t *SharedFrame::get_audio() const
     int samples = get_audio_samples();
     return static_cast<int16_t *>(d->f.get_audio(format, frequency, channels, samples));
 }
+
+QImage SharedFrame::toImage() const
+{
+    if (!is_valid()) {
+        return QImage();
+    }
+    const uint8_t *image = get_image(mlt_image_rgba);
+    if (image == nullptr) {
+        return QImage();
+    }
+    int width = get_image_width();
+    int height = get_image_height();
+    // The image buffer is owned by the frame (or its cached conversion), so keep
+    // a reference on the frame for as long as the QImage lives.
+    return QImage(image, width, height, width * 4, QImage::Format_RGBA8888, releaseImageFrame, new SharedFrame(*this));
+}
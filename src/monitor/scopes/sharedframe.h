@@ -8,6 +8,7 @@
 #pragma once
 
 #include <QExplicitlySharedDataPointer>
+#include <QImage>
 #include <cstdint>
 #include <mlt++/MltFrame.h>
 
@@ -56,6 +57,10 @@ public:
     int get_audio_frequency() const;
     int get_audio_samples() const;
     const int16_t *get_audio() const;
+    /** @brief Returns a read-only RGBA image pointing to this frame's pixel data.
+     *  No pixels are copied: the image holds a reference on the frame until it is destroyed,
+     *  and any attempt to modify it will detach a private copy. */
+    QImage toImage() const;
 
 private:
     QExplicitlySharedDataPointer<FrameData> d; // NOLINT
@@ -37,6 +37,7 @@
 #include "profiles/profilemodel.hpp"
 #include "timeline2/view/qml/timelineitems.h"
 #include "timeline2/view/qmltypes/thumbnailprovider.h"
+#include "utils/tracing.hpp"
 #include "videowidget.h"
 #include <lib/localeHandling.h>
 #include <mlt++/Mlt.h>
@@ -76,7 +77,6 @@ VideoWidget::VideoWidget(int id, QObject *parent)
     , m_producer(nullptr)
     , m_id(id)
     , m_rulerHeight(int(QFontInfo(QFontDatabase::systemFont(QFontDatabase::SmallestReadableFont)).pixelSize() * 1.5))
-    , m_sendFrame(false)
     , m_analyseSem(1)
     , m_zoom(1.0f)
     , m_profileSize(1920, 1080)
@@ -157,30 +157,10 @@ void VideoWidget::initialize()
     m_isInitialized = true;
 }
 
-void VideoWidget::renderVideo()
-{
-#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
-    if (m_sendFrame) {
-        QImage img = image();
-        Q_EMIT analyseFrame(img);
-        m_sendFrame = false;
-    }
-#endif
-}
-
 QImage VideoWidget::image() const
 {
-    SharedFrame frame = m_frameRenderer->getDisplayFrame();
-    if (frame.is_valid()) {
-        const uint8_t *image = frame.get_image(mlt_image_rgba);
-        if (image) {
-            int width = frame.get_image_width();
-            int height = frame.get_image_height();
-            QImage temp(image, width, height, QImage::Format_RGBA8888);
-            return temp.copy();
-        }
-    }
-    return QImage();
+    // Return a deep copy so that the caller does not keep the frame alive
+    return m_frameRenderer->getDisplayFrame().toImage().copy();
 }
 
 const QStringList VideoWidget::getGPUInfo()
@@ -873,8 +853,12 @@ void VideoWidget::onFrameDisplayed(const SharedFrame &frame)
 {
     m_mutex.lock();
     m_sharedFrame = frame;
-    m_sendFrame = sendFrameForAnalysis;
     m_mutex.unlock();
+    m_frameRenderer->setAnalyseFrames(sendFrameForAnalysis);
+    // The scopes release the semaphore once they processed the previous frame
+    if (sendFrameForAnalysis && m_analyseSem.tryAcquire(1)) {
+        Q_EMIT analyseFrame(frame.toImage());
+    }
     quickWindow()->update();
 }
 
@@ -941,6 +925,9 @@ void VideoWidget::on_frame_show(mlt_consumer, VideoWidget *widget, mlt_event_dat
 {
     auto frame = Mlt::EventData(data).to_frame();
     if (frame.is_valid() && frame.get_int("rendered")) {
+        if (Tracing::isEnabled()) {
+            Tracing::instant("monitor", "frame rendered", QString::number(frame.get_position()));
+        }
         int timeout = (widget->consumer()->get_int("real_time") > 0) ? 0 : 1000;
         if ((widget->m_frameRenderer != nullptr) && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
             QMetaObject::invokeMethod(widget->m_frameRenderer, "showFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
@@ -986,6 +973,7 @@ FrameRenderer::FrameRenderer()
     : QThread(nullptr)
     , m_semaphore(3)
     , m_imageRequested(false)
+    , m_analyseFrames(false)
 {
     setObjectName(QStringLiteral("FrameRenderer"));
     moveToThread(this);
@@ -999,10 +987,20 @@ void FrameRenderer::requestImage()
     m_imageRequested = true;
 }
 
+void FrameRenderer::setAnalyseFrames(bool analyse)
+{
+    m_analyseFrames = analyse;
+}
+
 void FrameRenderer::showFrame(Mlt::Frame frame)
 {
+    TRACE_SCOPE("monitor", "show frame");
     // Save this frame for future use and to keep a reference to the GL Texture.
     m_displayFrame = SharedFrame(frame);
+    if (m_analyseFrames) {
+        // Convert to RGBA now, the result is cached in the frame and reused by the analysis image
+        m_displayFrame.get_image(mlt_image_rgba);
+    }
     Q_EMIT frameDisplayed(m_displayFrame);
     if (m_imageRequested) {
         m_imageRequested = false;
@@ -18,6 +18,8 @@
 #include <QThread>
 #include <QTimer>
 
+#include <atomic>
+
 #include "bin/model/markerlistmodel.hpp"
 #include "definitions.h"
 #include "kdenlivesettings.h"
@@ -143,7 +145,7 @@ protected:
 public Q_SLOTS:
     virtual void initialize();
     virtual void beforeRendering(){};
-    virtual void renderVideo();
+    virtual void renderVideo(){};
     virtual void onFrameDisplayed(const SharedFrame &frame);
     void requestSeek(int position, bool noAudioScrub = false);
     void setZoom(float zoom, bool force = false);
@@ -174,6 +176,7 @@ Q_SIGNALS:
     void switchFullScreen(bool minimizeOnly = false);
     void mouseSeek(int eventDelta, uint modifiers);
     void startDrag();
+    /** @brief Emitted with a read-only image sharing the displayed frame's pixels (see SharedFrame::toImage()) */
     void analyseFrame(const QImage &);
     void showContextMenu(const QPoint &);
     void lockMonitor(bool);
@@ -196,7 +199,6 @@ protected:
     /** @brief For some reason on Qt6 fullscreen switch, image position is not correctly updated, so use this to track state */
     bool refreshZoom{false};
     SharedFrame m_sharedFrame;
-    bool m_sendFrame;
     QSemaphore m_analyseSem;
     float m_zoom;
     QSize m_profileSize;
@@ -290,6 +292,8 @@ public:
     SharedFrame getDisplayFrame();
     Q_INVOKABLE void showFrame(Mlt::Frame frame);
     void requestImage();
+    /** @brief When enabled, the RGBA conversion used for frame analysis is done in this thread */
+    void setAnalyseFrames(bool analyse);
     QImage image() const { return m_image; }
 
 Q_SIGNALS:
@@ -300,5 +304,6 @@ private:
     QSemaphore m_semaphore;
     SharedFrame m_displayFrame;
     bool m_imageRequested;
+    std::atomic_bool m_analyseFrames;
     QImage m_image;
 };
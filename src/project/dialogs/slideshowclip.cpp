@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "core.h"
 #include "kdenlivesettings.h"
 #include "mainwindow.h"
+#include "mltconnection.h"
 
 #include <KFileItem>
 #include <KLocalizedString>
@@ -134,17 +135,18 @@ SlideshowClip::SlideshowClip(const Timecode &tc, QString clipFolder, ProjectClip
     QStringList values;
     if (pCore->getCurrentFrameSize().width() > 1000) {
         // HD project
-        values = MainWindow::m_lumaFiles.value(QStringLiteral("16_9"));
+        values = MltConnection::lumaFiles(QStringLiteral("16_9"));
     } else if (pCore->getCurrentFrameSize().height() > 1000) {
-        values = MainWindow::m_lumaFiles.value(QStringLiteral("9_16"));
+        values = MltConnection::lumaFiles(QStringLiteral("9_16"));
     } else if (pCore->getCurrentFrameSize().height() == pCore->getCurrentFrameSize().width()) {
-        values = MainWindow::m_lumaFiles.value(QStringLiteral("square"));
+        values = MltConnection::lumaFiles(QStringLiteral("square"));
     } else if (pCore->getCurrentFrameSize().height() == 480) {
-        values = MainWindow::m_lumaFiles.value(QStringLiteral("NTSC"));
+        values = MltConnection::lumaFiles(QStringLiteral("NTSC"));
     } else {
-        values = MainWindow::m_lumaFiles.value(QStringLiteral("PAL"));
+        values = MltConnection::lumaFiles(QStringLiteral("PAL"));
     }
     values.removeDuplicates();
+    pCore->buildLumaThumbs(values);
 
     QStringList names;
     for (const QString &value : qAsConst(values)) {
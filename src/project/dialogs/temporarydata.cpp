@@ -10,6 +10,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "core.h"
 #include "doc/kdenlivedoc.h"
 #include "kdenlivesettings.h"
+#include "utils/cachemanager.hpp"
 
 #include <KLocalizedString>
 #include <KMessageBox>
@@ -355,6 +356,7 @@ void TemporaryData::deletePreview()
     }
     if (dir.dirName() == QLatin1String("preview")) {
         dir.removeRecursively();
+        CacheManager::get()->recordFolderRemoval(dir.absolutePath());
         dir.mkpath(QStringLiteral("."));
         Q_EMIT disablePreview();
         updateDataInfo();
@@ -472,7 +474,9 @@ void TemporaryData::deleteProjectProxy()
         return;
     }
     for (const QString &file : qAsConst(files)) {
-        dir.remove(file);
+        if (dir.remove(file)) {
+            CacheManager::get()->recordRemoval(dir.absoluteFilePath(file));
+        }
     }
     Q_EMIT disableProxies();
     updateDataInfo();
@@ -492,6 +496,7 @@ void TemporaryData::deleteAudio()
     }
     if (dir.dirName() == QLatin1String("audiothumbs")) {
         dir.removeRecursively();
+        CacheManager::get()->recordFolderRemoval(dir.absolutePath());
         dir.mkpath(QStringLiteral("."));
         updateDataInfo();
     }
@@ -511,6 +516,7 @@ void TemporaryData::deleteThumbs()
     }
     if (dir.dirName() == QLatin1String("videothumbs")) {
         dir.removeRecursively();
+        CacheManager::get()->recordFolderRemoval(dir.absolutePath());
         dir.mkpath(QStringLiteral("."));
         updateDataInfo();
     }
@@ -532,6 +538,7 @@ void TemporaryData::deleteCurrentCacheData(bool warn)
         Q_EMIT disablePreview();
         Q_EMIT disableProxies();
         dir.removeRecursively();
+        CacheManager::get()->recordFolderRemoval(dir.absolutePath());
         m_doc->initCacheDirs();
         if (warn) {
             updateDataInfo();
@@ -733,6 +740,7 @@ void TemporaryData::deleteCache(QStringList &folders)
         }
         QDir toRemove(m_globalDir.filePath(folder));
         toRemove.removeRecursively();
+        CacheManager::get()->recordFolderRemoval(toRemove.absolutePath());
     }
     updateGlobalInfo();
 }
@@ -749,6 +757,7 @@ void TemporaryData::deleteProxy()
     }
     QDir toRemove(m_globalDir.filePath(QStringLiteral("proxy")));
     toRemove.removeRecursively();
+    CacheManager::get()->recordFolderRemoval(toRemove.absolutePath());
     // We deleted proxy folder, recreate it
     toRemove.mkpath(QStringLiteral("."));
     processProxyDirectory();
@@ -780,7 +789,9 @@ void TemporaryData::cleanProxy()
         return;
     }
     for (const QString &f : qAsConst(oldFiles)) {
-        proxies.remove(f);
+        if (proxies.remove(f)) {
+            CacheManager::get()->recordRemoval(proxies.absoluteFilePath(f));
+        }
     }
     processProxyDirectory();
 }
@@ -0,0 +1,285 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "headlessbatch.h"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "doc/kdenlivedoc.h"
+#include "jobs/audiolevelstask.h"
+#include "jobs/cachetask.h"
+#include "jobs/proxytask.h"
+#include "kdenlive_debug.h"
+#include "kdenlivesettings.h"
+#include "project/projectmanager.h"
+#include "timeline2/view/previewmanager.h"
+
+#include <KLocalizedString>
+#include <QDirIterator>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTimer>
+#include <cstdlib>
+
+namespace {
+/** @brief Number of chunks in a compressed list like "0-500,525" */
+int chunkCount(const QStringList &chunks)
+{
+    return ChunkSet::fromString(chunks.join(QLatin1Char(',')), KdenliveSettings::timelinechunks()).count();
+}
+} // namespace
+
+bool HeadlessBatch::parseJobs(const QString &list, Jobs &jobs, QString &error)
+{
+    jobs = NoJob;
+    const QStringList names = list.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString &name : names) {
+        const QString job = name.trimmed().toLower();
+        if (job == QLatin1String("proxy")) {
+            jobs |= ProxyJob;
+        } else if (job == QLatin1String("audio")) {
+            jobs |= AudioLevelsJob;
+        } else if (job == QLatin1String("thumbs")) {
+            jobs |= ThumbnailsJob;
+        } else if (job == QLatin1String("preview")) {
+            jobs |= PreviewJob;
+        } else if (job == QLatin1String("all")) {
+            jobs |= ProxyJob | AudioLevelsJob | ThumbnailsJob | PreviewJob;
+        } else if (job != QLatin1String("none")) {
+            error = i18n("Unknown batch job %1, use proxy, audio, thumbs, preview, all or none.", job);
+            return false;
+        }
+    }
+    return true;
+}
+
+void HeadlessBatch::startPhase()
+{
+    m_timer.start();
+}
+
+void HeadlessBatch::endPhase(const QString &name, int count)
+{
+    m_phases.append({name, m_timer.elapsed(), count});
+}
+
+void HeadlessBatch::waitForTasks()
+{
+    QEventLoop loop;
+    QTimer poll;
+    poll.setInterval(100);
+    // Finished tasks can trigger new ones from the event loop (for example a clip reload after a proxy is created),
+    // so only stop when the queue stayed empty for a full interval
+    int idle = 0;
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&loop, &idle]() {
+        if (pCore->taskManager.pendingTaskCount() > 0) {
+            idle = 0;
+        } else if (++idle > 1) {
+            loop.quit();
+        }
+    });
+    poll.start();
+    loop.exec();
+}
+
+int HeadlessBatch::startClipJobs(Job job)
+{
+    int count = 0;
+    const std::vector<QString> ids = pCore->projectItemModel()->getAllClipIds();
+    for (const QString &id : ids) {
+        std::shared_ptr<ProjectClip> clip = pCore->projectItemModel()->getClipByBinID(id);
+        if (!clip || !clip->statusReady()) {
+            continue;
+        }
+        ObjectId oid(KdenliveObjectType::BinClip, id.toInt(), QUuid());
+        switch (job) {
+        case ProxyJob:
+            // Only create the proxies that are configured in the project but missing on this machine
+            if (clip->hasProxy()) {
+                const QString proxy = clip->getProducerProperty(QStringLiteral("kdenlive:proxy"));
+                const QFileInfo info(proxy);
+                if (!info.exists() || info.size() == 0) {
+                    ProxyTask::start(oid, clip.get(), true);
+                    count++;
+                }
+            }
+            break;
+        case AudioLevelsJob:
+            if (clip->audioChannels() > 0 && !clip->audioThumbCreated()) {
+                AudioLevelsTask::start(oid, clip.get(), true);
+                count++;
+            }
+            break;
+        case ThumbnailsJob:
+            if (clip->clipType() != ClipType::Audio && clip->clipType() != ClipType::Timeline) {
+                CacheTask::start(oid, 30, 0, 0, clip.get());
+                count++;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return count;
+}
+
+int HeadlessBatch::renderPreview()
+{
+    std::shared_ptr<TimelineItemModel> timeline = pCore->projectManager()->getTimeline();
+    if (!timeline) {
+        return 0;
+    }
+    if (!timeline->hasTimelinePreview()) {
+        timeline->initializePreviewManager();
+    }
+    std::shared_ptr<PreviewManager> preview = timeline->previewManager();
+    if (!preview) {
+        qCWarning(KDENLIVE_LOG) << "Cannot initialize the timeline preview";
+        return 0;
+    }
+    if (!preview->hasPreviewTrack() && !preview->buildPreviewTrack()) {
+        return 0;
+    }
+    if (!preview->hasDefinedRange()) {
+        preview->addPreviewRange(QPoint(0, timeline->duration() - 1), true);
+    }
+    const int dirty = chunkCount(preview->previewChunks().second);
+    if (dirty == 0) {
+        return 0;
+    }
+    preview->startPreviewRender();
+    QEventLoop loop;
+    QTimer poll;
+    poll.setInterval(100);
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&loop, preview]() {
+        if (!preview->isRunning()) {
+            loop.quit();
+        }
+    });
+    poll.start();
+    loop.exec();
+    return dirty - chunkCount(preview->previewChunks().second);
+}
+
+QMap<QString, HeadlessBatch::CacheUsage> HeadlessBatch::cacheUsage()
+{
+    QMap<QString, CacheUsage> result;
+    const QMap<QString, CacheType> folders = {{QStringLiteral("proxy"), CacheProxy},
+                                              {QStringLiteral("audio"), CacheAudio},
+                                              {QStringLiteral("thumbs"), CacheThumbs},
+                                              {QStringLiteral("preview"), CachePreview}};
+    for (auto it = folders.constBegin(); it != folders.constEnd(); ++it) {
+        bool ok;
+        const QDir dir = pCore->currentDoc()->getCacheDir(it.value(), &ok);
+        CacheUsage usage;
+        if (ok) {
+            QDirIterator files(dir.absolutePath(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+            while (files.hasNext()) {
+                files.next();
+                usage.files++;
+                usage.bytes += files.fileInfo().size();
+            }
+        }
+        result.insert(it.key(), usage);
+    }
+    return result;
+}
+
+int HeadlessBatch::run(const QUrl &url)
+{
+    if (m_threads > 0) {
+        pCore->taskManager.setMaxThreadCount(m_threads);
+    }
+    int exitCode = EXIT_SUCCESS;
+    startPhase();
+    pCore->projectManager()->doOpenFileHeadless(url);
+    if (pCore->currentDoc() == nullptr) {
+        qCritical() << "Cannot open project" << url.toLocalFile();
+        return EXIT_FAILURE;
+    }
+    endPhase(QStringLiteral("open project"), 1);
+
+    startPhase();
+    waitForTasks();
+    endPhase(QStringLiteral("load clips"), int(pCore->projectItemModel()->getAllClipIds().size()));
+    const QMap<QString, CacheUsage> before = cacheUsage();
+
+    const QVector<QPair<Job, QString>> clipJobs = {
+        {ProxyJob, QStringLiteral("proxies")}, {AudioLevelsJob, QStringLiteral("audio levels")}, {ThumbnailsJob, QStringLiteral("thumbnails")}};
+    for (const auto &job : clipJobs) {
+        if (m_jobs.testFlag(job.first)) {
+            startPhase();
+            int count = startClipJobs(job.first);
+            waitForTasks();
+            endPhase(job.second, count);
+        }
+    }
+    if (m_jobs.testFlag(PreviewJob)) {
+        startPhase();
+        int count = renderPreview();
+        endPhase(QStringLiteral("timeline preview"), count);
+    }
+    if (!m_savePath.isEmpty()) {
+        startPhase();
+        if (!pCore->projectManager()->testSaveFileAs(m_savePath)) {
+            qCritical() << "Cannot save project to" << m_savePath;
+            exitCode = EXIT_FAILURE;
+        }
+        endPhase(QStringLiteral("save project"), 1);
+    }
+    report(before, cacheUsage());
+    pCore->projectManager()->closeCurrentDocument(false, false);
+    return exitCode;
+}
+
+void HeadlessBatch::report(const QMap<QString, CacheUsage> &before, const QMap<QString, CacheUsage> &after) const
+{
+    QTextStream out(stdout);
+    QJsonArray phases;
+    qint64 total = 0;
+    out << "Phase                      Time (ms)    Items\n";
+    for (const Phase &p : m_phases) {
+        out << QStringLiteral("%1 %2 %3\n").arg(p.name, -24).arg(p.duration, 12).arg(p.count, 8);
+        total += p.duration;
+        QJsonObject obj;
+        obj.insert(QLatin1String("name"), p.name);
+        obj.insert(QLatin1String("duration"), p.duration);
+        obj.insert(QLatin1String("count"), p.count);
+        phases.append(obj);
+    }
+    out << QStringLiteral("%1 %2\n\n").arg(QStringLiteral("total"), -24).arg(total, 12);
+    QJsonObject caches;
+    out << "Cache         Files        Size (bytes)    New files\n";
+    for (auto it = after.constBegin(); it != after.constEnd(); ++it) {
+        const CacheUsage previous = before.value(it.key());
+        out << QStringLiteral("%1 %2 %3 %4\n").arg(it.key(), -10).arg(it->files, 8).arg(it->bytes, 19).arg(it->files - previous.files, 12);
+        QJsonObject obj;
+        obj.insert(QLatin1String("files"), it->files);
+        obj.insert(QLatin1String("bytes"), it->bytes);
+        obj.insert(QLatin1String("newFiles"), it->files - previous.files);
+        obj.insert(QLatin1String("newBytes"), it->bytes - previous.bytes);
+        caches.insert(it.key(), obj);
+    }
+    out.flush();
+    if (m_reportPath.isEmpty()) {
+        return;
+    }
+    QJsonObject json;
+    json.insert(QLatin1String("total"), total);
+    json.insert(QLatin1String("phases"), phases);
+    json.insert(QLatin1String("caches"), caches);
+    QSaveFile file(m_reportPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KDENLIVE_LOG) << "Cannot write batch report to" << m_reportPath;
+        return;
+    }
+    file.write(QJsonDocument(json).toJson());
+    file.commit();
+}
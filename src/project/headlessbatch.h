@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "definitions.h"
+
+#include <QElapsedTimer>
+#include <QFlags>
+#include <QMap>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+
+/** @class HeadlessBatch
+    @brief Opens a project without the GUI, runs clip jobs on it to completion and reports the time spent in each phase.
+    This is used from the command line (--batch) to precompute proxies, audio levels, thumbnails and timeline preview
+    on a render node, or to measure load and save times in continuous integration.
+ */
+class HeadlessBatch
+{
+public:
+    enum Job { NoJob = 0x0, ProxyJob = 0x1, AudioLevelsJob = 0x2, ThumbnailsJob = 0x4, PreviewJob = 0x8 };
+    Q_DECLARE_FLAGS(Jobs, Job)
+
+    HeadlessBatch() = default;
+
+    /** @brief Parse a comma separated list of jobs: proxy, audio, thumbs, preview, all or none.
+     *  @returns false if the list contains an unknown job, stored in @p error
+     */
+    static bool parseJobs(const QString &list, Jobs &jobs, QString &error);
+
+    void setJobs(Jobs jobs) { m_jobs = jobs; }
+    /** @brief Maximum number of jobs running at the same time, 0 to keep the default */
+    void setConcurrency(int threads) { m_threads = threads; }
+    /** @brief Save a copy of the project to this file after the jobs, to measure the save time */
+    void setSaveCopy(const QString &path) { m_savePath = path; }
+    /** @brief Also write the report to this file as JSON */
+    void setReportFile(const QString &path) { m_reportPath = path; }
+
+    /** @brief Open the project, run the jobs, print the report and close the project.
+     *  The Core must be built in headless mode. Returns the process exit code.
+     */
+    int run(const QUrl &url);
+
+private:
+    struct Phase
+    {
+        QString name;
+        qint64 duration;
+        int count;
+    };
+    struct CacheUsage
+    {
+        qint64 files = 0;
+        qint64 bytes = 0;
+    };
+    Jobs m_jobs{NoJob};
+    int m_threads{0};
+    QString m_savePath;
+    QString m_reportPath;
+    QVector<Phase> m_phases;
+    QElapsedTimer m_timer;
+
+    /** @brief Start measuring a new phase */
+    void startPhase();
+    /** @brief Store the duration of the current phase */
+    void endPhase(const QString &name, int count);
+    /** @brief Run the event loop until all the tasks of the TaskManager are done */
+    static void waitForTasks();
+    /** @brief Start a job for each clip of the project, returns the number of started jobs */
+    static int startClipJobs(Job job);
+    /** @brief Render the dirty timeline preview chunks, or the whole timeline if no preview zone is defined */
+    static int renderPreview();
+    static QMap<QString, CacheUsage> cacheUsage();
+    void report(const QMap<QString, CacheUsage> &before, const QMap<QString, CacheUsage> &after) const;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(HeadlessBatch::Jobs)
@@ -22,8 +22,10 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "project/dialogs/noteswidget.h"
 #include "project/dialogs/projectsettings.h"
 #include "timeline2/model/timelinefunctions.hpp"
+#include "utils/cachemanager.hpp"
 #include "utils/qstringutils.h"
 #include "utils/thumbnailcache.hpp"
+#include "utils/tracing.hpp"
 #include "xml/xml.hpp"
 #include <audiomixer/mixermanager.hpp>
 #include <bin/clipcreator.hpp>
@@ -268,6 +270,10 @@ void ProjectManager::newFile(QString profileName, bool showProjectSettings)
     doc->m_sameProjectFolder = sameProjectFolder;
     ThumbnailCache::get()->clearCache();
     m_project = doc;
+    // The cached data of the open project is never deleted
+    bool cacheOk;
+    const QDir projectCache = m_project->getCacheDir(CacheBase, &cacheOk);
+    CacheManager::get()->setDocumentFolder(cacheOk ? projectCache.absolutePath() : QString());
     initSequenceProperties(m_project->uuid(), {KdenliveSettings::audiotracks(), KdenliveSettings::videotracks()});
     updateTimeline(true, QString(), QString(), QDateTime(), 0);
     pCore->window()->connectDocument();
@@ -900,6 +906,10 @@ void ProjectManager::doOpenFile(const QUrl &url, KAutoSaveFile *stale, bool isBa
 
     // Set default target tracks to upper audio / lower video tracks
     m_project = doc;
+    // The cached data of the open project is never deleted
+    bool cacheOk;
+    const QDir projectCache = m_project->getCacheDir(CacheBase, &cacheOk);
+    CacheManager::get()->setDocumentFolder(cacheOk ? projectCache.absolutePath() : QString());
     m_mltWarnings.clear();
     connect(pCore.get(), &Core::mltWarning, this, &ProjectManager::handleLog, Qt::QueuedConnection);
     pCore->monitorManager()->projectMonitor()->locked = true;
@@ -1463,6 +1473,7 @@ void ProjectManager::requestBackup(const QString &errorMessage)
 
 bool ProjectManager::updateTimeline(bool createNewTab, const QString &chunks, const QString &dirty, const QDateTime &documentDate, bool enablePreview)
 {
+    TRACE_SCOPE("io", "build timeline");
     pCore->taskManager.slotCancelJobs();
     const QUuid uuid = m_project->uuid();
     QReadLocker lock(&pCore->xmlMutex);
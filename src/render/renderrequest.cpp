@@ -14,6 +14,7 @@
 #include "xml/xml.hpp"
 
 #include <QTemporaryFile>
+#include <QThread>
 
 // TODO: remove, see generatePlaylistFile()
 #include <KMessageBox>
@@ -30,9 +31,47 @@ QStringList RenderRequest::argsByJob(const RenderJob &job)
     if (!job.subtitlePath.isEmpty()) {
         args << QStringLiteral("--subtitle") << job.subtitlePath;
     }
+    if (job.audioStems) {
+        args << QStringLiteral("--audio-stems");
+    }
     return args;
 }
 
+RenderRequest::RenderCost RenderRequest::estimateCost(const QString &playlistPath)
+{
+    const int idealThreads = QThread::idealThreadCount();
+    // Without information, make sure the job runs alone
+    RenderCost cost{idealThreads, 0};
+    QFile file(playlistPath);
+    QDomDocument doc;
+    if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file, false)) {
+        return cost;
+    }
+    QDomElement consumer = doc.documentElement().firstChildElement(QStringLiteral("consumer"));
+    if (consumer.isNull()) {
+        return cost;
+    }
+    if (doc.documentElement().attribute(QStringLiteral("producer")) == QLatin1String("kdenlive_audio_stems") ||
+        consumer.attribute(QStringLiteral("vn")) == QLatin1String("1") || consumer.attribute(QStringLiteral("video_off")) == QLatin1String("1")) {
+        // Audio only
+        cost.threads = 1;
+        cost.memory = 100;
+        return cost;
+    }
+    // Encoder threads, 0 lets the encoder use all the processors, and MLT processing threads (negative real_time)
+    int threads = consumer.attribute(QStringLiteral("threads")).toInt();
+    if (threads > 0) {
+        threads += qMax(1, qAbs(consumer.attribute(QStringLiteral("real_time")).toInt()));
+        cost.threads = qMin(threads, idealThreads);
+    }
+    QDomElement profile = doc.documentElement().firstChildElement(QStringLiteral("profile"));
+    int width = consumer.attribute(QStringLiteral("width"), profile.attribute(QStringLiteral("width"))).toInt();
+    int height = consumer.attribute(QStringLiteral("height"), profile.attribute(QStringLiteral("height"))).toInt();
+    // Base usage plus the frames queued in the consumer and encoder, in RGBA
+    cost.memory = 200 + int(qint64(width) * height * 4 * 64 / 1024 / 1024);
+    return cost;
+}
+
 RenderRequest::RenderRequest()
 {
     setBounds(-1, -1);
@@ -231,7 +270,7 @@ void RenderRequest::createRenderJobs(std::vector<RenderJob> &jobs, const QDomDoc
         if (m_delayedRendering) {
             addErrorMessage(i18n("Script rendering and multi track audio export can not be used together. Script will be saved without multi track export."));
         } else {
-            prepareMultiAudioFiles(jobs, doc, playlistPath, outputPath, uuid);
+            prepareAudioStems(jobs, doc, playlistPath, outputPath, uuid);
         }
     }
 
@@ -442,84 +481,103 @@ std::vector<RenderRequest::RenderSection> RenderRequest::getGuideSections()
     return sections;
 }
 
-void RenderRequest::prepareMultiAudioFiles(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistFile, const QString &targetFile,
-                                           const QUuid &uuid)
+void RenderRequest::prepareAudioStems(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistFile, const QString &targetFile,
+                                      const QUuid &uuid)
 {
-    int audioCount = 0;
     QDomNodeList orginalTractors = doc.elementsByTagName(QStringLiteral("tractor"));
     // process in reversed order to make file naming fit to UI
     QStringList trackIds;
-    for (int i = orginalTractors.size(); i >= 0; i--) {
+    QStringList mutedIds;
+    for (int i = orginalTractors.size() - 1; i >= 0; i--) {
         auto originalTracktor = orginalTractors.at(i).toElement();
         const QUuid tractorUuid(Xml::getXmlProperty(originalTracktor, QStringLiteral("kdenlive:uuid")));
         if (tractorUuid == uuid) {
             // We found the current timeline tractor, list its tracks
             QDomNodeList childTracks = originalTracktor.elementsByTagName(QStringLiteral("track"));
-            for (int j = childTracks.size(); j >= 0; j--) {
-                trackIds << childTracks.at(j).toElement().attribute(QStringLiteral("producer"));
+            for (int j = childTracks.size() - 1; j >= 0; j--) {
+                const QDomElement track = childTracks.at(j).toElement();
+                const QString hide = track.attribute(QStringLiteral("hide"));
+                trackIds << track.attribute(QStringLiteral("producer"));
+                if (hide == QLatin1String("audio") || hide == QLatin1String("both")) {
+                    mutedIds << trackIds.last();
+                }
             }
             break;
         }
     }
+    auto wavFile = [targetFile](const QString &appendix) {
+        const QString path = QStringUtils::appendToFilename(targetFile, appendix);
+        return path.section(QLatin1Char('.'), 0, -2) + QStringLiteral(".wav");
+    };
+
+    RenderJob job;
+    job.playlistPath = QStringUtils::appendToFilename(playlistFile, QStringLiteral("_Audio"));
+    job.outputPath = wavFile(QStringLiteral("_Audio_Mix"));
+    job.audioStems = true;
+
+    QDomDocument docCopy = doc.cloneNode(true).toDocument();
+    QDomElement consumer = docCopy.elementsByTagName(QStringLiteral("consumer")).at(0).toElement();
+    consumer.setAttribute(QStringLiteral("target"), job.outputPath);
+    // The tracks of this tractor are pulled separately for the stems
+    QDomElement stems = docCopy.createElement(QStringLiteral("tractor"));
+    stems.setAttribute(QStringLiteral("id"), QStringLiteral("kdenlive_audio_stems"));
+    // Follow the sample format of the preset, the wav files cannot store compressed audio
+    const QString acodec = consumer.attribute(QStringLiteral("acodec"));
+    const QString sampleFormat = consumer.attribute(QStringLiteral("sample_fmt"));
+    QString stemFormat = QStringLiteral("s16");
+    if (acodec.startsWith(QLatin1String("pcm_f")) || sampleFormat.startsWith(QLatin1String("flt")) || sampleFormat.startsWith(QLatin1String("dbl"))) {
+        stemFormat = QStringLiteral("f32");
+    } else if (acodec.startsWith(QLatin1String("pcm_s24")) || acodec.startsWith(QLatin1String("pcm_s32")) || sampleFormat.startsWith(QLatin1String("s32"))) {
+        stemFormat = QStringLiteral("s24");
+    }
+    Xml::setXmlProperty(stems, QStringLiteral("kdenlive:stem_format"), stemFormat);
 
-    for (int i = orginalTractors.size(); i >= 0; i--) {
-        // Create a render job for each track, muting others
-        auto originalTracktor = orginalTractors.at(i).toElement();
-        const QString processedTrackId = originalTracktor.attribute(QStringLiteral("id"));
-        if (!trackIds.contains(processedTrackId)) {
+    int audioCount = 0;
+    QDomNodeList tractors = docCopy.elementsByTagName(QStringLiteral("tractor"));
+    // The last tractor of the document is the one rendered by the main job, with the transitions and master effects
+    const QString mixId = tractors.isEmpty() ? QString() : tractors.at(tractors.size() - 1).toElement().attribute(QStringLiteral("id"));
+    for (int i = tractors.size() - 1; i >= 0; i--) {
+        auto tractor = tractors.at(i).toElement();
+        const QString trackId = tractor.attribute(QStringLiteral("id"));
+        if (!trackIds.contains(trackId)) {
             continue;
         }
-        QString trackName = Xml::getXmlProperty(originalTracktor, QStringLiteral("kdenlive:track_name"));
-        bool originalIsAudio = Xml::getXmlProperty(originalTracktor, QStringLiteral("kdenlive:audio_track")).toInt() == 1;
-        if (!originalIsAudio) {
+        QString trackName = Xml::getXmlProperty(tractor, QStringLiteral("kdenlive:track_name"));
+        bool isAudio = Xml::getXmlProperty(tractor, QStringLiteral("kdenlive:audio_track")).toInt() == 1;
+        if (!isAudio) {
             // Not an audio track, nothing to do
             continue;
         }
-
+        // Keep the numbering of the tracks, but muted tracks are not rendered
+        audioCount++;
+        if (mutedIds.contains(trackId)) {
+            continue;
+        }
         // setup filenames
         QString appendix = QString("_Audio_%1%2%3")
-                               .arg(audioCount + 1)
+                               .arg(audioCount)
                                .arg(trackName.isEmpty() ? QString() : QStringLiteral("-"))
                                .arg(trackName.replace(QStringLiteral(" "), QStringLiteral("_")));
-        RenderJob job;
-        job.playlistPath = QStringUtils::appendToFilename(playlistFile, appendix);
-        job.outputPath = QStringUtils::appendToFilename(targetFile, appendix);
-        jobs.push_back(job);
-
-        // init doc copy
-        QDomDocument docCopy = doc.cloneNode(true).toDocument();
-        QDomElement consumer = docCopy.elementsByTagName(QStringLiteral("consumer")).at(0).toElement();
-        consumer.setAttribute(QStringLiteral("target"), job.outputPath);
-
-        QDomNodeList tracktors = docCopy.elementsByTagName(QStringLiteral("tractor"));
-        Q_ASSERT(tracktors.size() == orginalTractors.size());
-        QDomNodeList mainTracks = docCopy.elementsByTagName(QStringLiteral("tractor"));
-        for (int j = 0; j < tracktors.size(); j++) {
-            auto tractor = tracktors.at(j).toElement();
-            const QString currentId = tractor.attribute(QStringLiteral("id"));
-            if (!trackIds.contains(currentId)) {
-                // Not a track in current timeline
-                continue;
-            }
-            if (processedTrackId == currentId) {
-                // This is the track we want
-                continue;
-            }
-            bool copyIsAudio = Xml::getXmlProperty(tractor, QStringLiteral("kdenlive:audio_track")).toInt() == 1;
-            if (!copyIsAudio) {
-                // Not an audio track, leave as is
-                continue;
-            }
-            QDomNodeList tracks = tractor.elementsByTagName(QStringLiteral("track"));
-            for (int l = 0; l < tracks.size(); l++) {
-                if (i != j) {
-                    tracks.at(l).toElement().setAttribute(QStringLiteral("hide"), QStringLiteral("both"));
-                }
-            }
-        }
-        Xml::docContentToFile(docCopy, job.playlistPath);
-        audioCount++;
+        QDomElement track = docCopy.createElement(QStringLiteral("track"));
+        track.setAttribute(QStringLiteral("producer"), trackId);
+        stems.appendChild(track);
+        Xml::setXmlProperty(stems, QStringLiteral("kdenlive:stem.%1").arg(stems.elementsByTagName(QStringLiteral("track")).count() - 1),
+                            wavFile(appendix));
+    }
+    const int stemsCount = stems.elementsByTagName(QStringLiteral("track")).count();
+    if (stemsCount == 0 || mixId.isEmpty()) {
+        return;
     }
+    // The mixdown is pulled from the rendered tractor, after the stems
+    QDomElement mix = docCopy.createElement(QStringLiteral("track"));
+    mix.setAttribute(QStringLiteral("producer"), mixId);
+    stems.appendChild(mix);
+    Xml::setXmlProperty(stems, QStringLiteral("kdenlive:stem_mix"), QString::number(stemsCount));
+    // The last tractor of the document is the one that gets rendered
+    docCopy.documentElement().appendChild(stems);
+    docCopy.documentElement().setAttribute(QStringLiteral("producer"), stems.attribute(QStringLiteral("id")));
+    jobs.push_back(job);
+    Xml::docContentToFile(docCopy, job.playlistPath);
 }
 
 void RenderRequest::addErrorMessage(const QString &error)
@@ -19,6 +19,8 @@ public:
         QString playlistPath;
         QString outputPath;
         QString subtitlePath;
+        /// The job renders the audio tracks to separate files and a mixdown in a single pass, outputPath is the mixdown
+        bool audioStems = false;
     };
 
     /** @brief Set frame range that should be rendered
@@ -39,11 +41,24 @@ public:
     void setGuideParams(std::weak_ptr<MarkerListModel> model, bool enableMultiExport, int filterCategory);
     void setOverlayData(const QString &data);
 
+    /** @brief Estimated resources used by a render job, to decide how many jobs can run at the same time */
+    struct RenderCost
+    {
+        /// Number of processor threads
+        int threads;
+        /// Memory in MiB
+        int memory;
+    };
+
     std::vector<RenderJob> process();
 
     QStringList errorMessages();
 
     static QStringList argsByJob(const RenderJob &job);
+    /** @brief Estimate the resources needed to render a playlist from its consumer parameters.
+     *  If the playlist cannot be read, the job is expected to use the whole machine.
+     */
+    static RenderCost estimateCost(const QString &playlistPath);
 
 private:
     struct RenderSection
@@ -73,8 +88,12 @@ private:
     void setDocGeneralParams(QDomDocument doc, int in, int out);
     void setDocTwoPassParams(int pass, QDomDocument &doc, const QString &outputFile);
     std::vector<RenderSection> getGuideSections();
-    static void prepareMultiAudioFiles(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistFile, const QString &targetFile,
-                                       const QUuid &uuid);
+    /** @brief Create a single job rendering each audio track of the timeline to a wav file, and the mixdown.
+     *  The playlist gets an extra tractor listing the audio tracks, then the rendered tractor for the mixdown, that kdenlive_render pulls once per frame.
+     *  The wav files use the sample format of the preset: 16 bit, 24 bit or float.
+     */
+    static void prepareAudioStems(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistFile, const QString &targetFile,
+                                  const QUuid &uuid);
 
     static QString createEmptyTempFile(const QString &extension);
 
@@ -85,7 +104,7 @@ private:
     QString generatePlaylistFile();
 
     /** @brief Create Render jobs for a render section.
-     *  There might be multiple jobs for one section for each pass in case of 2pass or each audio track in case of multi audio track export
+     *  There might be multiple jobs for one section for each pass in case of 2pass, or an extra job for the audio tracks in case of multi audio track export
      * @param jobs the vector to which the jobs will be added
      */
     void createRenderJobs(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistPath, QString outputPath, const QString &subtitlePath,
@@ -24,6 +24,7 @@ RenderServer::RenderServer(QObject *parent)
     }
     connect(pCore->window(), &MainWindow::abortRenderJob, this, &RenderServer::abortJob);
     connect(this, &RenderServer::setRenderingProgress, pCore->window(), &MainWindow::setRenderingProgress);
+    connect(this, &RenderServer::setRenderingTelemetry, pCore->window(), &MainWindow::setRenderingTelemetry);
     connect(this, &RenderServer::setRenderingFinished, pCore->window(), &MainWindow::setRenderingFinished);
 }
 
@@ -33,31 +34,43 @@ void RenderServer::jobConnected()
 {
     QLocalSocket *socket = m_server.nextPendingConnection();
     connect(socket, &QLocalSocket::readyRead, this, &RenderServer::jobSent);
+    connect(socket, &QLocalSocket::disconnected, this, &RenderServer::jobDisconnected);
 }
 
 void RenderServer::jobSent()
 {
     QLocalSocket *socket = reinterpret_cast<QLocalSocket *>(sender());
-    QTextStream text(socket);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    text.setCodec("UTF-8");
-#endif
-    QString block, line;
-    while (text.readLineInto(&line)) {
-        block.append(line);
-        if (line == QLatin1String("}")) { // end of json object
-            QJsonParseError error;
-            const QJsonObject json = QJsonDocument::fromJson(block.toUtf8(), &error).object();
-            if (error.error != QJsonParseError::NoError) {
-                pCore->displayMessage(i18n("Communication error with render job"), ErrorMessage);
-                qWarning() << "RenderServer recieve error: " << error.errorString() << block;
-            }
-            handleJson(json, socket);
-            block.clear();
+    // Several jobs can run at the same time and a message can be received in several parts, so keep the pending data of each job
+    QByteArray &buffer = m_pendingData[socket];
+    buffer.append(socket->readAll());
+    int end = buffer.indexOf("\n}");
+    while (end >= 0) { // end of json object
+        const QByteArray block = buffer.left(end + 2);
+        buffer.remove(0, end + 2);
+        QJsonParseError error;
+        const QJsonObject json = QJsonDocument::fromJson(block, &error).object();
+        if (error.error != QJsonParseError::NoError) {
+            pCore->displayMessage(i18n("Communication error with render job"), ErrorMessage);
+            qWarning() << "RenderServer recieve error: " << error.errorString() << block;
         }
+        handleJson(json, socket);
+        end = buffer.indexOf("\n}");
     }
 }
 
+void RenderServer::jobDisconnected()
+{
+    QLocalSocket *socket = reinterpret_cast<QLocalSocket *>(sender());
+    m_pendingData.remove(socket);
+    // Jobs that finished normally already sent their status
+    const QStringList urls = m_jobSocket.keys(socket);
+    for (const QString &url : urls) {
+        m_jobSocket.remove(url);
+        Q_EMIT setRenderingFinished(url, -2, i18n("The render process stopped unexpectedly."));
+    }
+    socket->deleteLater();
+}
+
 void RenderServer::handleJson(const QJsonObject &json, QLocalSocket *socket)
 {
     if (json.contains("url")) {
@@ -69,6 +82,10 @@ void RenderServer::handleJson(const QJsonObject &json, QLocalSocket *socket)
         const auto frame = json["setRenderingProgress"]["frame"].toInt();
         Q_EMIT setRenderingProgress(url, progress, frame);
     }
+    if (json.contains("setRenderingTelemetry")) {
+        const QJsonObject telemetry = json["setRenderingTelemetry"].toObject();
+        Q_EMIT setRenderingTelemetry(telemetry["url"].toString(), QString::fromUtf8(QJsonDocument(telemetry).toJson(QJsonDocument::Compact)));
+    }
     if (json.contains("setRenderingFinished")) {
         const auto url = json["setRenderingFinished"]["url"].toString();
         const auto status = json["setRenderingFinished"]["status"].toInt();
@@ -20,6 +20,8 @@ public:
 
 Q_SIGNALS:
     void setRenderingProgress(const QString &url, int progress, int frame);
+    /** @brief Detailed state of a job as a JSON object: speed, bitrate, remaining time and stage durations */
+    void setRenderingTelemetry(const QString &url, const QString &telemetry);
     void setRenderingFinished(const QString &url, int status, const QString &error);
 
 public Q_SLOTS:
@@ -29,8 +31,12 @@ private Q_SLOTS:
     void jobConnected();
     void handleJson(const QJsonObject &json, QLocalSocket *socket);
     void jobSent();
+    void jobDisconnected();
 
 private:
     QLocalServer m_server;
+    /// The socket of each running job, by output url
     QHash<QString, QLocalSocket*> m_jobSocket;
+    /// Received data that does not form a complete message yet, by socket
+    QHash<QLocalSocket *, QByteArray> m_pendingData;
 };
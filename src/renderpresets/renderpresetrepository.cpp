@@ -13,6 +13,7 @@
 #include <KMessageBox>
 #include <QDir>
 #include <QInputDialog>
+#include <QMutexLocker>
 #include <QStandardPaths>
 #include <algorithm>
 #include <mlt++/MltConsumer.h>
@@ -43,6 +44,9 @@ std::unique_ptr<RenderPresetRepository> &RenderPresetRepository::get()
 // static
 void RenderPresetRepository::checkCodecs(bool forceRefresh)
 {
+    // The codec lists are only queried on first use, as starting the avformat consumer is slow
+    static QMutex codecsMutex;
+    QMutexLocker lk(&codecsMutex);
     if (!(m_acodecsList.isEmpty() || m_vcodecsList.isEmpty() || m_supportedFormats.isEmpty() || forceRefresh)) {
         return;
     }
@@ -34,6 +34,51 @@ static QStringList m_errorMessage;
 static QStringList m_notesLog;
 std::unordered_map<QString, QString> binIdCorresp;
 
+namespace {
+/** @brief A clip found in a playlist of the project file */
+struct MeltClipEntry
+{
+    int position;
+    std::shared_ptr<Mlt::Producer> clip;
+};
+
+/** @brief List the clips of a playlist with their position.
+    Playlist::clip_start() walks the playlist up to the requested clip, so positions are accumulated in a single pass instead. */
+std::vector<MeltClipEntry> scanPlaylist(Mlt::Playlist &track)
+{
+    std::vector<MeltClipEntry> entries;
+    int max = track.count();
+    entries.reserve(size_t(max));
+    int position = 0;
+    for (int i = 0; i < max; i++) {
+        int length = track.clip_length(i);
+        if (!track.is_blank(i)) {
+            entries.push_back({position, std::shared_ptr<Mlt::Producer>(track.get_clip(i))});
+        }
+        position += length;
+    }
+    return entries;
+}
+} // namespace
+
+/** @brief Keeps the timeline in bulk load mode while it is built, so that the view gets a single reset at the end */
+class BulkLoadGuard
+{
+public:
+    explicit BulkLoadGuard(const std::shared_ptr<TimelineItemModel> &timeline)
+        : m_timeline(timeline)
+    {
+        m_timeline->beginBulkLoad();
+    }
+    ~BulkLoadGuard()
+    {
+        m_timeline->endBulkLoad();
+    }
+
+private:
+    std::shared_ptr<TimelineItemModel> m_timeline;
+};
+
 bool constructTrackFromMelt(const std::shared_ptr<TimelineItemModel> &timeline, int tid, bool useMappedIds, const QString trackTag, Mlt::Tractor &track,
                             Fun &undo, Fun &redo, bool audioTrack, const QString &originalDecimalPoint);
 bool constructTrackFromMelt(const std::shared_ptr<TimelineItemModel> &timeline, int tid, bool useMappedIds, const QString trackTag, Mlt::Playlist &track,
@@ -137,6 +182,8 @@ bool constructTimelineFromTractor(const std::shared_ptr<TimelineItemModel> &time
     QSet<QString> reserved_names{QLatin1String("playlistmain"), QLatin1String("timeline_preview"), QLatin1String("timeline_overlay"),
                                  QLatin1String("black_track"), QLatin1String("overlay_track")};
     bool ok = true;
+    // Build the model without notifying each item, the view is reset once loading is done
+    BulkLoadGuard bulkLoad(timeline);
 
     // Import master track effects
     std::shared_ptr<Mlt::Service> serv = std::make_shared<Mlt::Service>(tractor.get_service());
@@ -257,8 +304,6 @@ bool constructTimelineFromTractor(const std::shared_ptr<TimelineItemModel> &time
             qWarning() << "Unexpected track type" << track->type();
         }
     }
-    timeline->_resetView();
-
     // Loading compositions
     Mlt::Service *prod = tractor.producer();
     QList<Mlt::Transition *> compositions;
@@ -394,6 +439,8 @@ bool constructTimelineFromMelt(const std::shared_ptr<TimelineItemModel> &timelin
     QSet<QString> reserved_names{QLatin1String("playlistmain"), QLatin1String("timeline_preview"), QLatin1String("timeline_overlay"),
                                  QLatin1String("black_track"), QLatin1String("overlay_track")};
     bool ok = true;
+    // Build the model without notifying each item, the view is reset once loading is done
+    BulkLoadGuard bulkLoad(timeline);
 
     // Import master track effects
     std::shared_ptr<Mlt::Service> serv = std::make_shared<Mlt::Service>(tractor.get_service());
@@ -512,8 +559,6 @@ bool constructTimelineFromMelt(const std::shared_ptr<TimelineItemModel> &timelin
             qWarning() << "Unexpected track type" << track->type();
         }
     }
-    timeline->_resetView();
-
     // Loading compositions
     QScopedPointer<Mlt::Service> service(tractor.producer());
     QList<Mlt::Transition *> compositions;
@@ -760,14 +805,11 @@ bool constructTrackFromMelt(const std::shared_ptr<TimelineItemModel> &timeline,
                             Fun &undo, Fun &redo, bool audioTrack, const QString &originalDecimalPoint, int playlist,
                             const QList<Mlt::Transition *> &compositions)
 {
-    int max = track.count();
+    const std::vector<MeltClipEntry> entries = scanPlaylist(track);
     const QString sequenceBinId = pCore->projectItemModel()->getSequenceId(timeline->uuid());
-    for (int i = 0; i < max; i++) {
-        if (track.is_blank(i)) {
-            continue;
-        }
-        std::shared_ptr<Mlt::Producer> clip(track.get_clip(i));
-        int position = track.clip_start(i);
+    for (const MeltClipEntry &entry : entries) {
+        std::shared_ptr<Mlt::Producer> clip = entry.clip;
+        int position = entry.position;
         switch (clip->type()) {
         case mlt_service_unknown_type:
         case mlt_service_chain_type:
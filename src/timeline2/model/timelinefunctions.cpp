@@ -55,7 +55,9 @@ RTTR_REGISTRATION
                                             &TimelineFunctions::requestDeleteBlankAt))(parameter_names("timeline", "trackId", "position", "affectAllTracks"));
 }
 #else
-#define TRACE_STATIC(...)
+#include "utils/tracing.hpp"
+// Without the crash logger, the model requests are still recorded as trace events
+#define TRACE_STATIC(...) TRACE_SCOPE("model", __FUNCTION__);
 #define TRACE_RES(...)
 #endif
 
@@ -99,25 +101,7 @@ bool TimelineFunctions::cloneClip(const std::shared_ptr<TimelineItemModel> &time
 bool TimelineFunctions::requestMultipleClipsInsertion(const std::shared_ptr<TimelineItemModel> &timeline, const QStringList &binIds, int trackId, int position,
                                                       QList<int> &clipIds, bool logUndo, bool refreshView)
 {
-    std::function<bool(void)> undo = []() { return true; };
-    std::function<bool(void)> redo = []() { return true; };
-    for (const QString &binId : binIds) {
-        int clipId;
-        if (timeline->requestClipInsertion(binId, trackId, position, clipId, logUndo, refreshView, false, undo, redo)) {
-            clipIds.append(clipId);
-            position += timeline->getItemPlaytime(clipId);
-        } else {
-            undo();
-            clipIds.clear();
-            return false;
-        }
-    }
-
-    if (logUndo) {
-        pCore->pushUndo(undo, redo, i18n("Insert Clips"));
-    }
-
-    return true;
+    return timeline->requestClipsInsertion(binIds, trackId, position, clipIds, logUndo, refreshView);
 }
 
 bool TimelineFunctions::processClipCut(const std::shared_ptr<TimelineItemModel> &timeline, int clipId, int position, int &newId, Fun &undo, Fun &redo)
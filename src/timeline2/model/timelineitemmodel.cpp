@@ -659,6 +659,9 @@ bool TimelineItemModel::loadGroups(const QString &groupsData)
 
 void TimelineItemModel::notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, bool start, bool duration, bool updateThumb)
 {
+    if (m_bulkLoading) {
+        return;
+    }
     QVector<int> roles;
     if (start) {
         roles.push_back(TimelineModel::StartRole);
@@ -677,6 +680,9 @@ void TimelineItemModel::notifyChange(const QModelIndex &topleft, const QModelInd
 
 void TimelineItemModel::notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, const QVector<int> &roles)
 {
+    if (m_bulkLoading) {
+        return;
+    }
     Q_EMIT dataChanged(topleft, bottomright, roles);
 }
 
@@ -823,36 +829,78 @@ void TimelineItemModel::buildTrackCompositing(bool rebuild)
 
 void TimelineItemModel::notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, int role)
 {
+    if (m_bulkLoading) {
+        return;
+    }
     Q_EMIT dataChanged(topleft, bottomright, {role});
 }
 
 void TimelineItemModel::_beginRemoveRows(const QModelIndex &i, int j, int k)
 {
     // qDebug()<<"FORWARDING beginRemoveRows"<<i<<j<<k;
-    beginRemoveRows(i, j, k);
+    if (!m_bulkLoading) {
+        beginRemoveRows(i, j, k);
+    }
 }
 void TimelineItemModel::_beginInsertRows(const QModelIndex &i, int j, int k)
 {
     // qDebug()<<"FORWARDING beginInsertRows"<<i<<j<<k;
-    beginInsertRows(i, j, k);
+    if (!m_bulkLoading) {
+        beginInsertRows(i, j, k);
+    }
 }
 void TimelineItemModel::_endRemoveRows()
 {
     // qDebug()<<"FORWARDING endRemoveRows";
-    endRemoveRows();
+    if (!m_bulkLoading) {
+        endRemoveRows();
+    }
 }
 void TimelineItemModel::_endInsertRows()
 {
     // qDebug()<<"FORWARDING endinsertRows";
-    endInsertRows();
+    if (!m_bulkLoading) {
+        endInsertRows();
+    }
 }
 
 void TimelineItemModel::_resetView()
 {
+    if (m_bulkLoading) {
+        // The view will be reset when leaving bulk load mode
+        return;
+    }
     beginResetModel();
     endResetModel();
 }
 
+void TimelineItemModel::beginBulkLoad()
+{
+    if (m_bulkLoading) {
+        return;
+    }
+    beginResetModel();
+    m_bulkLoading = true;
+    m_bulkBlockedRefresh = m_blockRefresh;
+    m_blockRefresh = true;
+}
+
+void TimelineItemModel::endBulkLoad()
+{
+    if (!m_bulkLoading) {
+        return;
+    }
+    m_bulkLoading = false;
+    m_blockRefresh = m_bulkBlockedRefresh;
+    updateDuration();
+    endResetModel();
+}
+
+bool TimelineItemModel::isBulkLoading() const
+{
+    return m_bulkLoading;
+}
+
 void TimelineItemModel::passSequenceProperties(const QMap<QString, QString> baseProperties)
 {
     QMapIterator<QString, QString> i(baseProperties);
@@ -117,10 +117,19 @@ public:
     void _endRemoveRows() override;
     void _endInsertRows() override;
     void _resetView() override;
+    /** @brief Enter bulk load mode, used when building the timeline from a project file.
+        Row insertions and removals, data changes, monitor refreshes and duration updates are not notified
+        until endBulkLoad(), which sends a single model reset instead of one notification per item. */
+    void beginBulkLoad();
+    /** @brief Leave bulk load mode, update the timeline duration and reset the view */
+    void endBulkLoad();
+    bool isBulkLoading() const;
 
 protected:
     /** @brief This is an helper function that finishes a construction of a freshly created TimelineItemModel */
     static void finishConstruct(const std::shared_ptr<TimelineItemModel> &ptr);
+    /** @brief Monitor refresh state to restore when leaving bulk load mode */
+    bool m_bulkBlockedRefresh{false};
 
 Q_SIGNALS:
     /** @brief Triggered when a video track visibility changed */
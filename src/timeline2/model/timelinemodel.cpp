@@ -97,10 +97,12 @@ RTTR_REGISTRATION
             parameter_names("clipId", "speed", "pitchCompensate", "changeDuration"));
 }
 #else
+#include "utils/tracing.hpp"
+// Without the crash logger, the model requests are still recorded as trace events
 #define TRACE_CONSTR(...)
-#define TRACE_STATIC(...)
+#define TRACE_STATIC(...) TRACE_SCOPE("model", __FUNCTION__);
 #define TRACE_RES(...)
-#define TRACE(...)
+#define TRACE(...) TRACE_SCOPE("model", __FUNCTION__);
 #endif
 
 int TimelineModel::seekDuration = 30000;
@@ -1281,7 +1283,7 @@ bool TimelineModel::requestFakeClipMove(int clipId, int trackId, int position, b
     std::function<bool(void)> redo = []() { return true; };
     bool res = requestFakeClipMove(clipId, trackId, position, updateView, invalidateTimeline, undo, redo);
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move clip"));
+        PUSH_MERGEABLE_UNDO(undo, redo, i18n("Move clip"), UndoMergeId::MoveItem, QString::number(clipId));
     }
     TRACE_RES(res);
     return res;
@@ -1316,7 +1318,7 @@ bool TimelineModel::requestClipMove(int clipId, int trackId, int position, bool
     std::function<bool(void)> redo = []() { return true; };
     bool res = requestClipMove(clipId, trackId, position, moveMirrorTracks, updateView, invalidateTimeline, logUndo, undo, redo, revertMove);
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move clip"));
+        PUSH_MERGEABLE_UNDO(undo, redo, i18n("Move clip"), UndoMergeId::MoveItem, QString::number(clipId));
     }
     TRACE_RES(res);
     return res;
@@ -2123,6 +2125,151 @@ bool TimelineModel::requestClipInsertion(const QString &binClipId, int trackId,
     return true;
 }
 
+bool TimelineModel::requestClipsInsertion(const QStringList &binIds, int trackId, int position, QList<int> &clipIds, bool logUndo, bool refreshView)
+{
+    QWriteLocker locker(&m_lock);
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    bool result = requestClipsInsertion(binIds, trackId, position, clipIds, logUndo, refreshView, undo, redo);
+    if (result && logUndo) {
+        PUSH_UNDO(undo, redo, i18n("Insert Clips"));
+    }
+    return result;
+}
+
+bool TimelineModel::requestClipsInsertion(const QStringList &binIds, int trackId, int position, QList<int> &clipIds, bool logUndo, bool refreshView,
+                                          Fun &undo, Fun &redo)
+{
+    clipIds.clear();
+    if (!isTrack(trackId) || binIds.isEmpty() || position < 0) {
+        return false;
+    }
+    Fun local_undo = []() { return true; };
+    Fun local_redo = []() { return true; };
+    auto insertOneByOne = [&]() {
+        int pos = position;
+        for (const QString &binId : binIds) {
+            int clipId;
+            if (requestClipInsertion(binId, trackId, pos, clipId, logUndo, refreshView, false, local_undo, local_redo)) {
+                clipIds.append(clipId);
+                pos += getItemPlaytime(clipId);
+            } else {
+                bool undone = local_undo();
+                Q_ASSERT(undone);
+                clipIds.clear();
+                return false;
+            }
+        }
+        UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+        return true;
+    };
+    std::shared_ptr<TrackModel> track = getTrackById(trackId);
+    if (track->isLocked()) {
+        return false;
+    }
+    const PlaylistState::ClipState trackState = track->trackType();
+    const int mirror = track->isAudioTrack() ? -1 : getMirrorTrackId(trackId);
+    const QList<int> audioStreams = m_binAudioTargets.keys();
+
+    // Validate all the clips and decide what has to be created for each of them, before modifying anything
+    struct PlannedClip
+    {
+        QString binId;
+        int audioStream;
+        // Stream of the audio part inserted on the mirror track, -1 if there is none
+        int mirrorStream;
+    };
+    std::vector<PlannedClip> planned;
+    planned.reserve(size_t(binIds.size()));
+    for (const QString &binId : binIds) {
+        QString binIdWithInOut = binId;
+        QString bid = binId.section(QLatin1Char('/'), 0, 0);
+        PlaylistState::ClipState dropType = PlaylistState::Disabled;
+        if (bid.startsWith(QLatin1Char('A')) || bid.startsWith(QLatin1Char('V'))) {
+            dropType = bid.startsWith(QLatin1Char('A')) ? PlaylistState::AudioOnly : PlaylistState::VideoOnly;
+            bid.remove(0, 1);
+            binIdWithInOut.remove(0, 1);
+        }
+        if (!pCore->projectItemModel()->hasClip(bid)) {
+            qWarning() << "no clip found in bin for" << bid;
+            return false;
+        }
+        if (dropType != PlaylistState::Disabled && dropType != trackState) {
+            return false;
+        }
+        std::shared_ptr<ProjectClip> master = pCore->projectItemModel()->getClipByBinID(bid);
+        ClipType::ProducerType type = master->clipType();
+        if (type == ClipType::Timeline) {
+            // Sequences need extra checks, use the normal insertion
+            return insertOneByOne();
+        }
+        if (dropType == PlaylistState::VideoOnly || (type != ClipType::AV && type != ClipType::Playlist)) {
+            planned.push_back({binIdWithInOut, master->getProducerIntProperty(QStringLiteral("audio_index")), -1});
+            continue;
+        }
+        // Audio / video clip dropped on a video track, the audio part goes to the mirror track
+        if (track->isAudioTrack() || audioStreams.count() > 1 || (mirror == -1 && !audioStreams.isEmpty())) {
+            return insertOneByOne();
+        }
+        int mirrorStream = -1;
+        if (mirror > -1 && !audioStreams.isEmpty() && !getTrackById_const(mirror)->isLocked() && master->hasAudioAndVideo()) {
+            mirrorStream = audioStreams.first();
+        }
+        planned.push_back({binIdWithInOut, -1, mirrorStream});
+    }
+
+    // Create all clips
+    std::vector<std::pair<int, int>> trackClips;
+    std::vector<std::pair<int, int>> mirrorClips;
+    trackClips.reserve(planned.size());
+    int pos = position;
+    for (const PlannedClip &p : planned) {
+        int clipId;
+        if (!requestClipCreation(p.binId, clipId, trackState, p.audioStream, 1.0, false, local_undo, local_redo)) {
+            bool undone = local_undo();
+            Q_ASSERT(undone);
+            return false;
+        }
+        trackClips.push_back({clipId, pos});
+        if (p.mirrorStream > -1) {
+            int audioId;
+            if (!requestClipCreation(p.binId, audioId, PlaylistState::AudioOnly, p.mirrorStream, 1.0, false, local_undo, local_redo)) {
+                pCore->displayMessage(i18n("Audio split failed: impossible to create audio clip"), ErrorMessage);
+                bool undone = local_undo();
+                Q_ASSERT(undone);
+                return false;
+            }
+            mirrorClips.push_back({audioId, pos});
+        }
+        pos += m_allClips[clipId]->getPlaytime();
+    }
+
+    // Insert them with one operation per track
+    bool res = track->requestClipsInsertion(trackClips, refreshView, logUndo, local_undo, local_redo);
+    if (res && !mirrorClips.empty()) {
+        res = getTrackById(mirror)->requestClipsInsertion(mirrorClips, true, logUndo, local_undo, local_redo);
+        if (!res) {
+            pCore->displayMessage(i18n("Audio split failed: no viable track"), ErrorMessage);
+        }
+    }
+    if (!res) {
+        bool undone = local_undo();
+        Q_ASSERT(undone);
+        return false;
+    }
+    // Group the audio and video parts
+    size_t audioIx = 0;
+    for (const auto &c : trackClips) {
+        if (audioIx < mirrorClips.size() && mirrorClips[audioIx].second == c.second) {
+            requestClipsGroup({c.first, mirrorClips[audioIx].first}, local_undo, local_redo, GroupType::AVSplit);
+            ++audioIx;
+        }
+        clipIds.append(c.first);
+    }
+    UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+    return true;
+}
+
 bool TimelineModel::requestItemDeletion(int itemId, Fun &undo, Fun &redo, bool logUndo)
 {
     QWriteLocker locker(&m_lock);
@@ -2245,6 +2392,10 @@ bool TimelineModel::requestClipDeletion(int clipId, Fun &undo, Fun &redo, bool l
     }
     auto operation = deregisterClip_lambda(clipId);
     auto clip = m_allClips[clipId];
+    if (!m_closing) {
+        // The undo keeps the clip and its effects alive
+        UndoMemory::account(UndoMemory::serviceCost(*clip->m_producer.get()));
+    }
     Fun reverse = [this, clip]() {
         // We capture a shared_ptr to the clip, which means that as long as this undo object lives,
         // the clip object is not deleted. To insert it back it is sufficient to register it.
@@ -2294,6 +2445,9 @@ bool TimelineModel::requestCompositionDeletion(int compositionId, Fun &undo, Fun
     }
     Fun operation = deregisterComposition_lambda(compositionId);
     auto composition = m_allCompositions[compositionId];
+    if (!m_closing) {
+        UndoMemory::account(UndoMemory::serviceCost(*composition->service()));
+    }
     int new_in = composition->getPosition();
     int new_out = new_in + composition->getPlaytime();
     Fun reverse = [this, composition, compositionId, trackId, new_in, new_out]() {
@@ -2357,7 +2511,7 @@ bool TimelineModel::requestFakeGroupMove(int clipId, int groupId, int delta_trac
     std::function<bool(void)> redo = []() { return true; };
     bool res = requestFakeGroupMove(clipId, groupId, delta_track, delta_pos, updateView, logUndo, undo, redo);
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move group"));
+        PUSH_MERGEABLE_UNDO(undo, redo, i18n("Move group"), UndoMergeId::MoveItem, QStringLiteral("group%1").arg(groupId));
     }
     TRACE_RES(res);
     return res;
@@ -2634,7 +2788,7 @@ bool TimelineModel::requestGroupMove(int itemId, int groupId, int delta_track, i
         res = requestGroupMove(itemId, groupId, delta_track, delta_pos, updateView, logUndo, undo, redo, revertMove, moveMirrorTracks);
     }
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move group"));
+        PUSH_MERGEABLE_UNDO(undo, redo, i18n("Move group"), UndoMergeId::MoveItem, QStringLiteral("group%1").arg(groupId));
     }
     TRACE_RES(res);
     return res;
@@ -5107,7 +5261,7 @@ bool TimelineModel::isInGroup(int id) const
 
 void TimelineModel::updateDuration()
 {
-    if (m_closing) {
+    if (m_closing || m_bulkLoading) {
         return;
     }
     int current = m_blackClip->get_playtime() - TimelineModel::seekDuration - 1;
@@ -5569,7 +5723,7 @@ bool TimelineModel::requestCompositionMove(int compoId, int trackId, int positio
     }
 
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move composition"));
+        PUSH_MERGEABLE_UNDO(undo, redo, i18n("Move composition"), UndoMergeId::MoveItem, QString::number(compoId));
         checkRefresh(min, max);
     }
     return res;
@@ -7414,34 +7568,9 @@ void TimelineModel::loadPreview(const QString &chunks, const QString &dirty, boo
     if (!hasTimelinePreview()) {
         initializePreviewManager();
     }
-    QVariantList renderedChunks;
-    QVariantList dirtyChunks;
-    QStringList chunksList = chunks.split(QLatin1Char(','), Qt::SkipEmptyParts);
-    QStringList dirtyList = dirty.split(QLatin1Char(','), Qt::SkipEmptyParts);
-    for (const QString &frame : qAsConst(chunksList)) {
-        if (frame.contains(QLatin1Char('-'))) {
-            // Range, process
-            int start = frame.section(QLatin1Char('-'), 0, 0).toInt();
-            int end = frame.section(QLatin1Char('-'), 1, 1).toInt();
-            for (int i = start; i <= end; i += 25) {
-                renderedChunks << i;
-            }
-        } else {
-            renderedChunks << frame.toInt();
-        }
-    }
-    for (const QString &frame : qAsConst(dirtyList)) {
-        if (frame.contains(QLatin1Char('-'))) {
-            // Range, process
-            int start = frame.section(QLatin1Char('-'), 0, 0).toInt();
-            int end = frame.section(QLatin1Char('-'), 1, 1).toInt();
-            for (int i = start; i <= end; i += 25) {
-                dirtyChunks << i;
-            }
-        } else {
-            dirtyChunks << frame.toInt();
-        }
-    }
+    const int chunkSize = KdenliveSettings::timelinechunks();
+    ChunkSet renderedChunks = ChunkSet::fromString(chunks, chunkSize);
+    ChunkSet dirtyChunks = ChunkSet::fromString(dirty, chunkSize);
 
     if (hasTimelinePreview()) {
         if (!enable) {
@@ -475,6 +475,22 @@ public:
     /* Same function, but accumulates undo and redo*/
     bool requestClipInsertion(const QString &binClipId, int trackId, int position, int &id, bool logUndo, bool refreshView, bool useTargets, Fun &undo,
                               Fun &redo, const QVector<int> &allowedTracks = QVector<int>());
+    /** @brief Request the insertion of several clips one after the other. This action is undoable
+       The clips are all created first, then inserted with a single playlist edit per track, so that inserting many clips does not
+       redo the whole insertion process for each of them. If the insertion of any clip fails, nothing is modified.
+       The clips follow the same rules as requestClipInsertion without targets, clips that need a more complex insertion (multiple audio streams,
+       locked mirror tracks, sequences) fall back to inserting the clips one by one.
+       @param binIds ids of the clips in the bin
+       @param trackId Id of the track where to insert
+       @param position Requested position of the first clip
+       @param clipIds return parameter with the ids of the inserted clips, empty on failure
+       @param logUndo if set to false, no undo object is stored
+       @param refreshView whether the view should be refreshed
+    */
+    bool requestClipsInsertion(const QStringList &binIds, int trackId, int position, QList<int> &clipIds, bool logUndo = true, bool refreshView = false);
+    /* Same function, but accumulates undo and redo*/
+    bool requestClipsInsertion(const QStringList &binIds, int trackId, int position, QList<int> &clipIds, bool logUndo, bool refreshView, Fun &undo,
+                               Fun &redo);
 
     /** @brief Switch current composition type
      *  @param cid the id of the composition we want to change
@@ -999,6 +1015,8 @@ protected:
     void checkRefresh(int start, int end);
 
     bool m_blockRefresh;
+    /** @brief True while the timeline is built from a project file, see TimelineItemModel::beginBulkLoad() */
+    bool m_bulkLoading{false};
 
 Q_SIGNALS:
     /** @brief signal triggered by clearAssetView */
@@ -499,6 +499,193 @@ bool TrackModel::requestClipDeletion(int clipId, bool updateView, bool finalMove
     return false;
 }
 
+bool TrackModel::requestClipsInsertion(const std::vector<std::pair<int, int>> &clips, bool updateView, bool finalMove, Fun &undo, Fun &redo)
+{
+    QWriteLocker locker(&m_lock);
+    if (isLocked() || clips.empty()) {
+        return false;
+    }
+    auto ptr = m_parent.lock();
+    if (!ptr) {
+        return false;
+    }
+    int duration = trackDuration();
+    int previousEnd = 0;
+    for (const auto &c : clips) {
+        std::shared_ptr<ClipModel> clip = ptr->getClipPtr(c.first);
+        if (c.second < previousEnd || clip->getCurrentTrackId() != -1 || (isAudioTrack() && !clip->canBeAudio()) ||
+            (!isAudioTrack() && !clip->canBeVideo())) {
+            return false;
+        }
+        previousEnd = c.second + clip->getPlaytime();
+        // Positions after the end of the track are always free, no need to query the playlists
+        if (c.second < duration && (!isBlankAt(c.second) || getBlankEnd(c.second) < previousEnd - 1)) {
+            qWarning() << "clips insert failed - non blank";
+            return false;
+        }
+    }
+    auto operation = requestClipsInsertion_lambda(clips, updateView, finalMove);
+    if (operation()) {
+        auto reverse = requestClipsDeletion_lambda(clips, updateView);
+        Fun local_undo = []() { return true; };
+        Fun local_redo = []() { return true; };
+        if (duration != trackDuration()) {
+            // The insertion changed the track duration, update track effects
+            m_effectStack->adjustStackLength(true, 0, duration, 0, trackDuration(), 0, local_undo, local_redo, true);
+        }
+        UPDATE_UNDO_REDO(operation, reverse, undo, redo);
+        UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+        return true;
+    }
+    return false;
+}
+
+Fun TrackModel::requestClipsInsertion_lambda(const std::vector<std::pair<int, int>> &clips, bool updateView, bool finalMove)
+{
+    return [this, clips, updateView, finalMove]() {
+        auto ptr = m_parent.lock();
+        if (!ptr) {
+            qDebug() << "Error : Clip Insertion failed because timeline is not available anymore";
+            return false;
+        }
+        // Lock MLT playlist so that we don't end up with an invalid frame being displayed
+        std::unique_ptr<Mlt::Field> field(m_track->field());
+        field->block();
+        m_playlists[0].lock();
+        bool ok = true;
+        for (const auto &c : clips) {
+            std::shared_ptr<ClipModel> clip = ptr->getClipPtr(c.first);
+            clip->setCurrentTrackId(m_id, finalMove);
+            int length = m_playlists[0].get_playtime();
+            if (c.second >= length) {
+                // Appending does not need to look up the insertion index in the playlist
+                if (c.second > length) {
+                    m_playlists[0].blank(c.second - length - 1);
+                }
+                ok = m_playlists[0].append(*clip) == 0;
+            } else {
+                ok = m_playlists[0].insert_at(c.second, *clip, 1) != -1;
+            }
+            if (!ok) {
+                break;
+            }
+        }
+        m_playlists[0].consolidate_blanks();
+        m_playlists[0].unlock();
+        field->unblock();
+        if (!ok) {
+            return false;
+        }
+        // Rows are sorted by clip id, new clips usually come last so that we can notify them as a single block
+        int minId = std::min_element(clips.begin(), clips.end())->first;
+        bool appendRows = m_allClips.empty() || m_allClips.rbegin()->first < minId;
+        int firstRow = int(m_allClips.size());
+        if (updateView && appendRows) {
+            ptr->_beginInsertRows(ptr->makeTrackIndexFromID(m_id), firstRow, firstRow + int(clips.size()) - 1);
+        }
+        bool hasVideo = false;
+        for (const auto &c : clips) {
+            std::shared_ptr<ClipModel> clip = ptr->getClipPtr(c.first);
+            m_allClips[c.first] = clip;
+            clip->setPosition(c.second);
+            if (finalMove) {
+                clip->setSubPlaylistIndex(0, m_id);
+            }
+            ptr->m_snaps->addPoint(c.second);
+            ptr->m_snaps->addPoint(c.second + clip->getPlaytime());
+            hasVideo = hasVideo || !clip->isAudioOnly();
+            if (updateView && !appendRows) {
+                int clip_index = getRowfromClip(c.first);
+                ptr->_beginInsertRows(ptr->makeTrackIndexFromID(m_id), clip_index, clip_index);
+                ptr->_endInsertRows();
+            }
+        }
+        if (updateView && appendRows) {
+            ptr->_endInsertRows();
+        }
+        ptr->updateDuration();
+        if (updateView && finalMove && hasVideo && !isAudioTrack()) {
+            int in = clips.front().second;
+            int out = clips.back().second + ptr->getClipPtr(clips.back().first)->getPlaytime();
+            if (!isHidden()) {
+                ptr->checkRefresh(in, out);
+            }
+            Q_EMIT ptr->invalidateZone(in, out);
+        }
+        return true;
+    };
+}
+
+Fun TrackModel::requestClipsDeletion_lambda(const std::vector<std::pair<int, int>> &clips, bool updateView)
+{
+    return [this, clips, updateView]() {
+        auto ptr = m_parent.lock();
+        if (!ptr) {
+            return false;
+        }
+        // If the clips are the last rows of the model, notify their removal as a single block
+        int minId = std::min_element(clips.begin(), clips.end())->first;
+        bool lastRows = size_t(std::distance(m_allClips.lower_bound(minId), m_allClips.end())) == clips.size();
+        if (updateView && lastRows) {
+            int firstRow = int(m_allClips.size() - clips.size());
+            ptr->_beginRemoveRows(ptr->makeTrackIndexFromID(m_id), firstRow, firstRow + int(clips.size()) - 1);
+            ptr->_endRemoveRows();
+        }
+        bool wasSelected = false;
+        bool hasVideo = false;
+        int in = clips.front().second;
+        int out = in;
+        m_playlists[0].lock();
+        std::unique_ptr<Mlt::Field> field(m_track->field());
+        field->block();
+        // Remove from the last clip so that the playlist indexes of the previous clips stay valid
+        for (auto it = clips.rbegin(); it != clips.rend(); ++it) {
+            std::shared_ptr<ClipModel> clip = m_allClips[it->first];
+            int clip_end = it->second + clip->getPlaytime();
+            if (updateView && !lastRows) {
+                int old_clip_index = getRowfromClip(it->first);
+                ptr->_beginRemoveRows(ptr->makeTrackIndexFromID(m_id), old_clip_index, old_clip_index);
+                ptr->_endRemoveRows();
+            }
+            int target_clip = m_playlists[0].get_clip_index_at(it->second);
+            Q_ASSERT(!m_playlists[0].is_blank(target_clip));
+            auto prod = m_playlists[0].replace_with_blank(target_clip);
+            if (prod == nullptr) {
+                m_playlists[0].consolidate_blanks();
+                field->unblock();
+                m_playlists[0].unlock();
+                return false;
+            }
+            delete prod;
+            wasSelected = wasSelected || clip->selected;
+            clip->selected = false;
+            clip->setCurrentTrackId(-1);
+            m_allClips.erase(it->first);
+            ptr->m_snaps->removePoint(it->second);
+            ptr->m_snaps->removePoint(clip_end);
+            out = qMax(out, clip_end);
+            hasVideo = hasVideo || !clip->isAudioOnly();
+        }
+        m_playlists[0].consolidate_blanks();
+        field->unblock();
+        m_playlists[0].unlock();
+        if (wasSelected) {
+            // items were selected, unselect
+            ptr->requestClearSelection(true);
+        }
+        if (!ptr->m_closing) {
+            ptr->updateDuration();
+            if (hasVideo && !isAudioTrack()) {
+                Q_EMIT ptr->invalidateZone(in, out);
+                if (!isHidden()) {
+                    ptr->checkRefresh(in, out);
+                }
+            }
+        }
+        return true;
+    };
+}
+
 int TrackModel::getBlankSizeAtPos(int frame)
 {
     READ_LOCK();
@@ -183,6 +183,22 @@ protected:
     /** @brief This function returns a lambda that performs the requested operation */
     Fun requestClipInsertion_lambda(int clipId, int position, bool updateView, bool finalMove, bool groupMove = false, const QList<int> &allowedClipMixes = {});
 
+    /** @brief Performs the insertion of several clips at once.
+       The clips must be created and not on a track yet, and their ranges must be blank. The MLT playlist is edited in one pass and the view
+       receives a single row insertion, so this is much faster than inserting the clips one by one.
+       Returns true if the operation succeeded, and otherwise, the track is not modified.
+       @param clips is the list of clip ids with their position, sorted by position
+       @param updateView whether we send update to the view
+       @param finalMove if false, the clips are only inserted temporarily (for example while dragging) and the timeline is not invalidated
+       @param undo Lambda function containing the current undo stack. Will be updated with current operation
+       @param redo Lambda function containing the current redo queue. Will be updated with current operation
+    */
+    bool requestClipsInsertion(const std::vector<std::pair<int, int>> &clips, bool updateView, bool finalMove, Fun &undo, Fun &redo);
+    /** @brief This function returns a lambda that performs the requested operation */
+    Fun requestClipsInsertion_lambda(const std::vector<std::pair<int, int>> &clips, bool updateView, bool finalMove);
+    /** @brief This function returns a lambda that removes the clips inserted by requestClipsInsertion_lambda */
+    Fun requestClipsDeletion_lambda(const std::vector<std::pair<int, int>> &clips, bool updateView);
+
     /** @brief Performs an deletion of the given clip.
        Returns true if the operation succeeded, and otherwise, the track is not modified.
        This method is protected because it shouldn't be called directly. Call the function in the timeline instead.
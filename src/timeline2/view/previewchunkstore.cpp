@@ -0,0 +1,366 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "previewchunkstore.h"
+#include "utils/cachemanager.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+#include <climits>
+
+namespace {
+/** @brief Computes the content hash of a frame range of an MLT XML scene */
+class ChunkHasher
+{
+public:
+    explicit ChunkHasher(const QDomDocument &scene)
+    {
+        QDomElement child = scene.documentElement().firstChildElement();
+        while (!child.isNull()) {
+            const QString tag = child.tagName();
+            if (tag == QLatin1String("producer") || tag == QLatin1String("chain") || tag == QLatin1String("playlist") || tag == QLatin1String("tractor")) {
+                m_services.insert(child.attribute(QStringLiteral("id")), child);
+                // The xml consumer writes the root service last
+                m_root = child;
+            }
+            child = child.nextSiblingElement();
+        }
+    }
+
+    QString key(int start, int end, const QByteArray &salt)
+    {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData(salt);
+        hashService(hash, m_root, start, end, 0, 0);
+        return QString::fromLatin1(hash.result().toHex());
+    }
+
+private:
+    /** @brief What is hashed for an element, it doesn't depend on the chunk */
+    struct Definition
+    {
+        QByteArray properties;
+        bool positionDependent;
+    };
+    /** @brief A playlist entry or blank, with its position in the playlist */
+    struct PlaylistItem
+    {
+        int position;
+        QDomElement element;
+    };
+    QHash<QString, QDomElement> m_services;
+    /** @brief The definitions of the elements, by position in the document since entries have no id */
+    QHash<qint64, Definition> m_definitions;
+    /** @brief The entries of each playlist, by playlist id */
+    QHash<QString, QVector<PlaylistItem>> m_playlists;
+    /** @brief The tracks and transitions of each tractor, by tractor id */
+    QHash<QString, QList<QDomElement>> m_tractors;
+    QDomElement m_root;
+
+    static void addRange(QCryptographicHash &hash, char type, int a, int b, int c)
+    {
+        hash.addData(QStringLiteral("%1:%2:%3:%4;").arg(QChar::fromLatin1(type)).arg(a).arg(b).arg(c).toLatin1());
+    }
+
+    /** @brief The properties of a service that affect its rendering, sorted */
+    static QByteArray properties(const QDomElement &element)
+    {
+        QStringList properties;
+        QDomElement prop = element.firstChildElement(QStringLiteral("property"));
+        while (!prop.isNull()) {
+            const QString name = prop.attribute(QStringLiteral("name"));
+            // Kdenlive metadata, MLT private properties and source metadata don't change the rendered frames,
+            // the length of a producer only matters through the frames used by the playlists
+            const bool ignored = (name.startsWith(QLatin1String("kdenlive:")) && name != QLatin1String("kdenlive:file_hash")) ||
+                                 name.startsWith(QLatin1Char('_')) || name.startsWith(QLatin1String("meta.")) || name == QLatin1String("length") ||
+                                 name == QLatin1String("in") || name == QLatin1String("out");
+            if (!ignored) {
+                properties << name + QLatin1Char('=') + prop.text();
+            }
+            prop = prop.nextSiblingElement(QStringLiteral("property"));
+        }
+        std::sort(properties.begin(), properties.end());
+        return properties.join(QLatin1Char('\n')).toUtf8();
+    }
+
+    /** @brief The definition of an element, computed once for all the chunks */
+    const Definition &definition(const QDomElement &element)
+    {
+        const qint64 position = (qint64(element.lineNumber()) << 32) | quint32(element.columnNumber());
+        auto it = m_definitions.find(position);
+        if (it == m_definitions.end() || element.lineNumber() < 0) {
+            it = m_definitions.insert(position, {properties(element), isPositionDependent(element)});
+        }
+        return it.value();
+    }
+
+    static QString property(const QDomElement &element, const QString &name)
+    {
+        QDomElement prop = element.firstChildElement(QStringLiteral("property"));
+        while (!prop.isNull()) {
+            if (prop.attribute(QStringLiteral("name")) == name) {
+                return prop.text();
+            }
+            prop = prop.nextSiblingElement(QStringLiteral("property"));
+        }
+        return QString();
+    }
+
+    /** @brief Returns true if the output of a filter or transition depends on its position, not only on its input frames */
+    static bool isPositionDependent(const QDomElement &element)
+    {
+        static const QStringList services{QStringLiteral("dynamictext"), QStringLiteral("timer"), QStringLiteral("gpstext")};
+        if (services.contains(property(element, QStringLiteral("mlt_service")))) {
+            return true;
+        }
+        // A single keyframe is constant, look for animations with at least two keyframes
+        QDomElement prop = element.firstChildElement(QStringLiteral("property"));
+        while (!prop.isNull()) {
+            const QString value = prop.text();
+            if (value.contains(QLatin1Char('=')) && value.contains(QLatin1Char(';'))) {
+                return true;
+            }
+            prop = prop.nextSiblingElement(QStringLiteral("property"));
+        }
+        return false;
+    }
+
+    /** @brief The entries and blanks of a playlist with their position, listed once for all the chunks */
+    const QVector<PlaylistItem> &playlistItems(const QDomElement &element)
+    {
+        const QString id = element.attribute(QStringLiteral("id"));
+        auto it = m_playlists.find(id);
+        if (it != m_playlists.end()) {
+            return it.value();
+        }
+        QVector<PlaylistItem> items;
+        int position = 0;
+        QDomElement child = element.firstChildElement();
+        while (!child.isNull()) {
+            if (child.tagName() == QLatin1String("blank")) {
+                position += child.attribute(QStringLiteral("length")).toInt();
+            } else if (child.tagName() == QLatin1String("entry")) {
+                items.append({position, child});
+                position += child.attribute(QStringLiteral("out")).toInt() - child.attribute(QStringLiteral("in")).toInt() + 1;
+            }
+            child = child.nextSiblingElement();
+        }
+        return m_playlists.insert(id, items).value();
+    }
+
+    /** @brief The tracks and transitions of a tractor, listed once for all the chunks */
+    const QList<QDomElement> &tractorItems(const QDomElement &element)
+    {
+        const QString id = element.attribute(QStringLiteral("id"));
+        auto it = m_tractors.find(id);
+        if (it != m_tractors.end()) {
+            return it.value();
+        }
+        // Tracks and transitions can be direct children or in a multitrack / field element
+        QList<QDomElement> children;
+        QDomElement child = element.firstChildElement();
+        while (!child.isNull()) {
+            if (child.tagName() == QLatin1String("multitrack") || child.tagName() == QLatin1String("field")) {
+                QDomElement sub = child.firstChildElement();
+                while (!sub.isNull()) {
+                    children << sub;
+                    sub = sub.nextSiblingElement();
+                }
+            } else {
+                children << child;
+            }
+            child = child.nextSiblingElement();
+        }
+        return m_tractors.insert(id, children).value();
+    }
+
+    /** @brief Hash the filters and links of a service that apply to its frames @p start to @p end */
+    void hashAttached(QCryptographicHash &hash, const QDomElement &element, int start, int end, int offset)
+    {
+        QDomElement child = element.firstChildElement();
+        while (!child.isNull()) {
+            if (child.tagName() == QLatin1String("filter") || child.tagName() == QLatin1String("link")) {
+                hashRanged(hash, child, start, end, offset, 'F');
+            }
+            child = child.nextSiblingElement();
+        }
+    }
+
+    /** @brief Hash a filter or transition limited by its in and out attributes */
+    void hashRanged(QCryptographicHash &hash, const QDomElement &element, int start, int end, int offset, char type)
+    {
+        const int in = element.attribute(QStringLiteral("in"), QStringLiteral("0")).toInt();
+        const int out = element.hasAttribute(QStringLiteral("out")) ? element.attribute(QStringLiteral("out")).toInt() : INT_MAX;
+        const int first = qMax(start, in);
+        const int last = qMin(end, out);
+        if (last < first) {
+            return;
+        }
+        const Definition &def = definition(element);
+        hash.addData(def.properties);
+        addRange(hash, type, last - first, offset + first - start, def.positionDependent ? first - in : -1);
+        hashAttached(hash, element, first, last, offset + first - start);
+    }
+
+    void hashService(QCryptographicHash &hash, const QDomElement &element, int start, int end, int offset, int depth)
+    {
+        if (element.isNull() || depth > 32) {
+            return;
+        }
+        const QString tag = element.tagName();
+        if (tag == QLatin1String("playlist")) {
+            const QString playlistId = property(element, QStringLiteral("kdenlive:playlistid"));
+            if (playlistId == QLatin1String("timeline_preview") || playlistId == QLatin1String("timeline_overlay")) {
+                // The preview itself
+                return;
+            }
+            hash.addData(definition(element).properties);
+            hashAttached(hash, element, start, end, offset);
+            // A copy, the recursion can list other playlists
+            const QVector<PlaylistItem> items = playlistItems(element);
+            // Skip the entries that end before the chunk
+            auto item = std::upper_bound(items.cbegin(), items.cend(), start, [](int frame, const PlaylistItem &entry) { return frame < entry.position; });
+            if (item != items.cbegin()) {
+                --item;
+            }
+            for (; item != items.cend() && item->position <= end; ++item) {
+                const QDomElement &child = item->element;
+                const int position = item->position;
+                const int in = child.attribute(QStringLiteral("in")).toInt();
+                const int out = child.attribute(QStringLiteral("out")).toInt();
+                const int first = qMax(start, position);
+                const int last = qMin(end, position + out - in);
+                if (first <= last) {
+                    const int sourceStart = in + first - position;
+                    const int sourceEnd = in + last - position;
+                    hash.addData(QByteArrayLiteral("E"));
+                    hash.addData(definition(child).properties);
+                    hashService(hash, m_services.value(child.attribute(QStringLiteral("producer"))), sourceStart, sourceEnd, offset + first - start,
+                                depth + 1);
+                    hashAttached(hash, child, sourceStart, sourceEnd, offset + first - start);
+                }
+            }
+        } else if (tag == QLatin1String("tractor")) {
+            hash.addData(definition(element).properties);
+            hashAttached(hash, element, start, end, offset);
+            const QList<QDomElement> children = tractorItems(element);
+            int trackIndex = 0;
+            for (const QDomElement &item : children) {
+                if (item.tagName() == QLatin1String("track")) {
+                    const QString hide = item.attribute(QStringLiteral("hide"));
+                    // The preview is rendered without audio, tracks without video don't change it
+                    if (hide != QLatin1String("video") && hide != QLatin1String("both")) {
+                        addRange(hash, 'T', trackIndex, 0, 0);
+                        hashService(hash, m_services.value(item.attribute(QStringLiteral("producer"))), start, end, offset, depth + 1);
+                    }
+                    trackIndex++;
+                } else if (item.tagName() == QLatin1String("transition")) {
+                    hashRanged(hash, item, start, end, offset, 'C');
+                }
+            }
+        } else {
+            hash.addData(definition(element).properties);
+            // Color producers return the same frame at any position
+            const QString service = property(element, QStringLiteral("mlt_service"));
+            const bool still = service == QLatin1String("color") || service == QLatin1String("colour");
+            addRange(hash, 'P', still ? 0 : start, end - start, offset);
+            hashAttached(hash, element, start, end, offset);
+        }
+    }
+};
+} // namespace
+
+PreviewChunkStore::PreviewChunkStore(const QDir &dir)
+    : m_dir(dir)
+{
+}
+
+QString PreviewChunkStore::filePath(const QString &key, const QString &extension) const
+{
+    return m_dir.absoluteFilePath(QStringLiteral("%1.%2").arg(key, extension));
+}
+
+QString PreviewChunkStore::keyFromPath(const QString &path) const
+{
+    const QFileInfo info(path);
+    if (info.absoluteDir() != m_dir) {
+        return QString();
+    }
+    return info.completeBaseName();
+}
+
+bool PreviewChunkStore::isEmpty() const
+{
+    QDirIterator it(m_dir.absolutePath(), QDir::Files);
+    return !it.hasNext();
+}
+
+bool PreviewChunkStore::contains(const QString &key, const QString &extension) const
+{
+    const QFileInfo info(filePath(key, extension));
+    return info.exists() && info.size() > 0;
+}
+
+bool PreviewChunkStore::add(const QString &key, const QString &extension, const QString &file)
+{
+    const QString path = filePath(key, extension);
+    if (QFile::exists(path)) {
+        // Already rendered by another sequence
+        QFile::remove(file);
+        return true;
+    }
+    if (!QFile::rename(file, path)) {
+        QFile::remove(file);
+        return false;
+    }
+    CacheManager::get()->recordWrite(CachePreview, path);
+    return true;
+}
+
+void PreviewChunkStore::touch(const QString &key, const QString &extension)
+{
+    QFile file(filePath(key, extension));
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        CacheManager::get()->recordAccess(file.fileName());
+    }
+}
+
+int PreviewChunkStore::trim(const QSet<QString> &used, int maxUnused)
+{
+    QFileInfoList unused;
+    const QFileInfoList files = m_dir.entryInfoList(QDir::Files, QDir::Time);
+    for (const QFileInfo &info : files) {
+        if (!used.contains(info.completeBaseName())) {
+            unused << info;
+        }
+    }
+    // Files are sorted by modification time, the most recently used first
+    int removed = 0;
+    for (int i = maxUnused; i < unused.count(); ++i) {
+        if (QFile::remove(unused.at(i).absoluteFilePath())) {
+            CacheManager::get()->recordRemoval(unused.at(i).absoluteFilePath());
+            removed++;
+        }
+    }
+    return removed;
+}
+
+QMap<int, QString> PreviewChunkStore::chunkKeys(const QDomDocument &scene, const std::vector<int> &chunks, int chunkSize, const QByteArray &salt)
+{
+    QMap<int, QString> keys;
+    ChunkHasher hasher(scene);
+    for (int chunk : chunks) {
+        keys.insert(chunk, hasher.key(chunk, chunk + chunkSize - 1, salt));
+    }
+    return keys;
+}
@@ -0,0 +1,57 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QDir>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <vector>
+
+class QDomDocument;
+
+/** @class PreviewChunkStore
+    @brief A folder of rendered timeline preview chunks, named after a hash of their content.
+    The key of a chunk is computed from the MLT XML of the timeline, limited to the frames of the chunk: the producers and their
+    source frames, the track and clip effects, the compositions and the render parameters. Chunks with the same content get
+    the same key whatever their position, so an undo, a redo or a move by whole chunks finds the previously rendered file.
+    The store is shared by all the sequences of a project.
+ */
+class PreviewChunkStore
+{
+public:
+    explicit PreviewChunkStore(const QDir &dir);
+
+    const QDir &dir() const { return m_dir; }
+    /** @brief The file of the chunk @p key, it may not exist */
+    QString filePath(const QString &key, const QString &extension) const;
+    /** @brief Returns the key of a chunk file, or an empty string if the file is not in the store */
+    QString keyFromPath(const QString &path) const;
+    /** @brief Returns true if no chunk was rendered yet, no key can then be found */
+    bool isEmpty() const;
+    bool contains(const QString &key, const QString &extension) const;
+    /** @brief Move a rendered chunk into the store
+     *  @returns false if the file could not be moved, in which case it is deleted
+     */
+    bool add(const QString &key, const QString &extension, const QString &file);
+    /** @brief Mark a chunk as recently used */
+    void touch(const QString &key, const QString &extension);
+    /** @brief Delete the least recently used chunks that are not in @p used, keeping at most @p maxUnused of them
+     *  @returns the number of deleted chunks
+     */
+    int trim(const QSet<QString> &used, int maxUnused);
+
+    /** @brief Compute the content keys of @p chunks, the definitions and the entries of the scene are only listed once for all the chunks.
+     *  This is slow for long timelines and can be called from any thread.
+     *  @param scene the MLT XML of the timeline, with the kdenlive properties stored
+     *  @param salt the render parameters, chunks rendered with other parameters get other keys
+     *  @returns the key of each chunk, by chunk start frame
+     */
+    static QMap<int, QString> chunkKeys(const QDomDocument &scene, const std::vector<int> &chunks, int chunkSize, const QByteArray &salt);
+
+private:
+    QDir m_dir;
+};
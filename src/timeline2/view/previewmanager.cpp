@@ -16,15 +16,20 @@
 #include "profiles/profilemodel.hpp"
 #include "timeline2/view/timelinecontroller.h"
 #include "timeline2/view/timelinewidget.h"
+#include "utils/cachemanager.hpp"
 #include "xml/xml.hpp"
 
 #include <KLocalizedString>
 #include <KMessageBox>
-#include <QCollator>
 #include <QCryptographicHash>
+#include <QDomDocument>
+#include <QFutureWatcher>
 #include <QMutexLocker>
 #include <QSaveFile>
 #include <QStandardPaths>
+#include <QtConcurrent>
+#include <localeHandling.h>
+#include <mlt++/MltConsumer.h>
 
 PreviewManager::PreviewManager(Mlt::Tractor *tractor, QUuid uuid, QObject *parent)
     : QObject(parent)
@@ -36,6 +41,8 @@ PreviewManager::PreviewManager(Mlt::Tractor *tractor, QUuid uuid, QObject *paren
     , m_warnOnCrash(true)
     , m_previewTrackIndex(-1)
     , m_initialized(false)
+    , m_renderedChunks(KdenliveSettings::timelinechunks())
+    , m_dirtyChunks(KdenliveSettings::timelinechunks())
 {
     m_previewGatherTimer.setSingleShot(true);
     m_previewGatherTimer.setInterval(200);
@@ -58,13 +65,14 @@ PreviewManager::~PreviewManager()
 {
     if (m_initialized) {
         abortRendering();
-        if (m_undoDir.dirName() == QLatin1String("undo")) {
-            m_undoDir.removeRecursively();
-        }
-        if ((pCore->currentDoc()->url().isEmpty() && m_cacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot).isEmpty()) ||
+        // The chunk store of an unsaved project cannot be reused
+        QStringList subDirs = m_cacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        subDirs.removeAll(QStringLiteral("store"));
+        if ((pCore->currentDoc()->url().isEmpty() && subDirs.isEmpty()) ||
             m_cacheDir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot).isEmpty()) {
             if (m_cacheDir.dirName() == QLatin1String("preview")) {
                 m_cacheDir.removeRecursively();
+                CacheManager::get()->recordFolderRemoval(m_cacheDir.absolutePath());
             }
         }
     }
@@ -91,14 +99,13 @@ bool PreviewManager::initialize()
         return false;
     }
     if (m_uuid == doc->uuid()) {
-        if (m_cacheDir.dirName() != QLatin1String("preview") || m_cacheDir == QDir() ||
-            (!m_cacheDir.exists(QStringLiteral("undo")) && !m_cacheDir.mkdir(QStringLiteral("undo"))) || !m_cacheDir.absolutePath().contains(documentId)) {
+        if (m_cacheDir.dirName() != QLatin1String("preview") || m_cacheDir == QDir() || !m_cacheDir.absolutePath().contains(documentId)) {
             pCore->displayMessage(i18n("Something is wrong with cache folder %1", m_cacheDir.absolutePath()), ErrorMessage);
             return false;
         }
     } else {
         if (m_cacheDir.dirName().toLatin1() != QCryptographicHash::hash(m_uuid.toByteArray(), QCryptographicHash::Md5).toHex() || m_cacheDir == QDir() ||
-            (!m_cacheDir.exists(QStringLiteral("undo")) && !m_cacheDir.mkdir(QStringLiteral("undo"))) || !m_cacheDir.absolutePath().contains(documentId)) {
+            !m_cacheDir.absolutePath().contains(documentId)) {
             pCore->displayMessage(i18n("Something is wrong with cache folder %1", m_cacheDir.absolutePath()), ErrorMessage);
             return false;
         }
@@ -107,16 +114,23 @@ bool PreviewManager::initialize()
         pCore->displayMessage(i18n("Invalid timeline preview parameters"), ErrorMessage);
         return false;
     }
-    m_undoDir = QDir(m_cacheDir.absoluteFilePath(QStringLiteral("undo")));
+    // All the sequences of the project share the chunk store
+    QDir storeDir = doc->getCacheDir(CachePreview, &ok);
 
     // Make sure our cache dirs are inside the temporary folder
-    if (!m_cacheDir.makeAbsolute() || !m_undoDir.makeAbsolute() || !m_undoDir.mkpath(QStringLiteral("."))) {
+    if (!ok || !m_cacheDir.makeAbsolute() || !storeDir.makeAbsolute() || !storeDir.absolutePath().contains(documentId) ||
+        !storeDir.mkpath(QStringLiteral("store")) || !storeDir.cd(QStringLiteral("store"))) {
         pCore->displayMessage(i18n("Something is wrong with cache folders"), ErrorMessage);
         return false;
     }
+    m_store = std::make_unique<PreviewChunkStore>(storeDir);
+    // Undo history of previous versions, replaced by the store
+    QDir undoDir = m_cacheDir;
+    if (undoDir.cd(QStringLiteral("undo"))) {
+        undoDir.removeRecursively();
+    }
 
     connect(this, &PreviewManager::cleanupOldPreviews, this, &PreviewManager::doCleanupOldPreviews);
-    connect(doc, &KdenliveDoc::removeInvalidUndo, this, &PreviewManager::slotRemoveInvalidUndo, Qt::DirectConnection);
     m_previewTimer.setSingleShot(true);
     m_previewTimer.setInterval(3000);
     connect(&m_previewTimer, &QTimer::timeout, this, &PreviewManager::startPreviewRender);
@@ -141,7 +155,7 @@ bool PreviewManager::buildPreviewTrack()
     return true;
 }
 
-void PreviewManager::loadChunks(QVariantList previewChunks, QVariantList dirtyChunks, Mlt::Playlist &playlist)
+void PreviewManager::loadChunks(ChunkSet previewChunks, ChunkSet dirtyChunks, Mlt::Playlist &playlist)
 {
     if (previewChunks.isEmpty()) {
         previewChunks = m_renderedChunks;
@@ -150,45 +164,44 @@ void PreviewManager::loadChunks(QVariantList previewChunks, QVariantList dirtyCh
         dirtyChunks = m_dirtyChunks;
     }
 
-    QStringList existingChuncks;
-    if (!previewChunks.isEmpty()) {
-        existingChuncks = m_cacheDir.entryList(QDir::Files);
-    }
-
     int max = playlist.count();
     std::shared_ptr<Mlt::Producer> clip;
     m_tractor->lock();
     if (max == 0) {
         // Empty timeline preview, mark all as dirty
-        for (auto &prev : previewChunks) {
-            dirtyChunks << prev;
-        }
+        dirtyChunks.unite(previewChunks);
     }
     for (int i = 0; i < max; i++) {
         if (playlist.is_blank(i)) {
             continue;
         }
         int position = playlist.clip_start(i);
-        if (previewChunks.contains(QString::number(position))) {
-            if (existingChuncks.contains(QString("%1.%2").arg(position).arg(m_extension))) {
-                clip.reset(playlist.get_clip(i));
-                m_renderedChunks << position;
+        if (previewChunks.contains(position)) {
+            clip.reset(playlist.get_clip(i));
+            const QString resource = QString::fromUtf8(clip->parent().get("resource"));
+            if (QFileInfo::exists(resource)) {
+                m_dirtyMutex.lock();
+                m_renderedChunks.insert(position);
+                // Chunks rendered by previous versions are named after their position and have no key
+                const QString key = m_store->keyFromPath(resource);
+                if (!key.isEmpty()) {
+                    m_chunkKeys.insert(position, key);
+                    m_store->touch(key, m_extension);
+                }
+                m_dirtyMutex.unlock();
                 m_previewTrack->insert_at(position, clip.get(), 1);
             } else {
-                dirtyChunks << position;
+                dirtyChunks.insert(position);
             }
         }
     }
     m_previewTrack->consolidate_blanks();
     m_tractor->unlock();
     if (!dirtyChunks.isEmpty()) {
-        std::sort(dirtyChunks.begin(), dirtyChunks.end(), chunkSort);
         QMutexLocker lock(&m_dirtyMutex);
-        for (const auto &i : qAsConst(dirtyChunks)) {
-            if (!m_dirtyChunks.contains(i)) {
-                m_dirtyChunks << i;
-            }
-        }
+        m_dirtyChunks.unite(dirtyChunks);
+        m_dirtyChunks.subtract(m_renderedChunks);
+        lock.unlock();
         Q_EMIT dirtyChunksChanged();
     }
     if (!previewChunks.isEmpty()) {
@@ -202,8 +215,11 @@ void PreviewManager::deletePreviewTrack()
     disconnectTrack();
     delete m_previewTrack;
     m_previewTrack = nullptr;
+    m_dirtyMutex.lock();
     m_dirtyChunks.clear();
     m_renderedChunks.clear();
+    m_chunkKeys.clear();
+    m_dirtyMutex.unlock();
     Q_EMIT dirtyChunksChanged();
     Q_EMIT renderedChunksChanged();
     m_tractor->unlock();
@@ -324,105 +340,187 @@ void PreviewManager::invalidatePreviews()
         m_previewTimer.stop();
         timer = true;
     }
-    KdenliveDoc *doc = pCore->currentDoc();
-    int stackIx = doc->commandStack()->index();
-    int stackMax = doc->commandStack()->count();
-    if (stackIx == stackMax && !m_undoDir.exists(QString::number(stackIx - 1))) {
-        // We just added a new command in stack, archive existing chunks
-        int ix = stackIx - 1;
-        m_undoDir.mkdir(QString::number(ix));
-        bool foundPreviews = false;
-        for (const auto &i : m_dirtyChunks) {
-            QString current = QStringLiteral("%1.%2").arg(i.toInt()).arg(m_extension);
-            if (m_cacheDir.rename(current, QStringLiteral("undo/%1/%2").arg(ix).arg(current))) {
-                foundPreviews = true;
-            }
-        }
-        if (!foundPreviews) {
-            // No preview files found, remove undo folder
-            m_undoDir.rmdir(QString::number(ix));
+    if (m_renderPending) {
+        // The playlist waiting for its keys is outdated, render again with the new one
+        m_renderPending = false;
+        timer = true;
+    }
+    // After an undo, a redo or a move, the content of some dirty chunks may already be in the store
+    requestKeys(false);
+    pCore->currentDoc()->setModified(true);
+    if (timer) {
+        m_previewTimer.start();
+    }
+}
+
+QByteArray PreviewManager::keySalt() const
+{
+    const bool useOriginals = !KdenliveSettings::proxypreview() && pCore->currentDoc()->useProxy();
+    const QStringList salt{pCore->getCurrentProfilePath(), QString::number(KdenliveSettings::timelinechunks()), m_extension,
+                           m_consumerParams.join(QLatin1Char(' ')), QString::number(int(useOriginals))};
+    return salt.join(QLatin1Char('\n')).toUtf8();
+}
+
+void PreviewManager::requestKeys(bool render)
+{
+    m_dirtyMutex.lock();
+    std::vector<int> dirty = m_dirtyChunks.chunks();
+    m_dirtyMutex.unlock();
+    const int request = ++m_keysRequest;
+    m_renderPending = render;
+    m_keysPending = false;
+    if (dirty.empty() || (!render && m_store->isEmpty())) {
+        // No key can be found in the store, don't serialize the timeline
+        m_renderPending = false;
+        return;
+    }
+    QString scene;
+    {
+        QWriteLocker lock(&pCore->xmlMutex);
+        LocaleHandling::resetLocale();
+        Mlt::Consumer xmlConsumer(pCore->getProjectProfile(), "xml", "kdenlive_chunks");
+        if (!xmlConsumer.is_valid()) {
+            m_renderPending = false;
+            return;
+        }
+        // Keep the kdenlive properties to recognize the preview track, positions are written as frames
+        xmlConsumer.set("store", "kdenlive");
+        xmlConsumer.set("no_meta", 1);
+        Mlt::Service service(m_tractor->get_service());
+        xmlConsumer.connect(service);
+        xmlConsumer.run();
+        scene = QString::fromUtf8(xmlConsumer.get("kdenlive_chunks"));
+    }
+    const int chunkSize = KdenliveSettings::timelinechunks();
+    const QByteArray salt = keySalt();
+    m_keysPending = true;
+    auto *watcher = new QFutureWatcher<QMap<int, QString>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, request]() {
+        watcher->deleteLater();
+        // The timeline changed again since this computation started
+        if (request == m_keysRequest) {
+            m_keysPending = false;
+            restoreChunks(watcher->result());
+        }
+    });
+    // Parsing and hashing a long timeline is slow, don't block the interface
+    watcher->setFuture(QtConcurrent::run([scene, dirty, chunkSize, salt]() {
+        QDomDocument doc;
+        doc.setContent(scene);
+        return PreviewChunkStore::chunkKeys(doc, dirty, chunkSize, salt);
+    }));
+}
+
+void PreviewManager::restoreChunks(QMap<int, QString> keys)
+{
+    ChunkSet foundChunks(KdenliveSettings::timelinechunks());
+    QMap<int, QString> foundKeys;
+    m_dirtyMutex.lock();
+    for (auto it = keys.begin(); it != keys.end();) {
+        if (!m_dirtyChunks.contains(it.key())) {
+            // Removed from the preview zone while the keys were computed
+            it = keys.erase(it);
+        } else if (m_store->contains(it.value(), m_extension)) {
+            m_store->touch(it.value(), m_extension);
+            foundChunks.insert(it.key());
+            foundKeys.insert(it.key(), it.value());
+            it = keys.erase(it);
         } else {
-            // new chunks archived, cleanup old ones
-            Q_EMIT cleanupOldPreviews();
-        }
-    } else {
-        // Restore existing chunks, delete others
-        // Check if we just undo the last stack action, then backup, otherwise delete
-        bool lastUndo = false;
-        if (stackIx + 1 == stackMax) {
-            if (!m_undoDir.exists(QString::number(stackMax))) {
-                lastUndo = true;
-                bool foundPreviews = false;
-                m_undoDir.mkdir(QString::number(stackMax));
-                for (const auto &i : m_dirtyChunks) {
-                    QString current = QStringLiteral("%1.%2").arg(i.toInt()).arg(m_extension);
-                    if (m_cacheDir.rename(current, QStringLiteral("undo/%1/%2").arg(stackMax).arg(current))) {
-                        foundPreviews = true;
-                    }
-                }
-                if (!foundPreviews) {
-                    m_undoDir.rmdir(QString::number(stackMax));
-                }
-            }
+            ++it;
         }
-        bool moveFile = true;
-        QDir tmpDir = m_undoDir;
-        if (!tmpDir.cd(QString::number(stackIx))) {
-            moveFile = false;
+    }
+    if (!foundChunks.isEmpty()) {
+        m_dirtyChunks.subtract(foundChunks);
+        m_renderedChunks.unite(foundChunks);
+        m_chunkKeys.insert(foundKeys);
+    }
+    m_dirtyMutex.unlock();
+    if (!foundChunks.isEmpty()) {
+        Q_EMIT dirtyChunksChanged();
+        Q_EMIT renderedChunksChanged();
+        reloadChunks(foundChunks);
+    }
+    if (m_renderPending) {
+        m_renderPending = false;
+        startRenderProcess(keys);
+    }
+}
+
+QSet<QString> PreviewManager::usedKeys() const
+{
+    QMutexLocker lock(&m_dirtyMutex);
+    QSet<QString> keys;
+    for (const QString &key : m_chunkKeys) {
+        keys.insert(key);
+    }
+    for (const QString &key : m_renderKeys) {
+        keys.insert(key);
+    }
+    return keys;
+}
+
+QSet<QString> PreviewManager::previewTrackKeys(Mlt::Tractor &tractor) const
+{
+    QSet<QString> keys;
+    for (int i = 0; i < tractor.count(); ++i) {
+        std::unique_ptr<Mlt::Producer> track(tractor.track(i));
+        if (!track || qstrcmp(track->get("kdenlive:playlistid"), "timeline_preview") != 0) {
+            continue;
         }
-        QVariantList foundChunks;
-        for (const auto &i : m_dirtyChunks) {
-            QString cacheFileName = QStringLiteral("%1.%2").arg(i.toInt()).arg(m_extension);
-            if (!lastUndo) {
-                m_cacheDir.remove(cacheFileName);
-            }
-            if (moveFile) {
-                if (QFile::copy(tmpDir.absoluteFilePath(cacheFileName), m_cacheDir.absoluteFilePath(cacheFileName))) {
-                    foundChunks << i;
-                } else {
-                    qDebug() << "// ERROR PROCESSE CHUNK: " << i << ", " << cacheFileName;
-                }
+        Mlt::Playlist playlist(*track.get());
+        for (int j = 0; j < playlist.count(); ++j) {
+            if (playlist.is_blank(j)) {
+                continue;
             }
-        }
-        if (!foundChunks.isEmpty()) {
-            std::sort(foundChunks.begin(), foundChunks.end(), chunkSort);
-            m_dirtyMutex.lock();
-            for (auto &ck : foundChunks) {
-                m_dirtyChunks.removeAll(ck);
-                m_renderedChunks << ck;
+            std::unique_ptr<Mlt::Producer> clip(playlist.get_clip(j));
+            const QString key = m_store->keyFromPath(QString::fromUtf8(clip->parent().get("resource")));
+            if (!key.isEmpty()) {
+                keys.insert(key);
             }
-            m_dirtyMutex.unlock();
-            Q_EMIT dirtyChunksChanged();
-            Q_EMIT renderedChunksChanged();
-            reloadChunks(foundChunks);
         }
     }
-    doc->setModified(true);
-    if (timer) {
-        m_previewTimer.start();
+    return keys;
+}
+
+QString PreviewManager::chunkPath(int frame) const
+{
+    const QString key = m_chunkKeys.value(frame);
+    if (key.isEmpty()) {
+        return m_cacheDir.absoluteFilePath(QStringLiteral("%1.%2").arg(frame).arg(m_extension));
     }
+    return m_store->filePath(key, m_extension);
 }
 
 void PreviewManager::doCleanupOldPreviews()
 {
-    if (m_undoDir.dirName() != QLatin1String("undo")) {
+    if (m_store == nullptr || m_store->dir().dirName() != QLatin1String("store")) {
         return;
     }
-    QStringList dirs = m_undoDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-
-    // Use QCollator to do a natural sorting so that 10 is after 2
-    QCollator collator;
-    collator.setNumericMode(true);
-    std::sort(dirs.begin(), dirs.end(), [&collator](const QString &file1, const QString &file2) { return collator.compare(file1, file2) < 0; });
-    bool ok;
-    while (dirs.count() > 5) {
-        QDir tmp = m_undoDir;
-        QString dirName = dirs.takeFirst();
-        dirName.toInt(&ok);
-        if (ok && tmp.cd(dirName)) {
-            tmp.removeRecursively();
+    // The store is shared, keep the chunks used by all the sequences
+    KdenliveDoc *doc = pCore->currentDoc();
+    QSet<QString> used;
+    const QList<QUuid> uuids = doc->getTimelinesUuids();
+    for (const QUuid &uuid : uuids) {
+        std::shared_ptr<TimelineItemModel> timeline = doc->getTimeline(uuid, true);
+        if (timeline && timeline->hasTimelinePreview()) {
+            used.unite(timeline->previewManager()->usedKeys());
+        }
+    }
+    // Other sequences keep the chunks of their saved preview track
+    const QList<QUuid> sequences = pCore->projectItemModel()->getAllSequenceClips().keys();
+    for (const QUuid &uuid : sequences) {
+        std::shared_ptr<TimelineItemModel> timeline = doc->getTimeline(uuid, true);
+        if (timeline) {
+            if (!timeline->hasTimelinePreview()) {
+                used.unite(previewTrackKeys(*timeline->tractor()));
+            }
+        } else if (std::shared_ptr<Mlt::Tractor> tractor = pCore->projectItemModel()->getExtraTimeline(uuid.toString())) {
+            used.unite(previewTrackKeys(*tractor.get()));
         }
     }
+    used.unite(usedKeys());
+    // Keep as many unused chunks as used ones, so that undoing a large operation does not render again
+    m_store->trim(used, qMax(250, int(used.count())));
 }
 
 void PreviewManager::clearPreviewRange(bool resetZones)
@@ -432,15 +530,14 @@ void PreviewManager::clearPreviewRange(bool resetZones)
     m_tractor->lock();
     bool hasPreview = m_previewTrack != nullptr;
     QMutexLocker lock(&m_dirtyMutex);
-    for (const auto &ix : qAsConst(m_renderedChunks)) {
-        m_cacheDir.remove(QStringLiteral("%1.%2").arg(ix.toInt()).arg(m_extension));
-        if (!m_dirtyChunks.contains(ix)) {
-            m_dirtyChunks << ix;
+    for (int ix : m_renderedChunks.chunks()) {
+        if (!m_chunkKeys.contains(ix)) {
+            m_cacheDir.remove(QStringLiteral("%1.%2").arg(ix).arg(m_extension));
         }
         if (!hasPreview) {
             continue;
         }
-        int trackIx = m_previewTrack->get_clip_index_at(ix.toInt());
+        int trackIx = m_previewTrack->get_clip_index_at(ix);
         if (!m_previewTrack->is_blank(trackIx)) {
             Mlt::Producer *prod = m_previewTrack->replace_with_blank(trackIx);
             delete prod;
@@ -450,14 +547,19 @@ void PreviewManager::clearPreviewRange(bool resetZones)
         m_previewTrack->consolidate_blanks();
     }
     m_tractor->unlock();
+    m_dirtyChunks.unite(m_renderedChunks);
     m_renderedChunks.clear();
+    m_chunkKeys.clear();
     // Reload preview params
     loadParams();
     if (resetZones) {
         m_dirtyChunks.clear();
     }
+    lock.unlock();
     Q_EMIT renderedChunksChanged();
     Q_EMIT dirtyChunksChanged();
+    // The chunks stay in the store until they are the least recently used ones
+    Q_EMIT cleanupOldPreviews();
 }
 
 void PreviewManager::addPreviewRange(const QPoint zone, bool add)
@@ -465,22 +567,28 @@ void PreviewManager::addPreviewRange(const QPoint zone, bool add)
     int chunkSize = KdenliveSettings::timelinechunks();
     int startChunk = zone.x() / chunkSize;
     int endChunk = int(rintl(zone.y() / chunkSize));
-    QList<int> toRemove;
+    std::vector<int> toRemove;
     QMutexLocker lock(&m_dirtyMutex);
-    for (int i = startChunk; i <= endChunk; i++) {
-        int frame = i * chunkSize;
-        if (add) {
-            if (!m_renderedChunks.contains(frame) && !m_dirtyChunks.contains(frame)) {
-                m_dirtyChunks << frame;
+    if (add) {
+        // Only the chunks that are not rendered yet become dirty
+        ChunkSet range(chunkSize);
+        range.insert(startChunk * chunkSize, endChunk * chunkSize);
+        for (const auto &run : m_renderedChunks.runs()) {
+            if (run.first > endChunk * chunkSize) {
+                break;
             }
-        } else {
-            if (m_renderedChunks.contains(frame)) {
-                toRemove << frame;
-                m_renderedChunks.removeAll(frame);
-            } else {
-                m_dirtyChunks.removeAll(frame);
+            range.remove(run.first, run.second);
+        }
+        m_dirtyChunks.unite(range);
+    } else {
+        toRemove = m_renderedChunks.chunks(startChunk * chunkSize, endChunk * chunkSize);
+        for (int ix : toRemove) {
+            if (m_chunkKeys.remove(ix) == 0) {
+                m_cacheDir.remove(QStringLiteral("%1.%2").arg(ix).arg(m_extension));
             }
         }
+        m_renderedChunks.remove(startChunk * chunkSize, endChunk * chunkSize);
+        m_dirtyChunks.remove(startChunk * chunkSize, endChunk * chunkSize);
     }
     if (add) {
         Q_EMIT dirtyChunksChanged();
@@ -494,8 +602,7 @@ void PreviewManager::addPreviewRange(const QPoint zone, bool add)
         abortRendering();
         m_tractor->lock();
         bool hasPreview = m_previewTrack != nullptr;
-        for (int ix : qAsConst(toRemove)) {
-            m_cacheDir.remove(QStringLiteral("%1.%2").arg(ix).arg(m_extension));
+        for (int ix : toRemove) {
             if (!hasPreview) {
                 continue;
             }
@@ -519,6 +626,8 @@ void PreviewManager::addPreviewRange(const QPoint zone, bool add)
 
 void PreviewManager::abortRendering()
 {
+    // Don't start the render waiting for its keys
+    m_renderPending = false;
     if (m_previewProcess.state() == QProcess::NotRunning) {
         return;
     }
@@ -592,11 +701,29 @@ void PreviewManager::doPreviewRender(const QString &scene)
     if (m_dirtyChunks.isEmpty()) {
         return;
     }
+    // Only render the chunks that are not already in the store, once their keys are known
+    m_renderScene = scene;
+    requestKeys(true);
+}
+
+void PreviewManager::startRenderProcess(const QMap<int, QString> &renderKeys)
+{
+    const QString scene = m_renderScene;
+    m_renderScene.clear();
     QMutexLocker lock(&m_dirtyMutex);
     Q_ASSERT(m_previewProcess.state() == QProcess::NotRunning);
-    std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end(), chunkSort);
-    const QStringList dirtyChunks = getCompressedList(m_dirtyChunks);
-    m_chunksToRender = m_dirtyChunks.count();
+    m_renderKeys = renderKeys;
+    ChunkSet toRender(KdenliveSettings::timelinechunks());
+    for (auto it = m_renderKeys.cbegin(); it != m_renderKeys.cend(); ++it) {
+        toRender.insert(it.key());
+    }
+    if (toRender.isEmpty()) {
+        QFile::remove(scene);
+        pCore->currentDoc()->previewProgress(1000);
+        return;
+    }
+    const QStringList dirtyChunks = toRender.toStringList();
+    m_chunksToRender = toRender.count();
     m_processedChunks = 0;
     int chunkSize = KdenliveSettings::timelinechunks();
     QStringList args{QStringLiteral("preview-chunks"),
@@ -630,6 +757,10 @@ void PreviewManager::processEnded(int exitCode, QProcess::ExitStatus status)
         // Normal exit and exit code 0: everything okay
         pCore->currentDoc()->previewProgress(1000);
     }
+    m_dirtyMutex.lock();
+    m_renderKeys.clear();
+    m_dirtyMutex.unlock();
+    Q_EMIT cleanupOldPreviews();
     workingPreview = -1;
     m_warnOnCrash = true;
     Q_EMIT workingPreviewChanged();
@@ -646,25 +777,6 @@ void PreviewManager::slotProcessDirtyChunks()
     }
 }
 
-void PreviewManager::slotRemoveInvalidUndo(int ix)
-{
-    QMutexLocker lock(&m_previewMutex);
-    if (m_undoDir.dirName() != QLatin1String("undo")) {
-        // Make sure we delete correct folder
-        return;
-    }
-    QStringList dirs = m_undoDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    bool ok;
-    for (const QString &dir : qAsConst(dirs)) {
-        if (dir.toInt(&ok) >= ix && ok) {
-            QDir tmp = m_undoDir;
-            if (tmp.cd(dir)) {
-                tmp.removeRecursively();
-            }
-        }
-    }
-}
-
 void PreviewManager::invalidatePreview(int startFrame, int endFrame)
 {
     if (m_previewTrack == nullptr) {
@@ -676,47 +788,34 @@ void PreviewManager::invalidatePreview(int startFrame, int endFrame)
 
     m_previewGatherTimer.stop();
     bool previewWasRunning = m_previewProcess.state() == QProcess::Running;
-    bool alreadyRendered = false;
-    bool wasInDirtyZone = false;
-    if (!m_renderedChunks.isEmpty()) {
-        // Check if the invalidated zone was already rendered
-        std::sort(m_renderedChunks.begin(), m_renderedChunks.end(), chunkSort);
-        if (start <= m_renderedChunks.last().toInt() && end >= m_renderedChunks.first().toInt()) {
-            alreadyRendered = true;
-        } else if (workingPreview >= start && workingPreview <= end) {
-            alreadyRendered = true;
-        }
-    }
-    if (!alreadyRendered && !m_dirtyChunks.isEmpty()) {
-        // Check if the invalidate zone is in the current todo list (dirtychunks)
-        std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end(), chunkSort);
-        if (start <= m_dirtyChunks.last().toInt() && end >= m_dirtyChunks.first().toInt()) {
-            wasInDirtyZone = true;
-        }
-    }
+    QMutexLocker lock(&m_dirtyMutex);
+    // Check if the invalidated zone was already rendered, or is in the current todo list (dirtychunks)
+    const bool alreadyRendered = m_renderedChunks.intersects(start, end) || (workingPreview >= start && workingPreview <= end);
+    const bool wasInDirtyZone = !alreadyRendered && m_dirtyChunks.intersects(start, end);
+    lock.unlock();
     if (alreadyRendered) {
         if (previewWasRunning) {
             abortRendering();
         }
         m_tractor->lock();
         bool chunksChanged = false;
-        for (int i = start; i <= end; i += chunkSize) {
-            if (m_renderedChunks.contains(i)) {
-                int ix = m_previewTrack->get_clip_index_at(i);
-                if (m_previewTrack->is_blank(ix)) {
-                    continue;
-                }
-                Mlt::Producer *prod = m_previewTrack->replace_with_blank(ix);
-                delete prod;
-                QVariant val(i);
-                m_renderedChunks.removeAll(val);
-                if (!m_dirtyChunks.contains(val)) {
-                    QMutexLocker lock(&m_dirtyMutex);
-                    m_dirtyChunks << val;
-                    chunksChanged = true;
-                }
+        lock.relock();
+        for (int i : m_renderedChunks.chunks(start, end)) {
+            int ix = m_previewTrack->get_clip_index_at(i);
+            if (m_previewTrack->is_blank(ix)) {
+                continue;
             }
+            Mlt::Producer *prod = m_previewTrack->replace_with_blank(ix);
+            delete prod;
+            // Keyed chunks stay in the store for a later undo
+            if (m_chunkKeys.remove(i) == 0) {
+                m_cacheDir.remove(QStringLiteral("%1.%2").arg(i).arg(m_extension));
+            }
+            m_renderedChunks.remove(i);
+            m_dirtyChunks.insert(i);
+            chunksChanged = true;
         }
+        lock.unlock();
         m_tractor->unlock();
         if (chunksChanged) {
             m_previewTrack->consolidate_blanks();
@@ -735,21 +834,21 @@ void PreviewManager::invalidatePreview(int startFrame, int endFrame)
     m_previewGatherTimer.start();
 }
 
-void PreviewManager::reloadChunks(const QVariantList &chunks)
+void PreviewManager::reloadChunks(const ChunkSet &chunks)
 {
     if (m_previewTrack == nullptr || chunks.isEmpty()) {
         return;
     }
     m_tractor->lock();
-    for (const auto &ix : chunks) {
-        if (m_previewTrack->is_blank_at(ix.toInt())) {
-            QString fileName = m_cacheDir.absoluteFilePath(QStringLiteral("%1.%2").arg(ix.toInt()).arg(m_extension));
+    for (int ix : chunks.chunks()) {
+        if (m_previewTrack->is_blank_at(ix)) {
+            QString fileName = chunkPath(ix);
             fileName.prepend(QStringLiteral("avformat:"));
             Mlt::Producer prod(pCore->getProjectProfile(), fileName.toUtf8().constData());
             if (prod.is_valid()) {
                 // m_ruler->updatePreview(ix, true);
                 prod.set("mlt_service", "avformat-novalidate");
-                m_previewTrack->insert_at(ix.toInt(), &prod, 1);
+                m_previewTrack->insert_at(ix, &prod, 1);
             }
         }
     }
@@ -781,12 +880,27 @@ void PreviewManager::gotPreviewRender(int frame, const QString &file, int progre
         return;
     }
     if (m_previewTrack->is_blank_at(frame)) {
-        Mlt::Producer prod(pCore->getProjectProfile(), QString("avformat:%1").arg(file).toUtf8().constData());
+        QString chunkFile = file;
+        m_dirtyMutex.lock();
+        const QString key = m_renderKeys.value(frame);
+        m_dirtyMutex.unlock();
+        if (!key.isEmpty()) {
+            if (!m_store->add(key, m_extension, file)) {
+                qCDebug(KDENLIVE_LOG) << "* * * CANNOT STORE CHUNK: " << file;
+                corruptedChunk(frame, file);
+                return;
+            }
+            chunkFile = m_store->filePath(key, m_extension);
+        }
+        Mlt::Producer prod(pCore->getProjectProfile(), QString("avformat:%1").arg(chunkFile).toUtf8().constData());
         if (prod.is_valid() && prod.get_length() == KdenliveSettings::timelinechunks()) {
             m_dirtyMutex.lock();
-            m_dirtyChunks.removeAll(QVariant(frame));
+            m_dirtyChunks.remove(frame);
+            m_renderedChunks.insert(frame);
+            if (!key.isEmpty()) {
+                m_chunkKeys.insert(frame, key);
+            }
             m_dirtyMutex.unlock();
-            m_renderedChunks << frame;
             Q_EMIT renderedChunksChanged();
             prod.set("mlt_service", "avformat-novalidate");
             m_tractor->lock();
@@ -796,8 +910,8 @@ void PreviewManager::gotPreviewRender(int frame, const QString &file, int progre
             pCore->currentDoc()->previewProgress(progress);
             pCore->currentDoc()->setModified(true);
         } else {
-            qCDebug(KDENLIVE_LOG) << "* * * INVALID PROD: " << file;
-            corruptedChunk(frame, file);
+            qCDebug(KDENLIVE_LOG) << "* * * INVALID PROD: " << chunkFile;
+            corruptedChunk(frame, chunkFile);
         }
     } else {
         qCDebug(KDENLIVE_LOG) << "* * * NON EMPTY PROD: " << frame;
@@ -814,11 +928,8 @@ void PreviewManager::corruptedChunk(int frame, const QString &fileName)
     }
     Q_EMIT previewRender(0, m_errorLog, -1);
     m_cacheDir.remove(fileName);
-    if (!m_dirtyChunks.contains(frame)) {
-        QMutexLocker lock(&m_dirtyMutex);
-        m_dirtyChunks << frame;
-        std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end(), chunkSort);
-    }
+    QMutexLocker lock(&m_dirtyMutex);
+    m_dirtyChunks.insert(frame);
 }
 
 int PreviewManager::setOverlayTrack(Mlt::Playlist *overlay)
@@ -839,48 +950,7 @@ void PreviewManager::removeOverlayTrack()
 QPair<QStringList, QStringList> PreviewManager::previewChunks()
 {
     QMutexLocker lock(&m_dirtyMutex);
-    std::sort(m_renderedChunks.begin(), m_renderedChunks.end(), chunkSort);
-    const QStringList renderedChunks = getCompressedList(m_renderedChunks);
-    std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end(), chunkSort);
-    const QStringList dirtyChunks = getCompressedList(m_dirtyChunks);
-    lock.unlock();
-    return {renderedChunks, dirtyChunks};
-}
-
-const QStringList PreviewManager::getCompressedList(const QVariantList items) const
-{
-    QStringList resultString;
-    int lastFrame = -1;
-    QString currentString;
-    for (const QVariant &frame : items) {
-        int current = frame.toInt();
-        if (current - KdenliveSettings::timelinechunks() == lastFrame) {
-            lastFrame = current;
-            if (frame == items.last()) {
-                currentString.append(QString("-%1").arg(lastFrame));
-                resultString << currentString;
-                currentString.clear();
-            }
-            continue;
-        }
-        if (currentString.isEmpty()) {
-            currentString = frame.toString();
-        } else if (currentString == QString::number(lastFrame)) {
-            // Only one chunk, store it
-            resultString << currentString;
-            currentString = frame.toString();
-        } else {
-            // Range, store
-            currentString.append(QString("-%1").arg(lastFrame));
-            resultString << currentString;
-            currentString = frame.toString();
-        }
-        lastFrame = current;
-    }
-    if (!currentString.isEmpty()) {
-        resultString << currentString;
-    }
-    return resultString;
+    return {m_renderedChunks.toStringList(), m_dirtyChunks.toStringList()};
 }
 
 bool PreviewManager::hasOverlayTrack() const
@@ -908,5 +978,6 @@ int PreviewManager::addedTracks() const
 
 bool PreviewManager::isRunning() const
 {
-    return workingPreview >= 0 || m_previewProcess.state() != QProcess::NotRunning;
+    // A render waiting for the keys of its chunks has already started
+    return workingPreview >= 0 || m_renderPending || m_previewProcess.state() != QProcess::NotRunning;
 }
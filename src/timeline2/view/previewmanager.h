@@ -7,6 +7,8 @@
 #pragma once
 
 #include "definitions.h"
+#include "previewchunkstore.h"
+#include "utils/chunkset.hpp"
 
 #include <QDir>
 #include <QFuture>
@@ -14,6 +16,7 @@
 #include <QProcess>
 #include <QTimer>
 #include <QUuid>
+#include <memory>
 
 class TimelineController;
 
@@ -30,6 +33,8 @@ class Producer;
     This allow us to get a preview with a smooth playback of our project.
     Only the preview zone is rendered. Once defined, a preview zone shows as a red line below
     the timeline ruler. As chunks are rendered, the zone turns to green.
+    Rendered chunks are kept in a PreviewChunkStore, keyed by their content, so that undoing an
+    operation reuses the chunks rendered before it instead of rendering them again.
  */
 class PreviewManager : public QObject
 {
@@ -64,7 +69,7 @@ public:
     /** @brief: Returns directory currently used to store the preview files. */
     const QDir getCacheDir() const;
     /** @brief: Load existing ruler chunks. */
-    void loadChunks(QVariantList previewChunks, QVariantList dirtyChunks, Mlt::Playlist &playlist);
+    void loadChunks(ChunkSet previewChunks, ChunkSet dirtyChunks, Mlt::Playlist &playlist);
     int setOverlayTrack(Mlt::Playlist *overlay);
     /** @brief Remove the effect compare overlay track */
     void removeOverlayTrack();
@@ -91,8 +96,6 @@ private:
     QProcess m_previewProcess;
     /** @brief: The directory used to store the preview files. */
     QDir m_cacheDir;
-    /** @brief: The directory used to store undo history of preview files (child of m_cacheDir). */
-    QDir m_undoDir;
     QMutex m_previewMutex;
     QStringList m_consumerParams;
     QString m_extension;
@@ -109,25 +112,47 @@ private:
     int m_processedChunks;
     /** @brief: The render process output, useful in case of failure */
     QString m_errorLog;
-    /** @brief: After an undo/redo, if we have preview history, use it. */
-    void reloadChunks(const QVariantList &chunks);
+    /** @brief: The store of rendered chunks, shared with the other sequences of the project. */
+    std::unique_ptr<PreviewChunkStore> m_store;
+    /** @brief: The content keys of the rendered chunks, by chunk start frame. */
+    QMap<int, QString> m_chunkKeys;
+    /** @brief: The content keys of the chunks passed to the render process. */
+    QMap<int, QString> m_renderKeys;
+    /** @brief: Insert the rendered chunks in the preview track. */
+    void reloadChunks(const ChunkSet &chunks);
     /** @brief: A chunk failed to render, abort. */
     void corruptedChunk(int workingPreview, const QString &fileName);
-    /** @brief: Get a compressed list of chunks, like: "0-500,525,575". */
-    const QStringList getCompressedList(const QVariantList items) const;
-
-    /** @brief Compare two chunks for usage by std::sort
-     * @returns true if @param c1 is less than @param c2
+    /** @brief: The file of a rendered chunk, in the store if we know its key. */
+    QString chunkPath(int frame) const;
+    /** @brief: The render parameters that are part of the chunk keys. */
+    QByteArray keySalt() const;
+    /** @brief: Increased for each key computation, the results of the previous ones are then ignored. */
+    int m_keysRequest{0};
+    /** @brief: True if the chunks that are not in the store will be rendered once their keys are computed. */
+    bool m_renderPending{false};
+    /** @brief: True until the keys of the last request are applied. */
+    bool m_keysPending{false};
+    /** @brief: The playlist to render once the keys are computed. */
+    QString m_renderScene;
+    /** @brief: Compute the content keys of the dirty chunks in a worker thread, then call restoreChunks.
+     *  Only the serialization of the timeline runs in the calling thread.
+     *  @param render if true, the chunks that are not in the store are rendered, otherwise nothing is done if the store is empty
+     */
+    void requestKeys(bool render);
+    /** @brief: Insert the dirty chunks whose content is already in the store, and render the others if requested.
+     *  @param keys the keys of the dirty chunks
      */
-    static bool chunkSort(const QVariant &c1, const QVariant &c2) { return c1.toInt() < c2.toInt(); };
+    void restoreChunks(QMap<int, QString> keys);
+    /** @brief: Start the render process for the chunks in @p renderKeys. */
+    void startRenderProcess(const QMap<int, QString> &renderKeys);
+    /** @brief: The keys of the chunks in the saved preview track of a sequence that has no preview manager. */
+    QSet<QString> previewTrackKeys(Mlt::Tractor &tractor) const;
 
 private Q_SLOTS:
-    /** @brief: To avoid filling the hard drive, remove preview undo history after 5 steps. */
+    /** @brief: To avoid filling the hard drive, remove the least recently used chunks that are not in any sequence. */
     void doCleanupOldPreviews();
     /** @brief: Start the real rendering process. */
     void doPreviewRender(const QString &scene); // std::shared_ptr<Mlt::Producer> sourceProd);
-    /** @brief: If user does an undo, then makes a new timeline operation, delete undo history of more recent stack . */
-    void slotRemoveInvalidUndo(int ix);
     /** @brief: When the timer collecting invalid zones is done, process. */
     void slotProcessDirtyChunks();
     /** @brief: Process preview rendering output. */
@@ -143,9 +168,13 @@ public Q_SLOTS:
     void invalidatePreview(int startFrame, int endFrame);
 
 protected:
-    QVariantList m_renderedChunks;
-    QVariantList m_dirtyChunks;
+    /** @brief: The chunks that are rendered and inserted in the preview track. */
+    ChunkSet m_renderedChunks;
+    /** @brief: The chunks of the preview zone that need to be rendered, disjoint from the rendered chunks. */
+    ChunkSet m_dirtyChunks;
     mutable QMutex m_dirtyMutex;
+    /** @brief: The keys of the chunks used by this preview, they are never removed from the store. */
+    QSet<QString> usedKeys() const;
     /** @brief: Re-enable timeline preview track. */
     void enable();
     /** @brief: Temporarily disable timeline preview track. */
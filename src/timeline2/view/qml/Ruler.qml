@@ -64,10 +64,11 @@ Item {
         model: timeline.dirtyChunks
         anchors.fill: parent
         delegate: Rectangle {
-            x: modelData * timeline.scaleFactor
+            // Each item is a run of chunks, from x to y included
+            x: modelData.x * timeline.scaleFactor
             anchors.bottom: parent.bottom
             anchors.bottomMargin: zoneHeight
-            width: 25 * timeline.scaleFactor
+            width: (modelData.y - modelData.x + 25) * timeline.scaleFactor
             height: previewHeight
             color: 'darkred'
         }
@@ -77,10 +78,11 @@ Item {
         model: timeline.renderedChunks
         anchors.fill: parent
         delegate: Rectangle {
-            x: modelData * timeline.scaleFactor
+            // Each item is a run of chunks, from x to y included
+            x: modelData.x * timeline.scaleFactor
             anchors.bottom: parent.bottom
             anchors.bottomMargin: zoneHeight
-            width: 25 * timeline.scaleFactor
+            width: (modelData.y - modelData.x + 25) * timeline.scaleFactor
             height: previewHeight
             color: 'darkgreen'
         }
@@ -31,11 +31,27 @@ Item{
 
     width: clipRow.width
 
+    // Horizontal range, in pixels, where the clip and composition items are instantiated. Items further
+    // away are only unloaded when leaving the larger unload range, so that scrolling back and forth does not
+    // recreate them. The range only moves every half screen so that the delegates are not reevaluated on
+    // each scroll step.
+    readonly property real viewPage: Math.max(root.baseUnit, scrollView.width / 2)
+    readonly property real loadStart: Math.floor(scrollView.contentX / viewPage) * viewPage - scrollView.width
+    readonly property real loadEnd: loadStart + 3 * scrollView.width + viewPage
+    readonly property real unloadStart: loadStart - scrollView.width
+    readonly property real unloadEnd: loadEnd + scrollView.width
+
     DelegateModel {
         id: trackModel
         delegate: Item {
+            id: itemContainer
             property var itemModel : model
             property bool clipItem: isClip(model.clipType)
+            property real itemStart: model.start * root.timeScale
+            property real itemEnd: itemStart + model.duration * root.timeScale
+            // Items that are selected, dragged or trimmed must stay alive even when scrolled out of view
+            property bool keepLoaded: model.selected || model.isGrabbed || model.fakePosition > -1 || model.item === timeline.trimmingMainClip || model.item === dragProxy.draggedItem
+            property bool wasLoaded: false
             function calculateZIndex() {
                 // Z order indicates the items that will be drawn on top.
                 if (model.clipType == ProducerType.Composition) {
@@ -60,6 +76,13 @@ Item{
             z: calculateZIndex()
             Loader {
                 id: loader
+                active: itemContainer.keepLoaded || (itemContainer.itemEnd >= trackRoot.loadStart && itemContainer.itemStart <= trackRoot.loadEnd)
+                        || (itemContainer.wasLoaded && itemContainer.itemEnd >= trackRoot.unloadStart && itemContainer.itemStart <= trackRoot.unloadEnd)
+                onActiveChanged: {
+                    if (!active) {
+                        itemContainer.wasLoaded = false
+                    }
+                }
                 Binding {
                     target: loader.item
                     property: "speed"
@@ -305,6 +328,7 @@ Item{
                     }
                 }
                 onLoaded: {
+                    itemContainer.wasLoaded = true
                     item.clipId = model.item
                     item.parentTrack = trackRoot
                     if (clipItem) {
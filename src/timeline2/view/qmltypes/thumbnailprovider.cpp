@@ -14,9 +14,14 @@
 
 #include <QCryptographicHash>
 #include <QDebug>
+#include <limits>
 #include <mlt++/MltFilter.h>
 #include <mlt++/MltProfile.h>
 
+// Number of idle producers kept for a clip, and number of clips with pooled producers
+static const size_t maxIdleProducersPerClip = 3;
+static const size_t maxPooledClips = 8;
+
 ThumbnailProvider::ThumbnailProvider()
     : QQuickImageProvider(QQmlImageProviderBase::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading)
 {
@@ -45,19 +50,28 @@ QImage ThumbnailProvider::requestImage(const QString &id, QSize *size, const QSi
                 *size = result.size();
                 return result;
             }
-            std::unique_ptr<Mlt::Producer> prod = binClip->getThumbProducer();
-            if (prod && prod->is_valid()) {
-                if (binClip->clipType() != ClipType::Timeline && binClip->clipType() != ClipType::Playlist) {
-                    Mlt::Profile *prodProfile = &pCore->thumbProfile();
-                    Mlt::Filter scaler(*prodProfile, "swscale");
-                    Mlt::Filter padder(*prodProfile, "resize");
-                    Mlt::Filter converter(*prodProfile, "avcolor_space");
-                    prod->attach(scaler);
-                    prod->attach(padder);
-                    prod->attach(converter);
-                }
-                result = makeThumbnail(std::move(prod), frameNumber, requestedSize);
-                ThumbnailCache::get()->storeThumbnail(binId, frameNumber, result, false);
+            // If the same thumbnail is already being produced, wait for it instead of decoding it again
+            const QString requestKey = QStringLiteral("%1#%2").arg(binId).arg(frameNumber);
+            std::promise<QImage> promise;
+            std::shared_future<QImage> pending;
+            bool producing = false;
+            m_poolMutex.lock();
+            if (m_pending.contains(requestKey)) {
+                pending = m_pending.value(requestKey);
+            } else {
+                pending = promise.get_future().share();
+                m_pending.insert(requestKey, pending);
+                producing = true;
+            }
+            m_poolMutex.unlock();
+            if (producing) {
+                result = produceThumbnail(binClip, binId, frameNumber, requestedSize);
+                m_poolMutex.lock();
+                m_pending.remove(requestKey);
+                m_poolMutex.unlock();
+                promise.set_value(result);
+            } else {
+                result = pending.get();
             }
         }
     }
@@ -65,7 +79,104 @@ QImage ThumbnailProvider::requestImage(const QString &id, QSize *size, const QSi
     return result;
 }
 
-QImage ThumbnailProvider::makeThumbnail(std::unique_ptr<Mlt::Producer> producer, int frameNumber, const QSize &requestedSize)
+QImage ThumbnailProvider::produceThumbnail(const std::shared_ptr<ProjectClip> &binClip, const QString &binId, int frameNumber, const QSize &requestedSize)
+{
+    // Pooled producers are only valid as long as the clip's media doesn't change (proxy, reload, ...)
+    const QString key = binClip->hashForThumbs() + binClip->getProducerProperty(QStringLiteral("resource"));
+    std::unique_ptr<PooledProducer> pooled = takeProducer(binClip, binId, key, frameNumber);
+    if (!pooled) {
+        return QImage();
+    }
+    QImage result = makeThumbnail(pooled->producer.get(), frameNumber, requestedSize);
+    pooled->lastPosition = frameNumber;
+    if (!result.isNull()) {
+        ThumbnailCache::get()->storeThumbnail(binId, frameNumber, result, false);
+    }
+    if (binClip->clipType() != ClipType::Timeline && binClip->clipType() != ClipType::Playlist) {
+        releaseProducer(binId, key, std::move(pooled));
+    }
+    return result;
+}
+
+std::unique_ptr<ThumbnailProvider::PooledProducer> ThumbnailProvider::takeProducer(const std::shared_ptr<ProjectClip> &binClip, const QString &binId,
+                                                                                   const QString &key, int frameNumber)
+{
+    m_poolMutex.lock();
+    auto it = m_pool.find(binId);
+    if (it != m_pool.end()) {
+        ClipPool &pool = it->second;
+        if (pool.key != key) {
+            // Clip media changed, drop outdated producers
+            m_pool.erase(it);
+        } else if (!pool.idle.empty()) {
+            // Prefer the producer that decoded a frame just before the requested one,
+            // so that adjacent thumbnails are read sequentially from the same decoder
+            auto best = pool.idle.begin();
+            int bestDistance = std::numeric_limits<int>::max();
+            for (auto p = pool.idle.begin(); p != pool.idle.end(); ++p) {
+                int distance = frameNumber - (*p)->lastPosition;
+                if (distance < 0) {
+                    // Seeking backwards is more expensive
+                    distance = -4 * distance;
+                }
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            std::unique_ptr<PooledProducer> pooled = std::move(*best);
+            pool.idle.erase(best);
+            pool.lastUse = ++m_poolCounter;
+            m_poolMutex.unlock();
+            return pooled;
+        }
+    }
+    m_poolMutex.unlock();
+
+    // No idle producer, create a new one
+    std::unique_ptr<Mlt::Producer> prod = binClip->getThumbProducer();
+    if (!prod || !prod->is_valid()) {
+        return nullptr;
+    }
+    if (binClip->clipType() != ClipType::Timeline && binClip->clipType() != ClipType::Playlist) {
+        Mlt::Profile *prodProfile = &pCore->thumbProfile();
+        Mlt::Filter scaler(*prodProfile, "swscale");
+        Mlt::Filter padder(*prodProfile, "resize");
+        Mlt::Filter converter(*prodProfile, "avcolor_space");
+        prod->attach(scaler);
+        prod->attach(padder);
+        prod->attach(converter);
+    }
+    auto pooled = std::make_unique<PooledProducer>();
+    pooled->producer = std::move(prod);
+    return pooled;
+}
+
+void ThumbnailProvider::releaseProducer(const QString &binId, const QString &key, std::unique_ptr<PooledProducer> producer)
+{
+    QMutexLocker lock(&m_poolMutex);
+    ClipPool &pool = m_pool[binId];
+    if (pool.key != key) {
+        pool.key = key;
+        pool.idle.clear();
+    }
+    pool.lastUse = ++m_poolCounter;
+    if (pool.idle.size() < maxIdleProducersPerClip) {
+        pool.idle.push_back(std::move(producer));
+    }
+    // Release the decoders of the least recently used clips
+    while (m_pool.size() > maxPooledClips) {
+        auto oldest = m_pool.begin();
+        for (auto p = m_pool.begin(); p != m_pool.end(); ++p) {
+            if (p->second.lastUse < oldest->second.lastUse) {
+                oldest = p;
+            }
+        }
+        m_pool.erase(oldest);
+    }
+}
+
+QImage ThumbnailProvider::makeThumbnail(Mlt::Producer *producer, int frameNumber, const QSize &requestedSize)
 {
     Q_UNUSED(requestedSize)
     producer->seek(frameNumber);
@@ -9,10 +9,17 @@
 
 #include <KImageCache>
 #include <QCache>
+#include <QHash>
+#include <QMutex>
 #include <QQuickImageProvider>
+#include <future>
 #include <memory>
 #include <mlt++/MltProducer.h>
 #include <mlt++/MltProfile.h>
+#include <unordered_map>
+#include <vector>
+
+class ProjectClip;
 
 class ThumbnailProvider : public QQuickImageProvider
 {
@@ -22,6 +29,33 @@ public:
     QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
 
 private:
+    /** @brief A thumbnail producer with its scaling filters attached, ready to be seeked */
+    struct PooledProducer
+    {
+        std::unique_ptr<Mlt::Producer> producer;
+        /** @brief Position of the last decoded frame, used to pick the producer closest to a request */
+        int lastPosition{-1};
+    };
+    /** @brief The idle thumbnail producers of a bin clip */
+    struct ClipPool
+    {
+        /** @brief Identifies the clip's media, producers are discarded when it changes */
+        QString key;
+        std::vector<std::unique_ptr<PooledProducer>> idle;
+        quint64 lastUse{0};
+    };
+
     Mlt::Profile m_profile;
-    QImage makeThumbnail(std::unique_ptr<Mlt::Producer> producer, int frameNumber, const QSize &requestedSize);
+    QMutex m_poolMutex;
+    std::unordered_map<QString, ClipPool> m_pool;
+    quint64 m_poolCounter{0};
+    /** @brief Thumbnails currently being produced, so that identical requests wait for the same result */
+    QHash<QString, std::shared_future<QImage>> m_pending;
+
+    QImage produceThumbnail(const std::shared_ptr<ProjectClip> &binClip, const QString &binId, int frameNumber, const QSize &requestedSize);
+    /** @brief Returns an idle producer for this clip, preferring the one that last decoded a frame just before @param frameNumber */
+    std::unique_ptr<PooledProducer> takeProducer(const std::shared_ptr<ProjectClip> &binClip, const QString &binId, const QString &key, int frameNumber);
+    /** @brief Gives a producer back to the pool after use */
+    void releaseProducer(const QString &binId, const QString &key, std::unique_ptr<PooledProducer> producer);
+    QImage makeThumbnail(Mlt::Producer *producer, int frameNumber, const QSize &requestedSize);
 };
@@ -2625,7 +2625,7 @@ void TimelineController::disablePreview(bool disable)
                 m_model->m_tractor->unlock();
             }
             Mlt::Playlist playlist;
-            m_model->previewManager()->loadChunks(QVariantList(), QVariantList(), playlist);
+            m_model->previewManager()->loadChunks(ChunkSet(KdenliveSettings::timelinechunks()), ChunkSet(KdenliveSettings::timelinechunks()), playlist);
             m_usePreview = true;
         }
     }
@@ -2633,12 +2633,12 @@ void TimelineController::disablePreview(bool disable)
 
 QVariantList TimelineController::dirtyChunks() const
 {
-    return m_model->hasTimelinePreview() ? m_model->previewManager()->m_dirtyChunks : QVariantList();
+    return m_model->hasTimelinePreview() ? m_model->previewManager()->m_dirtyChunks.toRunList() : QVariantList();
 }
 
 QVariantList TimelineController::renderedChunks() const
 {
-    return m_model->hasTimelinePreview() ? m_model->previewManager()->m_renderedChunks : QVariantList();
+    return m_model->hasTimelinePreview() ? m_model->previewManager()->m_renderedChunks.toRunList() : QVariantList();
 }
 
 int TimelineController::workingPreview() const
@@ -103,6 +103,11 @@ std::unique_ptr<TransitionsRepository> &TransitionsRepository::get()
     return instance;
 }
 
+QString TransitionsRepository::assetCacheName() const
+{
+    return QStringLiteral("transitions");
+}
+
 QStringList TransitionsRepository::assetDirs() const
 {
     return QStandardPaths::locateAll(QStandardPaths::AppDataLocation, QStringLiteral("transitions"), QStandardPaths::LocateDirectory);
@@ -51,6 +51,8 @@ protected:
     /** @brief Returns the paths where the custom transitions' descriptions are stored */
     QStringList assetDirs() const override;
 
+    QString assetCacheName() const override;
+
     /** @brief Returns the path to the compositions that will be displayed*/
     QStringList assetIncludedPath() const override;
 
@@ -7,16 +7,72 @@
 #ifdef CRASH_AUTO_TEST
 #include "logger.hpp"
 #endif
+#include <QCoreApplication>
 #include <QDebug>
+#include <QDomElement>
 #include <QTime>
+#include <atomic>
+#include <memory>
+#include <mlt++/MltFilter.h>
+#include <mlt++/MltService.h>
 #include <utility>
+
+namespace {
+std::atomic<qint64> pendingCost{0};
+} // namespace
+
+void UndoMemory::account(qint64 bytes)
+{
+    if (pendingCost.fetch_add(bytes) == 0) {
+        // First operation since the last reset, forget the operations that were never pushed once the event loop runs
+        if (QCoreApplication::instance() != nullptr) {
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(), []() { pendingCost = 0; }, Qt::QueuedConnection);
+        }
+    }
+}
+
+qint64 UndoMemory::serviceCost(Mlt::Service &service)
+{
+    qint64 cost = service.count() * propertyCost;
+    int max = service.filter_count();
+    for (int i = 0; i < max; i++) {
+        std::unique_ptr<Mlt::Filter> filter(service.filter(i));
+        if (filter && filter->is_valid()) {
+            cost += filter->count() * propertyCost;
+        }
+    }
+    return cost;
+}
+
+qint64 UndoMemory::xmlCost(const QDomElement &element)
+{
+    return (element.elementsByTagName(QStringLiteral("property")).count() + 1) * propertyCost;
+}
+
+void UndoMemory::recordOperation()
+{
+    account(operationCost);
+}
+
+qint64 UndoMemory::take()
+{
+    return pendingCost.exchange(0);
+}
+
 FunctionalUndoCommand::FunctionalUndoCommand(Fun undo, Fun redo, const QString &text, QUndoCommand *parent)
     : QUndoCommand(parent)
     , m_undo(std::move(undo))
     , m_redo(std::move(redo))
     , m_undone(false)
+    , m_released(false)
+    , m_cost(qint64(sizeof(FunctionalUndoCommand)) + UndoMemory::take())
+    , m_mergeId(-1)
+    , m_mergeInterval(3000)
+    , m_stamp(QTime::currentTime())
 {
     setText(QString("%1 %2").arg(QTime::currentTime().toString("hh:mm")).arg(text));
+    m_cost += text.size() * qint64(sizeof(QChar));
 }
 
 void FunctionalUndoCommand::undo()
@@ -43,3 +99,73 @@ void FunctionalUndoCommand::redo()
     }
     QUndoCommand::redo();
 }
+
+int FunctionalUndoCommand::id() const
+{
+    return m_mergeId;
+}
+
+bool FunctionalUndoCommand::mergeWith(const QUndoCommand *other)
+{
+    if (m_mergeId == -1 || m_mergeInterval <= 0 || other->id() != id()) {
+        return false;
+    }
+    auto *command = static_cast<const FunctionalUndoCommand *>(other);
+    if (command->m_mergeKey != m_nextMergeKey || m_stamp.msecsTo(command->m_stamp) > m_mergeInterval) {
+        return false;
+    }
+    // Undo the other command first, then this one. Redo in the opposite order
+    Fun undo = m_undo;
+    Fun redo = m_redo;
+    Fun otherUndo = command->m_undo;
+    Fun otherRedo = command->m_redo;
+    m_undo = [undo, otherUndo]() {
+        bool v = otherUndo();
+        return undo() && v;
+    };
+    m_redo = [redo, otherRedo]() {
+        bool v = redo();
+        return otherRedo() && v;
+    };
+    m_cost += command->m_cost;
+    m_stamp = command->m_stamp;
+    m_nextMergeKey = command->m_nextMergeKey;
+    return true;
+}
+
+void FunctionalUndoCommand::setMergeKey(UndoMergeId mergeId, const QString &key, const QString &nextKey)
+{
+    m_mergeId = int(mergeId);
+    m_mergeKey = key;
+    m_nextMergeKey = nextKey.isEmpty() ? key : nextKey;
+}
+
+void FunctionalUndoCommand::setMergeInterval(int interval)
+{
+    m_mergeInterval = interval;
+}
+
+qint64 FunctionalUndoCommand::cost() const
+{
+    return m_cost;
+}
+
+void FunctionalUndoCommand::release()
+{
+    if (m_released) {
+        return;
+    }
+    m_undo = []() { return true; };
+    m_redo = []() { return true; };
+    m_released = true;
+    m_mergeId = -1;
+    m_mergeKey.clear();
+    m_nextMergeKey.clear();
+    m_cost = qint64(sizeof(FunctionalUndoCommand)) + text().size() * qint64(sizeof(QChar));
+    setObsolete(true);
+}
+
+bool FunctionalUndoCommand::isReleased() const
+{
+    return m_released;
+}
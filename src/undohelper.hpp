@@ -5,13 +5,46 @@
 
 #pragma once
 
+#include <QTime>
 #include <functional>
 
+class QDomElement;
+namespace Mlt {
+class Properties;
+class Service;
+} // namespace Mlt
+
 using Fun = std::function<bool(void)>;
 
+/** @brief Rough accounting of the memory held by the undo history.
+    The operations composed into an undo/redo pair are counted here, and the total is attached to the next FunctionalUndoCommand.
+    The count is reset when the event loop runs, so that operations that were never pushed (for example during a drag) are not charged
+    to the next command.
+ */
+namespace UndoMemory {
+/** @brief Estimated memory held by one composed operation: the chained closures and their captures */
+constexpr qint64 operationCost = 256;
+/** @brief Register that an operation was composed into an undo/redo pair */
+void recordOperation();
+/** @brief Add an explicit estimate for large data captured by the operations being composed */
+void account(qint64 bytes);
+/** @brief Estimated memory held by one property of a captured item */
+constexpr qint64 propertyCost = 64;
+/** @brief Returns an estimate of the memory held by a captured MLT service, like a deleted clip or effect, including its attached filters */
+qint64 serviceCost(Mlt::Service &service);
+/** @brief Returns an estimate of the memory held by the item built from @p element, from the number of properties it describes */
+qint64 xmlCost(const QDomElement &element);
+/** @brief Returns the memory recorded since the last call and reset it */
+qint64 take();
+} // namespace UndoMemory
+
+/** @brief Identifies the kinds of FunctionalUndoCommand that can be merged with the following command, see FunctionalUndoCommand::setMergeKey */
+enum class UndoMergeId : int { MoveItem = 100, MoveKeyframe };
+
 /** @brief this macro executes an operation after a given lambda
  */
 #define PUSH_LAMBDA(operation, lambda)                                                                                                                         \
+    UndoMemory::recordOperation();                                                                                                                             \
     lambda = [lambda, operation]() {                                                                                                                           \
         bool v = lambda();                                                                                                                                     \
         return v && operation();                                                                                                                               \
@@ -20,6 +53,7 @@ using Fun = std::function<bool(void)>;
 /** @brief this macro executes an operation before a given lambda
  */
 #define PUSH_FRONT_LAMBDA(operation, lambda)                                                                                                                   \
+    UndoMemory::recordOperation();                                                                                                                             \
     lambda = [lambda, operation]() {                                                                                                                           \
         bool v = operation();                                                                                                                                  \
         return v && lambda();                                                                                                                                  \
@@ -38,8 +72,31 @@ public:
     FunctionalUndoCommand(Fun undo, Fun redo, const QString &text, QUndoCommand *parent = nullptr);
     void undo() override;
     void redo() override;
+    int id() const override;
+    bool mergeWith(const QUndoCommand *other) override;
+
+    /** @brief Allow this command to absorb the next one if it has the same merge id and key and is pushed shortly after,
+        so that successive drags or nudges of the same item form a single undo step.
+        @param nextKey the key the next command must have to be merged, if the operation changes what identifies the item (like a keyframe position).
+        Defaults to @p key */
+    void setMergeKey(UndoMergeId mergeId, const QString &key, const QString &nextKey = QString());
+    /** @brief Maximum delay in ms between this command and the next one for them to be merged. 0 disables merging */
+    void setMergeInterval(int interval);
+    /** @brief Estimated memory held by this command, in bytes */
+    qint64 cost() const;
+    /** @brief Drop the undo and redo operations and everything they keep alive. The command is marked obsolete, so the undo stack
+        deletes it instead of undoing it */
+    void release();
+    bool isReleased() const;
 
 private:
     Fun m_undo, m_redo;
     bool m_undone;
+    bool m_released;
+    qint64 m_cost;
+    int m_mergeId;
+    int m_mergeInterval;
+    QString m_mergeKey;
+    QString m_nextMergeKey;
+    QTime m_stamp;
 };
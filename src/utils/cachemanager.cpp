@@ -0,0 +1,386 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "cachemanager.hpp"
+#include "kdenlivesettings.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+#include <QtConcurrent>
+#include <algorithm>
+
+// Increase when the index format changes, older indexes are then rebuilt from the cache folders
+static const int cacheIndexVersion = 1;
+
+std::unique_ptr<CacheManager> CacheManager::instance;
+std::once_flag CacheManager::m_onceFlag;
+
+namespace {
+QString normalizedPath(const QString &path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+bool isTracked(int type)
+{
+    return type == CachePreview || type == CacheProxy || type == CacheAudio || type == CacheThumbs;
+}
+
+qint64 sumUsage(const QMap<CacheType, qint64> &usage)
+{
+    qint64 total = 0;
+    for (auto it = usage.cbegin(); it != usage.cend(); ++it) {
+        // Proxies are required to edit and have their own budget
+        if (it.key() != CacheProxy) {
+            total += it.value();
+        }
+    }
+    return total;
+}
+} // namespace
+
+CacheManager::CacheManager(const QString &indexPath)
+    : m_indexPath(indexPath)
+    , m_root(normalizedPath(QFileInfo(indexPath).absolutePath()) + QLatin1Char('/'))
+    , m_sessionStart(QDateTime::currentSecsSinceEpoch())
+{
+    m_indexed = load();
+}
+
+std::unique_ptr<CacheManager> &CacheManager::get()
+{
+    std::call_once(m_onceFlag, [] {
+        instance.reset(new CacheManager(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/cacheindex")));
+    });
+    return instance;
+}
+
+bool CacheManager::load()
+{
+    QFile file(m_indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QStringList lines = QString::fromUtf8(file.readAll()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    if (lines.isEmpty() || lines.first().toInt() != cacheIndexVersion) {
+        return false;
+    }
+    QMutexLocker lock(&m_mutex);
+    for (int i = 1; i < lines.count(); ++i) {
+        // type, size, last access and path, separated by tabs
+        const QString &line = lines.at(i);
+        bool ok;
+        const int type = line.section(QLatin1Char('\t'), 0, 0).toInt(&ok);
+        if (!ok || !isTracked(type)) {
+            continue;
+        }
+        const qint64 size = line.section(QLatin1Char('\t'), 1, 1).toLongLong(&ok);
+        if (!ok) {
+            continue;
+        }
+        const qint64 lastAccess = line.section(QLatin1Char('\t'), 2, 2).toLongLong(&ok);
+        const QString path = line.section(QLatin1Char('\t'), 3);
+        if (ok && path.startsWith(m_root)) {
+            addEntry(path, {CacheType(type), size, lastAccess});
+        }
+    }
+    m_changed = false;
+    return true;
+}
+
+void CacheManager::save()
+{
+    QByteArray data;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_changed) {
+            return;
+        }
+        data = QByteArray::number(cacheIndexVersion) + '\n';
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            data.append(QStringLiteral("%1\t%2\t%3\t%4\n").arg(int(it->type)).arg(it->size).arg(it->lastAccess).arg(it.key()).toUtf8());
+        }
+        m_changed = false;
+    }
+    QDir().mkpath(QFileInfo(m_indexPath).absolutePath());
+    QSaveFile file(m_indexPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Cannot write cache index" << m_indexPath;
+        QMutexLocker lock(&m_mutex);
+        m_changed = true;
+    }
+}
+
+void CacheManager::addEntry(const QString &path, const Entry &entry)
+{
+    auto it = m_entries.find(path);
+    if (it != m_entries.end()) {
+        m_usage[it->type] -= it->size;
+        *it = entry;
+    } else {
+        m_entries.insert(path, entry);
+    }
+    m_usage[entry.type] += entry.size;
+    m_changed = true;
+}
+
+void CacheManager::importFolders()
+{
+    const QDir root = QFileInfo(m_indexPath).absoluteDir();
+    QList<QPair<QString, CacheType>> folders;
+    folders << qMakePair(root.absoluteFilePath(QStringLiteral("proxy")), CacheProxy);
+    // Each document has its own folder, named after its numeric id
+    const QStringList documents = root.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &document : documents) {
+        bool ok;
+        document.toLongLong(&ok);
+        if (ok) {
+            const QDir dir(root.absoluteFilePath(document));
+            folders << qMakePair(dir.absoluteFilePath(QStringLiteral("audiothumbs")), CacheAudio);
+            folders << qMakePair(dir.absoluteFilePath(QStringLiteral("videothumbs")), CacheThumbs);
+            folders << qMakePair(dir.absoluteFilePath(QStringLiteral("preview")), CachePreview);
+        }
+    }
+    for (const auto &folder : qAsConst(folders)) {
+        QDirIterator it(folder.first, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            const QString path = normalizedPath(info.absoluteFilePath());
+            QMutexLocker lock(&m_mutex);
+            // Files recorded since the start of the import are more accurate
+            if (!m_entries.contains(path)) {
+                addEntry(path, {folder.second, info.size(), info.lastModified().toSecsSinceEpoch()});
+            }
+        }
+    }
+}
+
+void CacheManager::start()
+{
+    if (m_working.exchange(true)) {
+        return;
+    }
+    (void)QtConcurrent::run([this]() {
+        if (!m_indexed) {
+            importFolders();
+            m_indexed = true;
+        }
+        if (KdenliveSettings::cacheautoclean() && hasDocument()) {
+            evict(budgets(), totalBudget());
+        }
+        save();
+        m_working = false;
+    });
+}
+
+void CacheManager::setDocumentFolder(const QString &folder)
+{
+    QMutexLocker lock(&m_mutex);
+    m_documentFolder = folder.isEmpty() ? QString() : normalizedPath(folder) + QLatin1Char('/');
+}
+
+bool CacheManager::hasDocument() const
+{
+    QMutexLocker lock(&m_mutex);
+    return !m_documentFolder.isEmpty();
+}
+
+void CacheManager::recordWrite(CacheType type, const QString &path)
+{
+    if (!isTracked(type)) {
+        return;
+    }
+    const QFileInfo info(path);
+    const QString key = normalizedPath(path);
+    // Files in a project folder are not imported, never delete them
+    if (!info.exists() || !key.startsWith(m_root)) {
+        return;
+    }
+    {
+        QMutexLocker lock(&m_mutex);
+        addEntry(key, {type, info.size(), QDateTime::currentSecsSinceEpoch()});
+    }
+    scheduleEviction();
+}
+
+void CacheManager::recordAccess(const QString &path)
+{
+    const QString key = normalizedPath(path);
+    QMutexLocker lock(&m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        it->lastAccess = QDateTime::currentSecsSinceEpoch();
+        m_changed = true;
+    }
+}
+
+void CacheManager::recordRemoval(const QString &path)
+{
+    const QString key = normalizedPath(path);
+    QMutexLocker lock(&m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_usage[it->type] -= it->size;
+        m_entries.erase(it);
+        m_changed = true;
+    }
+}
+
+void CacheManager::recordFolderRemoval(const QString &folder)
+{
+    const QString prefix = normalizedPath(folder) + QLatin1Char('/');
+    QMutexLocker lock(&m_mutex);
+    auto it = m_entries.begin();
+    while (it != m_entries.end()) {
+        if (it.key().startsWith(prefix)) {
+            m_usage[it->type] -= it->size;
+            it = m_entries.erase(it);
+            m_changed = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool CacheManager::isEvictable(const QString &path, const Entry &entry) const
+{
+    // The open project may still need the files of its folder, even if they were not used yet
+    return entry.lastAccess < m_sessionStart && path.startsWith(m_root) && (m_documentFolder.isEmpty() || !path.startsWith(m_documentFolder));
+}
+
+qint64 CacheManager::usage(CacheType type) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_usage.value(type);
+}
+
+qint64 CacheManager::totalUsage() const
+{
+    QMutexLocker lock(&m_mutex);
+    return sumUsage(m_usage);
+}
+
+QMap<CacheType, qint64> CacheManager::budgets()
+{
+    QMap<CacheType, qint64> result;
+    result.insert(CacheThumbs, qint64(KdenliveSettings::maxthumbscachesize()) * 1048576);
+    result.insert(CacheAudio, qint64(KdenliveSettings::maxaudiocachesize()) * 1048576);
+    result.insert(CachePreview, qint64(KdenliveSettings::maxpreviewcachesize()) * 1048576);
+    result.insert(CacheProxy, qint64(KdenliveSettings::maxproxycachesize()) * 1048576);
+    return result;
+}
+
+qint64 CacheManager::totalBudget()
+{
+    return qint64(KdenliveSettings::maxcachesize()) * 1048576;
+}
+
+bool CacheManager::isOverBudget(const QMap<CacheType, qint64> &budgets, qint64 totalBudget) const
+{
+    for (auto it = budgets.cbegin(); it != budgets.cend(); ++it) {
+        if (it.value() > 0 && m_usage.value(it.key()) > it.value()) {
+            return true;
+        }
+    }
+    return totalBudget > 0 && sumUsage(m_usage) > totalBudget;
+}
+
+void CacheManager::scheduleEviction()
+{
+    if (m_working || !KdenliveSettings::cacheautoclean() || !hasDocument()) {
+        return;
+    }
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    {
+        QMutexLocker lock(&m_mutex);
+        // When the files of the current session exceed the budget, nothing can be deleted, don't retry on each write
+        if (now - m_lastEviction < 60 || !isOverBudget(budgets(), totalBudget())) {
+            return;
+        }
+        m_lastEviction = now;
+    }
+    if (m_working.exchange(true)) {
+        return;
+    }
+    (void)QtConcurrent::run([this]() {
+        evict(budgets(), totalBudget());
+        save();
+        m_working = false;
+    });
+}
+
+int CacheManager::evict(const QMap<CacheType, qint64> &budgets, qint64 totalBudget)
+{
+    QMap<CacheType, qint64> excess;
+    qint64 totalExcess = 0;
+    QVector<QPair<qint64, QString>> candidates;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!isOverBudget(budgets, totalBudget)) {
+            return 0;
+        }
+        for (auto it = budgets.cbegin(); it != budgets.cend(); ++it) {
+            if (it.value() > 0) {
+                excess.insert(it.key(), m_usage.value(it.key()) - it.value());
+            }
+        }
+        if (totalBudget > 0) {
+            totalExcess = sumUsage(m_usage) - totalBudget;
+        }
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            if (isEvictable(it.key(), it.value())) {
+                candidates.append({it->lastAccess, it.key()});
+            }
+        }
+    }
+    // Least recently used first
+    std::sort(candidates.begin(), candidates.end());
+    int removed = 0;
+    for (const auto &candidate : qAsConst(candidates)) {
+        bool done = totalExcess <= 0;
+        for (auto it = excess.cbegin(); done && it != excess.cend(); ++it) {
+            done = it.value() <= 0;
+        }
+        if (done) {
+            break;
+        }
+        QMutexLocker lock(&m_mutex);
+        auto it = m_entries.find(candidate.second);
+        // The file may have been used or removed, or its project opened, since the candidates were listed
+        if (it == m_entries.end() || !isEvictable(it.key(), it.value())) {
+            continue;
+        }
+        const CacheType type = it->type;
+        const bool inTotal = type != CacheProxy && totalExcess > 0;
+        if (excess.value(type) <= 0 && !inTotal) {
+            continue;
+        }
+        if (QFile::remove(it.key())) {
+            removed++;
+        } else if (QFile::exists(it.key())) {
+            continue;
+        }
+        const qint64 size = it->size;
+        m_usage[type] -= size;
+        m_entries.erase(it);
+        m_changed = true;
+        if (excess.contains(type)) {
+            excess[type] -= size;
+        }
+        if (type != CacheProxy) {
+            totalExcess -= size;
+        }
+    }
+    return removed;
+}
@@ -0,0 +1,111 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "definitions.h"
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+/** @class CacheManager
+    @brief Keeps the cached data (thumbnails, audio levels, timeline previews and proxies) within a disk budget.
+    Each cached file is recorded in an index when it is written or used, with its size and last access time, so that the
+    usage of each cache type is known without walking the cache folders. When automatic deletion is enabled and a budget is
+    exceeded, the least recently used files are deleted in the background. Files used since Kdenlive started and the files
+    of the open project are never deleted, and nothing is deleted before a project is open. Only the files of the Kdenlive
+    cache folder are recorded, those of a custom project folder are left alone. The total budget does not include proxies,
+    which have their own budget.
+ * Note that this class is a Singleton
+ */
+class CacheManager
+{
+
+public:
+    // Returns the instance of the Singleton
+    static std::unique_ptr<CacheManager> &get();
+
+    /** @brief Import the existing cache folders if there is no index yet, then enforce the budgets if a project is open, in the background */
+    void start();
+    /** @brief The cache folder of the open project, its files are never deleted. Eviction only runs once it is set */
+    void setDocumentFolder(const QString &folder);
+    /** @brief A cached file was created or updated */
+    void recordWrite(CacheType type, const QString &path);
+    /** @brief A cached file was used */
+    void recordAccess(const QString &path);
+    /** @brief A cached file was deleted */
+    void recordRemoval(const QString &path);
+    /** @brief All the cached files in @p folder were deleted */
+    void recordFolderRemoval(const QString &folder);
+
+    /** @brief The size in bytes of the recorded files of a cache type */
+    qint64 usage(CacheType type) const;
+    /** @brief The size in bytes of the recorded files counted in the total budget, all types but proxies */
+    qint64 totalUsage() const;
+
+    /** @brief Delete the least recently used files that exceed the budgets
+     *  @param budgets the maximum size in bytes of each cache type, types without a positive budget are only limited by the total
+     *  @param totalBudget the maximum size in bytes of all the types but proxies, no limit if not positive
+     *  @returns the number of deleted files
+     */
+    int evict(const QMap<CacheType, qint64> &budgets, qint64 totalBudget);
+    /** @brief Write the index to disk if it changed */
+    void save();
+
+protected:
+    // Constructor is protected because class is a Singleton
+    explicit CacheManager(const QString &indexPath);
+
+    struct Entry
+    {
+        CacheType type;
+        qint64 size;
+        /** @brief Seconds since epoch */
+        qint64 lastAccess;
+    };
+
+    static std::unique_ptr<CacheManager> instance;
+    static std::once_flag m_onceFlag; // flag to create the manager only once;
+
+    QString m_indexPath;
+    /** @brief The folder containing the index, only the files it contains are recorded and deleted, with a trailing slash */
+    QString m_root;
+    /** @brief The cache folder of the open project, with a trailing slash */
+    QString m_documentFolder;
+    QHash<QString, Entry> m_entries;
+    QMap<CacheType, qint64> m_usage;
+    /** @brief Files used after this time (seconds since epoch) belong to the current session and are never deleted */
+    qint64 m_sessionStart;
+    /** @brief False until the existing cache folders are recorded */
+    bool m_indexed{false};
+    bool m_changed{false};
+    /** @brief Time of the last background eviction, in seconds since epoch */
+    qint64 m_lastEviction{0};
+    /** @brief True while an import or an eviction runs in the background */
+    std::atomic<bool> m_working{false};
+    mutable QMutex m_mutex;
+
+    /** @brief Read the index, returns false if there is no valid index */
+    bool load();
+    /** @brief Record the files of the cache folders, used once when there is no index */
+    void importFolders();
+    /** @brief Record a file, the mutex must be locked */
+    void addEntry(const QString &path, const Entry &entry);
+    /** @brief Run the eviction in the background if a budget is exceeded */
+    void scheduleEviction();
+    bool hasDocument() const;
+    /** @brief Returns true if the file can be deleted, the mutex must be locked */
+    bool isEvictable(const QString &path, const Entry &entry) const;
+    /** @brief Returns true if a budget is exceeded, the mutex must be locked */
+    bool isOverBudget(const QMap<CacheType, qint64> &budgets, qint64 totalBudget) const;
+    /** @brief The budgets defined in the settings, in bytes */
+    static QMap<CacheType, qint64> budgets();
+    static qint64 totalBudget();
+};
@@ -0,0 +1,205 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "chunkset.hpp"
+
+#include <QPoint>
+#include <algorithm>
+
+ChunkSet::ChunkSet(int chunkSize)
+    : m_chunkSize(qMax(1, chunkSize))
+{
+}
+
+ChunkSet ChunkSet::fromString(const QString &list, int chunkSize)
+{
+    ChunkSet result(chunkSize);
+    const QStringList items = list.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        bool ok;
+        if (item.contains(QLatin1Char('-'))) {
+            int start = item.section(QLatin1Char('-'), 0, 0).toInt(&ok);
+            if (!ok) {
+                continue;
+            }
+            int end = item.section(QLatin1Char('-'), 1, 1).toInt(&ok);
+            if (ok) {
+                result.insert(start, end);
+            }
+        } else {
+            int frame = item.toInt(&ok);
+            if (ok) {
+                result.insert(frame);
+            }
+        }
+    }
+    return result;
+}
+
+int ChunkSet::first() const
+{
+    return m_runs.empty() ? -1 : m_runs.cbegin()->first;
+}
+
+int ChunkSet::last() const
+{
+    return m_runs.empty() ? -1 : m_runs.crbegin()->second;
+}
+
+bool ChunkSet::contains(int frame) const
+{
+    auto it = m_runs.upper_bound(frame);
+    if (it == m_runs.cbegin()) {
+        return false;
+    }
+    --it;
+    return frame <= it->second && (frame - it->first) % m_chunkSize == 0;
+}
+
+bool ChunkSet::intersects(int start, int end) const
+{
+    auto it = m_runs.upper_bound(end);
+    if (it == m_runs.cbegin()) {
+        return false;
+    }
+    --it;
+    if (it->first >= start) {
+        return true;
+    }
+    // The run starts before the range, look for its first chunk after start
+    const int frame = it->first + (start - it->first + m_chunkSize - 1) / m_chunkSize * m_chunkSize;
+    return frame <= end && frame <= it->second;
+}
+
+int ChunkSet::insert(int start, int end)
+{
+    start = align(qMax(0, start));
+    end = align(end);
+    if (end < start) {
+        return 0;
+    }
+    // Find the first run that touches or follows the new one, then merge all the runs it touches
+    auto it = m_runs.upper_bound(start);
+    if (it != m_runs.begin()) {
+        auto previous = std::prev(it);
+        if (previous->second + m_chunkSize >= start) {
+            it = previous;
+        }
+    }
+    int first = start;
+    int last = end;
+    int merged = 0;
+    while (it != m_runs.end() && it->first <= end + m_chunkSize) {
+        first = qMin(first, it->first);
+        last = qMax(last, it->second);
+        merged += runLength(it->first, it->second);
+        it = m_runs.erase(it);
+    }
+    m_runs.emplace(first, last);
+    const int added = runLength(first, last) - merged;
+    m_count += added;
+    return added;
+}
+
+int ChunkSet::remove(int start, int end)
+{
+    start = align(qMax(0, start));
+    end = align(end);
+    if (end < start) {
+        return 0;
+    }
+    auto it = m_runs.upper_bound(start);
+    if (it != m_runs.begin()) {
+        auto previous = std::prev(it);
+        if (previous->second >= start) {
+            it = previous;
+        }
+    }
+    int removed = 0;
+    while (it != m_runs.end() && it->first <= end) {
+        const int first = it->first;
+        const int last = it->second;
+        it = m_runs.erase(it);
+        removed += runLength(qMax(first, start), qMin(last, end));
+        // Keep the parts of the run outside of the removed range
+        if (first < start) {
+            m_runs.emplace(first, start - m_chunkSize);
+        }
+        if (last > end) {
+            m_runs.emplace(end + m_chunkSize, last);
+        }
+    }
+    m_count -= removed;
+    return removed;
+}
+
+void ChunkSet::unite(const ChunkSet &other)
+{
+    for (const auto &run : other.m_runs) {
+        insert(run.first, run.second);
+    }
+}
+
+void ChunkSet::subtract(const ChunkSet &other)
+{
+    for (const auto &run : other.m_runs) {
+        if (m_runs.empty()) {
+            break;
+        }
+        remove(run.first, run.second);
+    }
+}
+
+void ChunkSet::clear()
+{
+    m_runs.clear();
+    m_count = 0;
+}
+
+std::vector<int> ChunkSet::chunks(int start, int end) const
+{
+    std::vector<int> result;
+    if (end < start) {
+        return result;
+    }
+    auto it = m_runs.upper_bound(start);
+    if (it != m_runs.cbegin() && std::prev(it)->second >= start) {
+        --it;
+    }
+    for (; it != m_runs.cend() && it->first <= end; ++it) {
+        int frame = it->first;
+        if (frame < start) {
+            // Start on the first chunk of the run after start
+            frame += (start - frame + m_chunkSize - 1) / m_chunkSize * m_chunkSize;
+        }
+        const int last = qMin(it->second, end);
+        for (; frame <= last; frame += m_chunkSize) {
+            result.push_back(frame);
+        }
+    }
+    return result;
+}
+
+QStringList ChunkSet::toStringList() const
+{
+    QStringList result;
+    for (const auto &run : m_runs) {
+        if (run.first == run.second) {
+            result << QString::number(run.first);
+        } else {
+            result << QStringLiteral("%1-%2").arg(run.first).arg(run.second);
+        }
+    }
+    return result;
+}
+
+QVariantList ChunkSet::toRunList() const
+{
+    QVariantList result;
+    for (const auto &run : m_runs) {
+        result << QPoint(run.first, run.second);
+    }
+    return result;
+}
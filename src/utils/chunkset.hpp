@@ -0,0 +1,71 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QStringList>
+#include <QVariantList>
+#include <climits>
+#include <map>
+#include <vector>
+
+/** @class ChunkSet
+    @brief A set of timeline preview chunks, stored as runs of consecutive chunks.
+    A chunk is identified by its first frame, a multiple of the chunk size. Lookups, insertions and removals are logarithmic
+    in the number of runs, which stays small even on long timelines since the preview zones are mostly contiguous.
+ */
+class ChunkSet
+{
+public:
+    explicit ChunkSet(int chunkSize);
+
+    /** @brief Parse a compressed list of chunks, like "0-500,525" */
+    static ChunkSet fromString(const QString &list, int chunkSize);
+
+    int chunkSize() const { return m_chunkSize; }
+    bool isEmpty() const { return m_runs.empty(); }
+    /** @brief The number of chunks in the set */
+    int count() const { return m_count; }
+    /** @brief The first chunk, -1 if the set is empty */
+    int first() const;
+    /** @brief The last chunk, -1 if the set is empty */
+    int last() const;
+    bool contains(int frame) const;
+    /** @brief Returns true if one of the chunks starts between @p start and @p end (included) */
+    bool intersects(int start, int end) const;
+
+    /** @brief Add the chunks between @p start and @p end included, frames are aligned on the chunk size.
+     *  @returns the number of chunks that were not already in the set
+     */
+    int insert(int start, int end);
+    int insert(int frame) { return insert(frame, frame); }
+    /** @brief Remove the chunks between @p start and @p end included, returns the number of removed chunks */
+    int remove(int start, int end);
+    int remove(int frame) { return remove(frame, frame); }
+    /** @brief Add all the chunks of @p other */
+    void unite(const ChunkSet &other);
+    /** @brief Remove all the chunks of @p other */
+    void subtract(const ChunkSet &other);
+    void clear();
+
+    /** @brief The chunks between @p start and @p end included, sorted */
+    std::vector<int> chunks(int start = 0, int end = INT_MAX) const;
+    /** @brief The runs of consecutive chunks, as pairs of first and last chunk */
+    const std::map<int, int> &runs() const { return m_runs; }
+    /** @brief The compressed list of chunks, like: "0-500", "525", "575" */
+    QStringList toStringList() const;
+    /** @brief The runs of consecutive chunks as points, x being the first chunk and y the last one. Used by the QML ruler */
+    QVariantList toRunList() const;
+
+    bool operator==(const ChunkSet &other) const { return m_chunkSize == other.m_chunkSize && m_runs == other.m_runs; }
+
+private:
+    int m_chunkSize;
+    int m_count{0};
+    /** @brief The first chunk of each run and its last chunk */
+    std::map<int, int> m_runs;
+    int align(int frame) const { return frame - frame % m_chunkSize; }
+    int runLength(int first, int last) const { return (last - first) / m_chunkSize + 1; }
+};
@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "mediaprobecache.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <mlt++/MltProperties.h>
+
+// Increase when the list of stored properties changes to invalidate older entries
+static const int probeCacheVersion = 1;
+
+std::unique_ptr<MediaProbeCache> MediaProbeCache::instance;
+std::once_flag MediaProbeCache::m_onceFlag;
+
+MediaProbeCache::MediaProbeCache()
+{
+    m_dir.setPath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    m_valid = m_dir.mkpath(QStringLiteral("probe")) && m_dir.cd(QStringLiteral("probe"));
+}
+
+std::unique_ptr<MediaProbeCache> &MediaProbeCache::get()
+{
+    std::call_once(m_onceFlag, [] { instance.reset(new MediaProbeCache()); });
+    return instance;
+}
+
+// static
+QString MediaProbeCache::getKey(const QString &path, double fps)
+{
+    QFileInfo info(path);
+    if (path.isEmpty() || !info.isFile()) {
+        return QString();
+    }
+    // The length is counted in frames of the project, so the same file gets another entry in a project with another frame rate
+    const QString fileId = QStringLiteral("%1|%2|%3|%4")
+                               .arg(info.absoluteFilePath())
+                               .arg(info.size())
+                               .arg(info.lastModified().toMSecsSinceEpoch())
+                               .arg(QString::number(fps, 'f', 6));
+    return QString::fromLatin1(QCryptographicHash::hash(fileId.toUtf8(), QCryptographicHash::Sha1).toHex()) + QStringLiteral(".json");
+}
+
+// static
+bool MediaProbeCache::isProbeProperty(const QString &name)
+{
+    static const QStringList probeProperties = {QStringLiteral("length"),      QStringLiteral("seekable"),     QStringLiteral("audio_index"),
+                                                QStringLiteral("video_index"), QStringLiteral("source_fps"),   QStringLiteral("creation_time"),
+                                                QStringLiteral("width"),       QStringLiteral("height"),       QStringLiteral("aspect_ratio"),
+                                                QStringLiteral("color_range"), QStringLiteral("color_trc"),    QStringLiteral("progressive"),
+                                                QStringLiteral("format"),      QStringLiteral("top_field_first")};
+    return name.startsWith(QLatin1String("meta.media.")) || name.startsWith(QLatin1String("meta.attr.")) || probeProperties.contains(name);
+}
+
+QMap<QString, QString> MediaProbeCache::probeData(const QString &path, double fps) const
+{
+    QMap<QString, QString> result;
+    if (!m_valid) {
+        return result;
+    }
+    const QString key = getKey(path, fps);
+    if (key.isEmpty()) {
+        return result;
+    }
+    QMutexLocker lock(&m_mutex);
+    QFile file(m_dir.absoluteFilePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+    const QJsonObject entry = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+    lock.unlock();
+    if (entry.value(QLatin1String("version")).toInt() != probeCacheVersion) {
+        return result;
+    }
+    const QJsonObject properties = entry.value(QLatin1String("properties")).toObject();
+    for (auto i = properties.constBegin(); i != properties.constEnd(); ++i) {
+        result.insert(i.key(), i.value().toString());
+    }
+    // A valid probe always has a length
+    if (!result.contains(QStringLiteral("length"))) {
+        result.clear();
+    }
+    return result;
+}
+
+// static
+QMap<QString, QString> MediaProbeCache::probeProperties(Mlt::Properties &properties)
+{
+    QMap<QString, QString> result;
+    int count = properties.count();
+    for (int i = 0; i < count; i++) {
+        const QString name = properties.get_name(i);
+        if (isProbeProperty(name)) {
+            result.insert(name, QString::fromUtf8(properties.get(i)));
+        }
+    }
+    return result;
+}
+
+void MediaProbeCache::storeProbeData(const QString &path, double fps, const QMap<QString, QString> &properties)
+{
+    if (!m_valid || !properties.contains(QStringLiteral("length"))) {
+        return;
+    }
+    const QString key = getKey(path, fps);
+    if (key.isEmpty()) {
+        return;
+    }
+    QJsonObject props;
+    for (auto i = properties.constBegin(); i != properties.constEnd(); ++i) {
+        props.insert(i.key(), i.value());
+    }
+    QJsonObject entry;
+    entry.insert(QLatin1String("version"), probeCacheVersion);
+    entry.insert(QLatin1String("path"), QFileInfo(path).absoluteFilePath());
+    entry.insert(QLatin1String("properties"), props);
+    QMutexLocker lock(&m_mutex);
+    QSaveFile file(m_dir.absoluteFilePath(key));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+// static
+void MediaProbeCache::applyProbeData(const QMap<QString, QString> &data, Mlt::Properties &properties)
+{
+    for (auto i = data.constBegin(); i != data.constEnd(); ++i) {
+        properties.set(i.key().toUtf8().constData(), i.value().toUtf8().constData());
+    }
+}
+
+void MediaProbeCache::clearCache()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_valid) {
+        m_dir.removeRecursively();
+        m_valid = m_dir.mkpath(QStringLiteral("."));
+    }
+}
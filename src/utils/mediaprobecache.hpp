@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QDir>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <memory>
+#include <mutex>
+
+namespace Mlt {
+class Properties;
+}
+
+/** @class MediaProbeCache
+    @brief Persistent cache of the properties found by probing a media file with avformat.
+    The probe result of a file (stream layout, duration, frame rate, colour and audio stream metadata) is stored
+    in the system cache folder, keyed by the file path, size and modification time. When a clip is loaded again
+    and its file is unchanged, the stored properties are applied to a non validating producer instead of opening
+    and probing the file.
+ * Note that this class is a Singleton
+ */
+class MediaProbeCache
+{
+
+public:
+    // Returns the instance of the Singleton
+    static std::unique_ptr<MediaProbeCache> &get();
+
+    /** @brief Returns the stored probe properties for a file, or an empty map if the file changed or was never probed
+       @param path is the absolute path of the media file
+       @param fps is the project frame rate, the stored length is a number of frames at this rate
+     */
+    QMap<QString, QString> probeData(const QString &path, double fps) const;
+
+    /** @brief Store the probe properties of a media file
+       @param path is the absolute path of the media file
+       @param fps is the project frame rate used by the probe
+       @param properties are the probe properties, as returned by probeProperties()
+     */
+    void storeProbeData(const QString &path, double fps, const QMap<QString, QString> &properties);
+
+    /** @brief Returns the probe properties of a validated avformat producer.
+       Call it before the project properties of the clip are applied, so that only the probe result is stored.
+     */
+    static QMap<QString, QString> probeProperties(Mlt::Properties &properties);
+
+    /** @brief Apply previously stored probe properties to a producer */
+    static void applyProbeData(const QMap<QString, QString> &data, Mlt::Properties &properties);
+
+    /** @brief Remove all stored probe results */
+    void clearCache();
+
+protected:
+    // Constructor is protected because class is a Singleton
+    MediaProbeCache();
+
+    // Return the cache file name for a media file probed at a frame rate, or an empty string if the file does not exist
+    static QString getKey(const QString &path, double fps);
+    // Return true if a producer property is part of the probe result
+    static bool isProbeProperty(const QString &name);
+
+    static std::unique_ptr<MediaProbeCache> instance;
+    static std::once_flag m_onceFlag; // flag to create the cache only once;
+
+    QDir m_dir;
+    bool m_valid{false};
+    mutable QMutex m_mutex;
+};
@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "startupprofiler.hpp"
+#include "kdenlive_debug.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent>
+
+QElapsedTimer StartupProfiler::m_clock;
+QMutex StartupProfiler::m_mutex;
+QVector<StartupProfiler::Phase> StartupProfiler::m_phases;
+QVector<QFuture<void>> StartupProfiler::m_pending;
+
+void StartupProfiler::start()
+{
+    QMutexLocker lk(&m_mutex);
+    m_phases.clear();
+    m_clock.start();
+}
+
+qint64 StartupProfiler::elapsed()
+{
+    return m_clock.isValid() ? m_clock.elapsed() : 0;
+}
+
+void StartupProfiler::record(const QString &phase, qint64 startMs, qint64 durationMs, bool mainThread)
+{
+    QMutexLocker lk(&m_mutex);
+    m_phases.append({phase, startMs, durationMs, mainThread});
+}
+
+void StartupProfiler::runConcurrently(const QString &phase, const std::function<void()> &task)
+{
+    QFuture<void> future = QtConcurrent::run([phase, task]() {
+        StartupPhase timer(phase);
+        task();
+    });
+    QMutexLocker lk(&m_mutex);
+    m_pending.append(future);
+}
+
+void StartupProfiler::report()
+{
+    m_mutex.lock();
+    QVector<QFuture<void>> pending = m_pending;
+    m_pending.clear();
+    m_mutex.unlock();
+    for (auto &future : pending) {
+        future.waitForFinished();
+    }
+    const qint64 total = elapsed();
+    QMutexLocker lk(&m_mutex);
+    std::sort(m_phases.begin(), m_phases.end(), [](const Phase &a, const Phase &b) { return a.start < b.start; });
+    QJsonArray list;
+    qCDebug(KDENLIVE_LOG) << "::: Startup finished in" << total << "ms";
+    for (const Phase &p : qAsConst(m_phases)) {
+        qCDebug(KDENLIVE_LOG).noquote() << QStringLiteral(":::   %1 %2 ms (at %3 ms%4)")
+                                               .arg(p.name, -24)
+                                               .arg(p.duration, 6)
+                                               .arg(p.start)
+                                               .arg(p.mainThread ? QString() : QStringLiteral(", concurrent"));
+        QJsonObject obj;
+        obj.insert(QLatin1String("name"), p.name);
+        obj.insert(QLatin1String("start"), p.start);
+        obj.insert(QLatin1String("duration"), p.duration);
+        obj.insert(QLatin1String("mainThread"), p.mainThread);
+        list.append(obj);
+    }
+    const QString reportPath = qEnvironmentVariable("KDENLIVE_STARTUP_REPORT");
+    if (reportPath.isEmpty()) {
+        return;
+    }
+    QJsonObject json;
+    json.insert(QLatin1String("total"), total);
+    json.insert(QLatin1String("phases"), list);
+    QSaveFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KDENLIVE_LOG) << "Cannot write startup report to" << reportPath;
+        return;
+    }
+    file.write(QJsonDocument(json).toJson());
+    file.commit();
+}
+
+StartupPhase::StartupPhase(const QString &phase)
+    : m_phase(phase)
+    , m_start(StartupProfiler::elapsed())
+{
+}
+
+StartupPhase::~StartupPhase()
+{
+    StartupProfiler::record(m_phase, m_start, StartupProfiler::elapsed() - m_start, QThread::currentThread() == qApp->thread());
+}
@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+/** @class StartupProfiler
+    @brief Records the wall time spent in each phase of the application startup.
+    Phases run on the main thread are measured with a StartupPhase guard, independent phases can be started
+    on the global thread pool with runConcurrently(). When the GUI is ready, report() waits for the concurrent
+    phases, prints the startup timeline to the log and, if the KDENLIVE_STARTUP_REPORT environment variable
+    contains a file path, writes it to that file as JSON.
+ */
+class StartupProfiler
+{
+public:
+    /** @brief Start the startup clock, all phase times are relative to this call */
+    static void start();
+    /** @brief Store the timing of a finished phase */
+    static void record(const QString &phase, qint64 startMs, qint64 durationMs, bool mainThread);
+    /** @brief Milliseconds elapsed since start() */
+    static qint64 elapsed();
+    /** @brief Run a startup task on the thread pool and measure it as a phase.
+     *  The task must only depend on what is already initialized when this is called.
+     */
+    static void runConcurrently(const QString &phase, const std::function<void()> &task);
+    /** @brief Wait for the concurrent phases and output the startup timeline */
+    static void report();
+
+private:
+    struct Phase
+    {
+        QString name;
+        qint64 start;
+        qint64 duration;
+        bool mainThread;
+    };
+    static QElapsedTimer m_clock;
+    static QMutex m_mutex;
+    static QVector<Phase> m_phases;
+    static QVector<QFuture<void>> m_pending;
+};
+
+/** @class StartupPhase
+    @brief Measures the scope it lives in as a startup phase.
+ */
+class StartupPhase
+{
+public:
+    explicit StartupPhase(const QString &phase);
+    ~StartupPhase();
+
+private:
+    QString m_phase;
+    qint64 m_start;
+};
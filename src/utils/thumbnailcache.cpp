@@ -9,7 +9,9 @@
 #include "core.h"
 #include "doc/kdenlivedoc.h"
 #include "project/projectmanager.h"
+#include "utils/cachemanager.hpp"
 #include <QDir>
+#include <QFile>
 #include <QMutexLocker>
 #include <list>
 
@@ -144,6 +146,7 @@ QImage ThumbnailCache::getAudioThumbnail(const QString &binId, bool volatileOnly
             m_storedOnDisk[binId].push_back(-1);
         }
         locker.unlock();
+        CacheManager::get()->recordAccess(thumbFolder.absoluteFilePath(key));
         return QImage(thumbFolder.absoluteFilePath(key));
     }
     return QImage();
@@ -186,6 +189,7 @@ QImage ThumbnailCache::getThumbnail(QString hash, const QString &binId, int pos,
             m_storedOnDisk[binId].push_back(pos);
         }
         locker.unlock();
+        CacheManager::get()->recordAccess(thumbFolder.absoluteFilePath(hash));
         return QImage(thumbFolder.absoluteFilePath(hash));
     }
     locker.unlock();
@@ -210,6 +214,7 @@ QImage ThumbnailCache::getThumbnail(const QString &binId, int pos, bool volatile
             m_storedOnDisk[binId].push_back(pos);
         }
         locker.unlock();
+        CacheManager::get()->recordAccess(thumbFolder.absoluteFilePath(key));
         return QImage(thumbFolder.absoluteFilePath(key));
     }
     return QImage();
@@ -243,6 +248,8 @@ void ThumbnailCache::storeThumbnail(const QString &binId, int pos, const QImage
             locker.unlock();
             if (!img.save(thumbFolder.absoluteFilePath(key))) {
                 qDebug() << ".............\n!!!!!!!! ERROR SAVING THUMB in: " << thumbFolder.absoluteFilePath(key);
+            } else {
+                CacheManager::get()->recordWrite(CacheThumbs, thumbFolder.absoluteFilePath(key));
             }
         }
     }
@@ -277,6 +284,7 @@ void ThumbnailCache::saveCachedThumbs(const std::unordered_map<QString, std::vec
                         break;
                     } else {
                         m_storedOnDisk[key.first].push_back(pos);
+                        CacheManager::get()->recordWrite(CacheThumbs, thumbFolder.absoluteFilePath(thumbKey));
                     }
                 }
             }
@@ -318,7 +326,10 @@ void ThumbnailCache::invalidateThumbsForClip(const QString &binId)
         QDir thumbFolder = getDir(false, &ok);
         if (ok) {
             while (!files.isEmpty()) {
-                thumbFolder.remove(files.takeFirst());
+                const QString file = thumbFolder.absoluteFilePath(files.takeFirst());
+                if (QFile::remove(file)) {
+                    CacheManager::get()->recordRemoval(file);
+                }
             }
         }
     }
@@ -0,0 +1,171 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "tracing.hpp"
+#include "kdenlive_debug.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+
+// Stop recording after this many events (a few hundred MB) so that a forgotten trace cannot exhaust the memory
+static const size_t maxEvents = 4000000;
+
+std::atomic<bool> Tracing::m_enabled{false};
+QElapsedTimer Tracing::m_clock;
+QMutex Tracing::m_mutex;
+std::vector<Tracing::Event> Tracing::m_events;
+std::vector<QString> Tracing::m_threadNames;
+QString Tracing::m_path;
+qint64 Tracing::m_dropped = 0;
+
+void Tracing::init()
+{
+    const QString path = qEnvironmentVariable("KDENLIVE_TRACE");
+    if (path.isEmpty() || m_enabled) {
+        return;
+    }
+    QMutexLocker lk(&m_mutex);
+    m_path = path;
+    m_events.reserve(65536);
+    m_clock.start();
+    m_enabled = true;
+    qCDebug(KDENLIVE_LOG) << "Recording trace events to" << m_path;
+}
+
+qint64 Tracing::now()
+{
+    return m_clock.nsecsElapsed() / 1000;
+}
+
+int Tracing::threadIndex()
+{
+    // Called with the mutex locked
+    thread_local int index = -1;
+    if (index < 0) {
+        index = int(m_threadNames.size());
+        QThread *thread = QThread::currentThread();
+        QString name = thread->objectName();
+        if (qApp && thread == qApp->thread()) {
+            name = QStringLiteral("Main thread");
+        } else if (name.isEmpty()) {
+            name = QStringLiteral("Thread %1").arg(index);
+        }
+        m_threadNames.push_back(name);
+    }
+    return index;
+}
+
+void Tracing::append(Event &&event)
+{
+    QMutexLocker lk(&m_mutex);
+    if (m_events.size() >= maxEvents) {
+        m_dropped++;
+        return;
+    }
+    event.thread = threadIndex();
+    m_events.push_back(std::move(event));
+}
+
+void Tracing::complete(const char *category, const char *name, qint64 start, const QString &detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append({'X', category, name, start, now() - start, 0, 0, detail});
+}
+
+void Tracing::instant(const char *category, const char *name, const QString &detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append({'i', category, name, now(), 0, 0, 0, detail});
+}
+
+void Tracing::span(const char *category, const char *name, qint64 id, qint64 start, const QString &detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append({'b', category, name, start, 0, id, 0, detail});
+    append({'e', category, name, now(), 0, id, 0, QString()});
+}
+
+void Tracing::counter(const char *category, const char *name, qint64 value)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append({'C', category, name, now(), value, 0, 0, QString()});
+}
+
+void Tracing::flush()
+{
+    if (!isEnabled()) {
+        return;
+    }
+    QMutexLocker lk(&m_mutex);
+    QJsonArray list;
+    const qint64 pid = QCoreApplication::applicationPid();
+    for (size_t i = 0; i < m_threadNames.size(); ++i) {
+        QJsonObject obj;
+        obj.insert(QLatin1String("ph"), QStringLiteral("M"));
+        obj.insert(QLatin1String("name"), QStringLiteral("thread_name"));
+        obj.insert(QLatin1String("pid"), pid);
+        obj.insert(QLatin1String("tid"), int(i));
+        obj.insert(QLatin1String("args"), QJsonObject{{QLatin1String("name"), m_threadNames.at(i)}});
+        list.append(obj);
+    }
+    for (const Event &e : m_events) {
+        QJsonObject obj;
+        obj.insert(QLatin1String("ph"), QString(QLatin1Char(e.phase)));
+        obj.insert(QLatin1String("cat"), QLatin1String(e.category));
+        obj.insert(QLatin1String("name"), QLatin1String(e.name));
+        obj.insert(QLatin1String("ts"), e.timestamp);
+        obj.insert(QLatin1String("pid"), pid);
+        obj.insert(QLatin1String("tid"), e.thread);
+        switch (e.phase) {
+        case 'X':
+            obj.insert(QLatin1String("dur"), e.duration);
+            break;
+        case 'C':
+            obj.insert(QLatin1String("args"), QJsonObject{{QLatin1String("value"), e.duration}});
+            break;
+        case 'i':
+            obj.insert(QLatin1String("s"), QStringLiteral("t"));
+            break;
+        case 'b':
+        case 'e':
+            obj.insert(QLatin1String("id"), QString::number(e.id));
+            break;
+        default:
+            break;
+        }
+        if (!e.detail.isEmpty()) {
+            obj.insert(QLatin1String("args"), QJsonObject{{QLatin1String("detail"), e.detail}});
+        }
+        list.append(obj);
+    }
+    QJsonObject json;
+    json.insert(QLatin1String("traceEvents"), list);
+    json.insert(QLatin1String("displayTimeUnit"), QStringLiteral("ms"));
+    if (m_dropped > 0) {
+        qCWarning(KDENLIVE_LOG) << "Trace buffer full," << m_dropped << "events were dropped";
+    }
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KDENLIVE_LOG) << "Cannot write trace to" << m_path;
+        return;
+    }
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    if (file.commit()) {
+        qCDebug(KDENLIVE_LOG) << "Wrote" << m_events.size() << "trace events to" << m_path;
+    }
+}
@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+/** @class Tracing
+    @brief Records timing events in the Chrome trace event format, to find where time goes in a running session.
+    Tracing is compiled in but disabled unless the KDENLIVE_TRACE environment variable contains a file path. Events are
+    then kept in memory and written to that file as JSON when the application exits, the result can be opened in
+    chrome://tracing or ui.perfetto.dev. When disabled, recording an event only costs an atomic load.
+    Category and event names must be string literals or other static strings, they are not copied.
+ */
+class Tracing
+{
+public:
+    /** @brief Enable tracing if requested by the environment. Called once on startup */
+    static void init();
+    /** @brief Returns true if events are recorded */
+    static bool isEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+    /** @brief Microseconds elapsed since tracing was enabled */
+    static qint64 now();
+    /** @brief Record an event that started at @p start (from now()) and ends now */
+    static void complete(const char *category, const char *name, qint64 start, const QString &detail = QString());
+    /** @brief Record a point in time event */
+    static void instant(const char *category, const char *name, const QString &detail = QString());
+    /** @brief Record an asynchronous span from @p start to now, for example the time spent by a job in a queue.
+     *  Spans are not tied to the thread they are recorded from, @p id must be unique among the overlapping spans with the same name
+     */
+    static void span(const char *category, const char *name, qint64 id, qint64 start, const QString &detail = QString());
+    /** @brief Record the value of a counter, displayed as a graph by the trace viewers */
+    static void counter(const char *category, const char *name, qint64 value);
+    /** @brief Write the recorded events to the trace file */
+    static void flush();
+
+private:
+    struct Event
+    {
+        char phase;
+        const char *category;
+        const char *name;
+        qint64 timestamp;
+        qint64 duration;
+        qint64 id;
+        int thread;
+        QString detail;
+    };
+    static std::atomic<bool> m_enabled;
+    static QElapsedTimer m_clock;
+    static QMutex m_mutex;
+    static std::vector<Event> m_events;
+    static std::vector<QString> m_threadNames;
+    static QString m_path;
+    static qint64 m_dropped;
+    static int threadIndex();
+    static void append(Event &&event);
+};
+
+/** @class TraceScope
+    @brief Records the scope it lives in as a trace event.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *category, const char *name)
+        : m_category(category)
+        , m_name(name)
+        , m_start(Tracing::isEnabled() ? Tracing::now() : -1)
+    {
+    }
+    TraceScope(const char *category, const char *name, const QString &detail)
+        : m_category(category)
+        , m_name(name)
+        , m_start(Tracing::isEnabled() ? Tracing::now() : -1)
+    {
+        if (m_start >= 0) {
+            m_detail = detail;
+        }
+    }
+    ~TraceScope()
+    {
+        if (m_start >= 0) {
+            Tracing::complete(m_category, m_name, m_start, m_detail);
+        }
+    }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *m_category;
+    const char *m_name;
+    qint64 m_start;
+    QString m_detail;
+};
+
+#define TRACE_SCOPE_CONCAT_(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_(a, b)
+/// Records the enclosing scope as a trace event, optionally followed by a detail string
+#define TRACE_SCOPE(category, ...) TraceScope TRACE_SCOPE_CONCAT(__traceScope, __LINE__)(category, __VA_ARGS__)
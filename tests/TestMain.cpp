@@ -8,10 +8,12 @@
 
 #include "bin/projectitemmodel.h"
 #include "core.h"
+#include "kdenlivesettings.h"
 #include "mltconnection.h"
 #include "src/effects/effectsrepository.hpp"
 #include "src/mltcontroller/clipcontroller.h"
 #include <QApplication>
+#include <QStandardPaths>
 #include <mlt++/MltFactory.h>
 #include <mlt++/MltRepository.h>
 
@@ -23,8 +25,12 @@ int main(int argc, char *argv[])
     qSetGlobalQHashSeed(0);
     QApplication app(argc, argv);
     app.setApplicationName(QStringLiteral("kdenlive"));
+    // Keep the caches and settings written by the tests away from the user's ones
+    QStandardPaths::setTestModeEnabled(true);
     std::unique_ptr<Mlt::Repository> repo(Mlt::Factory::init(nullptr));
     qputenv("MLT_TESTS", QByteArray("1"));
+    // Tests check each step of the undo history, don't merge successive moves
+    KdenliveSettings::setUndomergeinterval(0);
     qSetMessagePattern(QStringLiteral("%{time hh:mm:ss.zzz } %{file}:%{line} -- %{message}"));
     Core::build(LinuxPackageType::Unknown, true);
     MltConnection::construct(QString());
@@ -15,8 +15,13 @@
 
 #include "core.h"
 #include "definitions.h"
+#include "jobs/proxytask.h"
+#include "utils/cachemanager.hpp"
 #include "utils/thumbnailcache.hpp"
 
+#include <QImage>
+#include <QTemporaryDir>
+
 TEST_CASE("Cache insert-remove", "[Cache]")
 {
     // Create timeline
@@ -94,3 +99,202 @@ TEST_CASE("getAudioKey() should dereference `ok` param", "ThumbnailCache") {
     }
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
+
+TEST_CASE("Image proxy generation", "[ImageProxy]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString source = dir.filePath(QStringLiteral("source.jpg"));
+    QImage image(1200, 800, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    REQUIRE(image.save(source));
+    QString error;
+
+    SECTION("Large images are scaled down")
+    {
+        const QString dest = dir.filePath(QStringLiteral("proxy.png"));
+        REQUIRE(ProxyTask::createImageProxy(source, dest, 640, 1, error) == ProxyTask::ImageProxyResult::Created);
+        QImage proxy(dest);
+        REQUIRE(proxy.width() == 640);
+        REQUIRE(qAbs(proxy.height() - 427) <= 1);
+        REQUIRE(QColor(proxy.pixel(10, 10)).red() > 240);
+    }
+
+    SECTION("EXIF orientation is applied")
+    {
+        const QString dest = dir.filePath(QStringLiteral("rotated.png"));
+        REQUIRE(ProxyTask::createImageProxy(source, dest, 640, 6, error) == ProxyTask::ImageProxyResult::Created);
+        QImage proxy(dest);
+        REQUIRE(proxy.height() == 640);
+        REQUIRE(qAbs(proxy.width() - 427) <= 1);
+    }
+
+    SECTION("Small images are not re-encoded")
+    {
+        const QString dest = dir.filePath(QStringLiteral("small.png"));
+        REQUIRE(ProxyTask::createImageProxy(source, dest, 1200, 1, error) == ProxyTask::ImageProxyResult::TooSmall);
+        REQUIRE_FALSE(QFile::exists(dest));
+    }
+
+    SECTION("Missing images fail")
+    {
+        const QString dest = dir.filePath(QStringLiteral("missing.png"));
+        REQUIRE(ProxyTask::createImageProxy(dir.filePath(QStringLiteral("missing.jpg")), dest, 640, 1, error) == ProxyTask::ImageProxyResult::Failed);
+        REQUIRE_FALSE(error.isEmpty());
+        REQUIRE_FALSE(QFile::exists(dest));
+    }
+}
+
+TEST_CASE("Cache budget", "[CacheBudget]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    auto writeFile = [&dir](const QString &name, int size) {
+        const QString path = dir.filePath(name);
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(size, 'x'));
+        file.close();
+        return path;
+    };
+    const QString indexPath = dir.filePath(QStringLiteral("cacheindex"));
+    CacheManager manager(indexPath);
+    REQUIRE_FALSE(manager.m_indexed);
+    auto setLastAccess = [&manager](const QString &path, qint64 time) {
+        auto it = manager.m_entries.find(QDir::cleanPath(QFileInfo(path).absoluteFilePath()));
+        REQUIRE(it != manager.m_entries.end());
+        it->lastAccess = time;
+    };
+
+    const QString thumb1 = writeFile(QStringLiteral("1/videothumbs/a.jpg"), 100);
+    const QString thumb2 = writeFile(QStringLiteral("1/videothumbs/b.jpg"), 200);
+    const QString audio = writeFile(QStringLiteral("1/audiothumbs/c.png"), 50);
+    const QString proxy = writeFile(QStringLiteral("proxy/d.mkv"), 1000);
+    manager.recordWrite(CacheThumbs, thumb1);
+    manager.recordWrite(CacheThumbs, thumb2);
+    manager.recordWrite(CacheAudio, audio);
+    manager.recordWrite(CacheProxy, proxy);
+
+    SECTION("Usage is tracked by type")
+    {
+        REQUIRE(manager.usage(CacheThumbs) == 300);
+        REQUIRE(manager.usage(CacheAudio) == 50);
+        REQUIRE(manager.usage(CacheProxy) == 1000);
+        // Proxies are not counted in the total
+        REQUIRE(manager.totalUsage() == 350);
+        // Rewriting a file replaces its size
+        writeFile(QStringLiteral("1/videothumbs/b.jpg"), 300);
+        manager.recordWrite(CacheThumbs, thumb2);
+        REQUIRE(manager.usage(CacheThumbs) == 400);
+        manager.recordRemoval(thumb1);
+        REQUIRE(manager.usage(CacheThumbs) == 300);
+        manager.recordFolderRemoval(dir.filePath(QStringLiteral("1")));
+        REQUIRE(manager.totalUsage() == 0);
+        REQUIRE(manager.usage(CacheProxy) == 1000);
+    }
+
+    SECTION("Files of the current session are kept")
+    {
+        REQUIRE(manager.evict({{CacheThumbs, 1}}, 1) == 0);
+        REQUIRE(QFile::exists(thumb1));
+        REQUIRE(QFile::exists(thumb2));
+        REQUIRE(manager.usage(CacheThumbs) == 300);
+    }
+
+    SECTION("Least recently used files are deleted first")
+    {
+        manager.m_sessionStart = QDateTime::currentSecsSinceEpoch() + 100;
+        setLastAccess(proxy, 5);
+        setLastAccess(thumb1, 10);
+        setLastAccess(audio, 20);
+        setLastAccess(thumb2, 30);
+        // The thumbnails budget only deletes thumbnails
+        REQUIRE(manager.evict({{CacheThumbs, 250}}, 0) == 1);
+        REQUIRE_FALSE(QFile::exists(thumb1));
+        REQUIRE(QFile::exists(audio));
+        REQUIRE(manager.usage(CacheThumbs) == 200);
+        // The total budget ignores proxies
+        REQUIRE(manager.evict({}, 210) == 1);
+        REQUIRE_FALSE(QFile::exists(audio));
+        REQUIRE(QFile::exists(thumb2));
+        REQUIRE(QFile::exists(proxy));
+        REQUIRE(manager.totalUsage() == 200);
+        // A file used in this session is kept
+        manager.m_sessionStart = QDateTime::currentSecsSinceEpoch();
+        manager.recordAccess(thumb2);
+        REQUIRE(manager.evict({}, 1) == 0);
+        REQUIRE(QFile::exists(thumb2));
+        // The proxy budget
+        REQUIRE(manager.evict({{CacheProxy, 500}}, 0) == 1);
+        REQUIRE_FALSE(QFile::exists(proxy));
+        REQUIRE(manager.usage(CacheProxy) == 0);
+    }
+
+    SECTION("Files of the open project are kept")
+    {
+        manager.m_sessionStart = QDateTime::currentSecsSinceEpoch() + 100;
+        setLastAccess(thumb1, 10);
+        setLastAccess(thumb2, 20);
+        setLastAccess(audio, 30);
+        manager.setDocumentFolder(dir.filePath(QStringLiteral("1")));
+        REQUIRE(manager.evict({{CacheThumbs, 1}}, 1) == 0);
+        REQUIRE(QFile::exists(thumb1));
+        REQUIRE(QFile::exists(audio));
+        // Once another project is open, they can be deleted
+        manager.setDocumentFolder(dir.filePath(QStringLiteral("2")));
+        REQUIRE(manager.evict({{CacheThumbs, 250}}, 0) == 1);
+        REQUIRE_FALSE(QFile::exists(thumb1));
+    }
+
+    SECTION("Files outside the cache folder are not recorded")
+    {
+        QTemporaryDir projectFolder;
+        REQUIRE(projectFolder.isValid());
+        const QString path = projectFolder.filePath(QStringLiteral("g.jpg"));
+        QFile file(path);
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(100, 'x'));
+        file.close();
+        manager.recordWrite(CacheThumbs, path);
+        REQUIRE(manager.usage(CacheThumbs) == 300);
+    }
+
+    SECTION("Deleted files are dropped from the index")
+    {
+        manager.m_sessionStart = QDateTime::currentSecsSinceEpoch() + 100;
+        setLastAccess(thumb1, 10);
+        setLastAccess(thumb2, 20);
+        QFile::remove(thumb1);
+        REQUIRE(manager.evict({{CacheThumbs, 250}}, 0) == 0);
+        REQUIRE(manager.usage(CacheThumbs) == 200);
+        REQUIRE(QFile::exists(thumb2));
+    }
+
+    SECTION("Index is saved and loaded")
+    {
+        setLastAccess(thumb1, 10);
+        manager.save();
+        REQUIRE_FALSE(manager.m_changed);
+        CacheManager loaded(indexPath);
+        REQUIRE(loaded.m_indexed);
+        REQUIRE(loaded.usage(CacheThumbs) == 300);
+        REQUIRE(loaded.usage(CacheAudio) == 50);
+        REQUIRE(loaded.usage(CacheProxy) == 1000);
+        REQUIRE(loaded.m_entries.value(QDir::cleanPath(QFileInfo(thumb1).absoluteFilePath())).lastAccess == 10);
+    }
+
+    SECTION("Existing cache folders are imported")
+    {
+        writeFile(QStringLiteral("2/preview/store/e.mp4"), 400);
+        writeFile(QStringLiteral("other/videothumbs/f.jpg"), 500);
+        CacheManager imported(dir.filePath(QStringLiteral("missingindex")));
+        imported.importFolders();
+        REQUIRE(imported.usage(CacheThumbs) == 300);
+        REQUIRE(imported.usage(CacheAudio) == 50);
+        REQUIRE(imported.usage(CachePreview) == 400);
+        REQUIRE(imported.usage(CacheProxy) == 1000);
+        // Imported files were not used in this session
+        REQUIRE(imported.m_entries.value(QDir::cleanPath(QFileInfo(thumb1).absoluteFilePath())).lastAccess <= imported.m_sessionStart);
+    }
+}
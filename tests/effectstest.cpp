@@ -7,6 +7,7 @@
 // test specific headers
 #include "doc/docundostack.hpp"
 #include "doc/kdenlivedoc.h"
+#include <QElapsedTimer>
 #include <cmath>
 #include <iostream>
 #include <tuple>
@@ -18,7 +19,48 @@
 #include "effects/effectstack/model/effectitemmodel.hpp"
 #include "effects/effectstack/model/effectstackmodel.hpp"
 
+// Gives access to the asset cache of a fresh repository
+class TestEffectsRepository : public EffectsRepository
+{
+public:
+    TestEffectsRepository() = default;
+    bool loadedFromCache() const { return m_loadedFromCache; }
+    QString cachePath() const { return assetCachePath(); }
+};
+
 QString anEffect;
+TEST_CASE("Effects repository cache", "[Effects]")
+{
+    QElapsedTimer timer;
+    timer.start();
+    // Cache was written when the repository was first built
+    TestEffectsRepository cached;
+    qint64 cachedTime = timer.restart();
+    REQUIRE(cached.loadedFromCache());
+
+    // Force parsing of MLT metadata and asset files
+    QFile::remove(cached.cachePath());
+    TestEffectsRepository parsed;
+    qint64 parsedTime = timer.elapsed();
+    REQUIRE_FALSE(parsed.loadedFromCache());
+    REQUIRE(QFile::exists(cached.cachePath()));
+    qDebug() << "Effects repository startup:" << parsedTime << "ms parsed," << cachedTime << "ms from cache";
+
+    // Both repositories must describe the same assets
+    const auto names = parsed.getNames();
+    REQUIRE(names == cached.getNames());
+    for (const auto &asset : names) {
+        REQUIRE(cached.getType(asset.first) == parsed.getType(asset.first));
+        REQUIRE(cached.getDescription(asset.first) == parsed.getDescription(asset.first));
+        REQUIRE(cached.getVersion(asset.first) == parsed.getVersion(asset.first));
+        QDomDocument cachedDoc;
+        cachedDoc.appendChild(cached.getXml(asset.first));
+        QDomDocument parsedDoc;
+        parsedDoc.appendChild(parsed.getXml(asset.first));
+        REQUIRE(cachedDoc.toString() == parsedDoc.toString());
+    }
+}
+
 TEST_CASE("Effects stack", "[Effects]")
 {
     // Create timeline
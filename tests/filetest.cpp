@@ -10,6 +10,7 @@
 #include "timeline2/model/builders/meltBuilder.hpp"
 #include "xml/xml.hpp"
 
+#include <QElapsedTimer>
 #include <QTemporaryFile>
 #include <QUndoGroup>
 
@@ -472,3 +473,70 @@ TEST_CASE("Opening File With Keyframes", "[OPENKFRS]")
         pCore->projectManager()->closeCurrentDocument(false, false);
     }
 }
+
+TEST_CASE("Load large project", "[.][LOADBENCH]")
+{
+    // Not run by default, use: filetest "[LOADBENCH]"
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    const int clipsPerTrack = 5000;
+    QString saveFile = QDir::temp().absoluteFilePath(QStringLiteral("test-large.kdenlive"));
+
+    SECTION("Create and save a project with 10000 clips")
+    {
+        KdenliveDoc document(undoStack);
+        pCore->projectManager()->m_project = &document;
+        QDateTime documentDate = QDateTime::currentDateTime();
+        pCore->projectManager()->updateTimeline(false, QString(), QString(), documentDate, 0);
+        auto timeline = document.getTimeline(document.uuid());
+        pCore->projectManager()->testSetActiveDocument(&document, timeline);
+        KdenliveDoc::next_id = 0;
+
+        QString binId = createProducer(pCore->getProjectProfile(), "red", binModel, 20, false);
+        QStringList binIds;
+        for (int i = 0; i < clipsPerTrack; i++) {
+            binIds << binId;
+        }
+        for (int position = 2; position < 4; position++) {
+            int tid = timeline->getTrackIndexFromPosition(position);
+            QList<int> clipIds;
+            REQUIRE(timeline->requestClipsInsertion(binIds, tid, 0, clipIds, false));
+            REQUIRE(timeline->getTrackClipsCount(tid) == clipsPerTrack);
+        }
+        REQUIRE(timeline->checkConsistency());
+        pCore->projectManager()->testSaveFileAs(saveFile);
+        pCore->projectManager()->closeCurrentDocument(false, false);
+    }
+    SECTION("Reopen the project")
+    {
+        KdenliveDoc::next_id = 0;
+        QUrl openURL = QUrl::fromLocalFile(saveFile);
+        QUndoGroup *undoGroup = new QUndoGroup();
+        undoGroup->addStack(undoStack.get());
+
+        QElapsedTimer timer;
+        timer.start();
+        DocOpenResult openResults = KdenliveDoc::Open(openURL, QDir::temp().path(), undoGroup, false, nullptr);
+        REQUIRE(openResults.isSuccessful() == true);
+        std::unique_ptr<KdenliveDoc> openedDoc = openResults.getDocument();
+        pCore->projectManager()->m_project = openedDoc.get();
+        const QUuid uuid = openedDoc->uuid();
+        QDateTime documentDate = QFileInfo(openURL.toLocalFile()).lastModified();
+        pCore->projectManager()->updateTimeline(false, QString(), QString(), documentDate, 0);
+        auto timeline = openedDoc->getTimeline(uuid);
+        qint64 elapsed = timer.elapsed();
+        pCore->projectManager()->testSetActiveDocument(openedDoc.get(), timeline);
+        std::cout << "Loaded " << 2 * clipsPerTrack << " clips in " << elapsed << " ms" << std::endl;
+
+        REQUIRE(timeline->isBulkLoading() == false);
+        REQUIRE(timeline->checkConsistency());
+        for (int position = 2; position < 4; position++) {
+            int tid = timeline->getTrackIndexFromPosition(position);
+            REQUIRE(timeline->getTrackClipsCount(tid) == clipsPerTrack);
+            REQUIRE(timeline->rowCount(timeline->makeTrackIndexFromID(tid)) == clipsPerTrack);
+        }
+        pCore->projectManager()->closeCurrentDocument(false, false);
+        QFile::remove(saveFile);
+    }
+}
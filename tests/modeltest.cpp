@@ -1567,6 +1567,56 @@ TEST_CASE("Undo and Redo", "[ClipModel]")
         state1();
     }
 
+    SECTION("Multiple clips insertion undo")
+    {
+        QString binId3 = createProducer(pCore->getProjectProfile(), "green", binModel);
+        REQUIRE(timeline->requestClipMove(cid1, tid1, 5));
+        auto state1 = [&]() {
+            REQUIRE(timeline->checkConsistency());
+            REQUIRE(timeline->getTrackClipsCount(tid1) == 1);
+            REQUIRE(timeline->getClipPosition(cid1) == 5);
+            REQUIRE(undoStack->index() == init_index + 1);
+        };
+        state1();
+
+        // Overlapping an existing clip fails and leaves the track untouched
+        QList<int> clipIds;
+        REQUIRE_FALSE(timeline->requestClipsInsertion({binId3, binId3, binId3}, tid1, 0, clipIds));
+        REQUIRE(clipIds.isEmpty());
+        state1();
+
+        REQUIRE(timeline->requestClipsInsertion({binId3, binId3 + "/1/10", binId3}, tid1, 5 + length, clipIds));
+        auto state2 = [&]() {
+            REQUIRE(timeline->checkConsistency());
+            REQUIRE(timeline->getTrackClipsCount(tid1) == 4);
+            REQUIRE(clipIds.size() == 3);
+            REQUIRE(timeline->getClipPosition(clipIds.at(0)) == 5 + length);
+            REQUIRE(timeline->getClipPosition(clipIds.at(1)) == 5 + 2 * length);
+            REQUIRE(timeline->getClipPlaytime(clipIds.at(1)) == 10);
+            REQUIRE(timeline->getClipPosition(clipIds.at(2)) == 15 + 2 * length);
+            for (int cid : qAsConst(clipIds)) {
+                REQUIRE(timeline->getClipTrackId(cid) == tid1);
+            }
+            REQUIRE(timeline->duration() == 15 + 3 * length);
+            // The whole insertion is a single undo step
+            REQUIRE(undoStack->index() == init_index + 2);
+        };
+        state2();
+        undoStack->undo();
+        state1();
+        undoStack->redo();
+        state2();
+
+        // Insert in the blank before the first clip
+        QList<int> clipIds2;
+        REQUIRE_FALSE(timeline->requestClipsInsertion({binId3 + "/0/2", binId3 + "/0/3"}, tid1, 1, clipIds2));
+        REQUIRE(timeline->requestClipsInsertion({binId3 + "/0/1", binId3 + "/0/1"}, tid1, 1, clipIds2));
+        REQUIRE(timeline->checkConsistency());
+        REQUIRE(timeline->getTrackClipsCount(tid1) == 6);
+        REQUIRE(timeline->getClipPosition(clipIds2.at(1)) == 3);
+        undoStack->undo();
+        state2();
+    }
     SECTION("Clip Deletion undo")
     {
         REQUIRE(timeline->requestClipMove(cid1, tid1, 5));
@@ -1788,6 +1838,118 @@ TEST_CASE("Undo and Redo", "[ClipModel]")
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
 
+TEST_CASE("Undo history memory and merging", "[ClipModel]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    // Here we do some trickery to enable testing.
+    // We mock the project class so that the undoStack function returns our undoStack
+    KdenliveDoc document(undoStack);
+
+    // We also mock timeline object to spy few functions and mock others
+    pCore->projectManager()->m_project = &document;
+    TimelineItemModel tim(document.uuid(), undoStack);
+    Mock<TimelineItemModel> timMock(tim);
+    auto timeline = std::shared_ptr<TimelineItemModel>(&timMock.get(), [](...) {});
+    TimelineItemModel::finishConstruct(timeline);
+    pCore->projectManager()->testSetActiveDocument(&document, timeline);
+
+    RESET(timMock);
+
+    QString binId = createProducer(pCore->getProjectProfile(), "red", binModel);
+    int tid1 = TrackModel::construct(timeline);
+    int cid1 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid2 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    REQUIRE(timeline->requestClipMove(cid1, tid1, 0, true, true, false));
+    REQUIRE(timeline->requestClipMove(cid2, tid1, 100, true, true, false));
+    undoStack->clear();
+
+    SECTION("Successive moves of a clip are merged")
+    {
+        undoStack->setMergeInterval(3000);
+        REQUIRE(timeline->requestClipMove(cid1, tid1, 10));
+        REQUIRE(timeline->requestClipMove(cid1, tid1, 20));
+        REQUIRE(timeline->requestClipMove(cid1, tid1, 30));
+        REQUIRE(undoStack->count() == 1);
+        // Moving another clip creates a new step
+        REQUIRE(timeline->requestClipMove(cid2, tid1, 120));
+        REQUIRE(undoStack->count() == 2);
+        undoStack->undo();
+        REQUIRE(timeline->getClipPosition(cid2) == 100);
+        REQUIRE(timeline->getClipPosition(cid1) == 30);
+        undoStack->undo();
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        REQUIRE(timeline->checkConsistency());
+        undoStack->redo();
+        REQUIRE(timeline->getClipPosition(cid1) == 30);
+        REQUIRE(timeline->checkConsistency());
+        undoStack->setMergeInterval(0);
+    }
+
+    SECTION("Moves of a keyframe are chained by position")
+    {
+        undoStack->setMergeInterval(3000);
+        Fun noop = []() { return true; };
+        auto pushMove = [&](int from, int to) {
+            auto *command = new FunctionalUndoCommand(noop, noop, QStringLiteral("Move keyframe"));
+            command->setMergeKey(UndoMergeId::MoveKeyframe, QStringLiteral("effect:%1").arg(from), QStringLiteral("effect:%1").arg(to));
+            undoStack->push(command);
+        };
+        // Dragging a keyframe from 10 to 30 is a single step
+        pushMove(10, 20);
+        pushMove(20, 30);
+        REQUIRE(undoStack->count() == 1);
+        // Moving another keyframe of the same effect is a new step
+        pushMove(50, 60);
+        REQUIRE(undoStack->count() == 2);
+        pushMove(30, 40);
+        REQUIRE(undoStack->count() == 3);
+        undoStack->setMergeInterval(0);
+    }
+
+    SECTION("Oldest steps are compacted over budget")
+    {
+        for (int i = 1; i <= 6; i++) {
+            REQUIRE(timeline->requestClipMove(cid1, tid1, 10 * i));
+        }
+        REQUIRE(undoStack->count() == 6);
+        REQUIRE(undoStack->compactedCount() == 0);
+        qint64 usage = undoStack->memoryUsage();
+        REQUIRE(usage > 0);
+        REQUIRE(DocUndoStack::commandCost(undoStack->command(0)) > 0);
+
+        // Budget for about half of the history
+        undoStack->setMemoryBudget(usage / 2);
+        REQUIRE(undoStack->compactedCount() > 0);
+        REQUIRE(undoStack->compactedCount() < 6);
+        REQUIRE(undoStack->memoryUsage() < usage);
+        REQUIRE(undoStack->canUndo());
+        REQUIRE_FALSE(undoStack->memoryReport().isEmpty());
+
+        // The remaining steps can still be undone and redone
+        int compacted = undoStack->compactedCount();
+        int remaining = undoStack->count() - compacted;
+        for (int i = 0; i < remaining; i++) {
+            undoStack->undo();
+        }
+        REQUIRE(timeline->getClipPosition(cid1) == 10 * compacted);
+        REQUIRE(timeline->checkConsistency());
+        // Undoing a compacted step removes it without changing the timeline
+        undoStack->undo();
+        REQUIRE(timeline->getClipPosition(cid1) == 10 * compacted);
+        REQUIRE(undoStack->count() == 5);
+        for (int i = 0; i < remaining; i++) {
+            undoStack->redo();
+        }
+        REQUIRE(timeline->getClipPosition(cid1) == 60);
+        REQUIRE(timeline->checkConsistency());
+        undoStack->setMemoryBudget(0);
+    }
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
+
 TEST_CASE("Snapping", "[Snapping]")
 {
     auto binModel = pCore->projectItemModel();
@@ -8,6 +8,12 @@
 #include "render/renderrequest.h"
 #include "renderpresets/renderpresetmodel.hpp"
 #include "renderpresets/renderpresetrepository.hpp"
+#include "renderer/audiostems.h"
+#include "xml/xml.hpp"
+
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <cstring>
 
 TEST_CASE("Basic tests of the render preset model", "[RenderPresets]")
 {
@@ -293,3 +299,149 @@ TEST_CASE("Tests of the render functions to use guides for sections", "[RenderRe
         CHECK(sections.at(2).out == out);
     }
 }
+
+TEST_CASE("Tests of the multi audio track export", "[RenderRequestAudioStems]")
+{
+    const QUuid uuid = QUuid::createUuid();
+    QDomDocument doc;
+    doc.setContent(QStringLiteral("<mlt producer=\"main_bin\">"
+                                  "<consumer target=\"/tmp/render.mp4\"/>"
+                                  "<tractor id=\"tractor0\"><property name=\"kdenlive:audio_track\">1</property>"
+                                  "<property name=\"kdenlive:track_name\">Music</property></tractor>"
+                                  "<tractor id=\"tractor1\"><property name=\"kdenlive:audio_track\">1</property></tractor>"
+                                  "<tractor id=\"tractor2\"><property name=\"kdenlive:audio_track\">1</property></tractor>"
+                                  "<tractor id=\"tractor3\"></tractor>"
+                                  "<tractor id=\"timeline\"><property name=\"kdenlive:uuid\">%1</property>"
+                                  "<track producer=\"tractor0\"/><track producer=\"tractor1\" hide=\"audio\"/>"
+                                  "<track producer=\"tractor2\"/><track producer=\"tractor3\"/></tractor>"
+                                  "</mlt>")
+                       .arg(uuid.toString()));
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    std::vector<RenderRequest::RenderJob> jobs;
+    RenderRequest::prepareAudioStems(jobs, doc, dir.filePath(QStringLiteral("render.mlt")), QStringLiteral("/tmp/render.mp4"), uuid);
+
+    // A single job renders all the audio tracks
+    REQUIRE(jobs.size() == 1);
+    CHECK(jobs.front().audioStems);
+    CHECK(jobs.front().outputPath == QStringLiteral("/tmp/render_Audio_Mix.wav"));
+    CHECK(RenderRequest::argsByJob(jobs.front()).contains(QStringLiteral("--audio-stems")));
+
+    QFile file(jobs.front().playlistPath);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    QDomDocument result;
+    REQUIRE(result.setContent(&file));
+    CHECK(result.documentElement().attribute(QStringLiteral("producer")) == QStringLiteral("kdenlive_audio_stems"));
+    CHECK(result.elementsByTagName(QStringLiteral("consumer")).at(0).toElement().attribute(QStringLiteral("target")) == jobs.front().outputPath);
+
+    // The stems tractor is the last one and lists the audio tracks that are not muted
+    QDomNodeList tractors = result.elementsByTagName(QStringLiteral("tractor"));
+    QDomElement stems = tractors.at(tractors.count() - 1).toElement();
+    CHECK(stems.attribute(QStringLiteral("id")) == QStringLiteral("kdenlive_audio_stems"));
+    QDomNodeList tracks = stems.elementsByTagName(QStringLiteral("track"));
+    REQUIRE(tracks.count() == 3);
+    CHECK(tracks.at(0).toElement().attribute(QStringLiteral("producer")) == QStringLiteral("tractor2"));
+    CHECK(tracks.at(1).toElement().attribute(QStringLiteral("producer")) == QStringLiteral("tractor0"));
+    CHECK(Xml::getXmlProperty(stems, QStringLiteral("kdenlive:stem.0")) == QStringLiteral("/tmp/render_Audio_1.wav"));
+    CHECK(Xml::getXmlProperty(stems, QStringLiteral("kdenlive:stem.1")) == QStringLiteral("/tmp/render_Audio_3-Music.wav"));
+    // The mixdown comes from the rendered tractor, so it includes the transitions and master effects
+    CHECK(tracks.at(2).toElement().attribute(QStringLiteral("producer")) == QStringLiteral("timeline"));
+    CHECK(Xml::getXmlProperty(stems, QStringLiteral("kdenlive:stem_mix")) == QStringLiteral("2"));
+    CHECK(Xml::getXmlProperty(stems, QStringLiteral("kdenlive:stem_format")) == QStringLiteral("s16"));
+}
+
+TEST_CASE("The audio stems follow the sample format of the preset", "[RenderRequestAudioStems]")
+{
+    const QUuid uuid = QUuid::createUuid();
+    auto stemFormat = [uuid](const QString &consumer) {
+        QDomDocument doc;
+        doc.setContent(QStringLiteral("<mlt>%1"
+                                      "<tractor id=\"tractor0\"><property name=\"kdenlive:audio_track\">1</property></tractor>"
+                                      "<tractor id=\"timeline\"><property name=\"kdenlive:uuid\">%2</property><track producer=\"tractor0\"/></tractor>"
+                                      "</mlt>")
+                           .arg(consumer, uuid.toString()));
+        QTemporaryDir dir;
+        std::vector<RenderRequest::RenderJob> jobs;
+        RenderRequest::prepareAudioStems(jobs, doc, dir.filePath(QStringLiteral("render.mlt")), QStringLiteral("/tmp/render.wav"), uuid);
+        REQUIRE(jobs.size() == 1);
+        QFile file(jobs.front().playlistPath);
+        REQUIRE(file.open(QIODevice::ReadOnly));
+        QDomDocument result;
+        REQUIRE(result.setContent(&file));
+        QDomNodeList tractors = result.elementsByTagName(QStringLiteral("tractor"));
+        return Xml::getXmlProperty(tractors.at(tractors.count() - 1).toElement(), QStringLiteral("kdenlive:stem_format"));
+    };
+    CHECK(stemFormat(QStringLiteral("<consumer target=\"/tmp/render.wav\" acodec=\"pcm_s16le\"/>")) == QStringLiteral("s16"));
+    CHECK(stemFormat(QStringLiteral("<consumer target=\"/tmp/render.wav\" acodec=\"pcm_s24le\"/>")) == QStringLiteral("s24"));
+    CHECK(stemFormat(QStringLiteral("<consumer target=\"/tmp/render.wav\" acodec=\"pcm_f32le\"/>")) == QStringLiteral("f32"));
+    CHECK(stemFormat(QStringLiteral("<consumer target=\"/tmp/render.flac\" acodec=\"flac\" sample_fmt=\"s32\"/>")) == QStringLiteral("s24"));
+    CHECK(stemFormat(QStringLiteral("<consumer target=\"/tmp/render.mp3\" acodec=\"libmp3lame\"/>")) == QStringLiteral("s16"));
+}
+
+TEST_CASE("The audio stems and the mixdown are rendered in a single pass", "[AudioStems]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    // Two tone tracks mixed by the rendered tractor, the stems job lists them before the rendered tractor
+    const QString tone = QStringLiteral("<producer id=\"%1\" in=\"0\" out=\"24\"><property name=\"mlt_service\">tone</property>"
+                                        "<property name=\"frequency\">%2</property><property name=\"level\">-6</property>"
+                                        "<property name=\"length\">25</property></producer>"
+                                        "<playlist id=\"%3\"><entry producer=\"%1\" in=\"0\" out=\"24\"/></playlist>");
+    const QString playlist = dir.filePath(QStringLiteral("render_Audio.mlt"));
+    QFile file(playlist);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(QStringLiteral("<mlt><profile frame_rate_num=\"25\" frame_rate_den=\"1\" width=\"320\" height=\"240\" progressive=\"1\" "
+                              "sample_aspect_num=\"1\" sample_aspect_den=\"1\" display_aspect_num=\"4\" display_aspect_den=\"3\" colorspace=\"709\"/>"
+                              "<consumer target=\"%1\" in=\"0\" out=\"24\" frequency=\"48000\" channels=\"2\"/>%2%3"
+                              "<tractor id=\"timeline\"><track producer=\"playlist0\"/><track producer=\"playlist1\"/>"
+                              "<transition><property name=\"mlt_service\">mix</property><property name=\"a_track\">0</property>"
+                              "<property name=\"b_track\">1</property><property name=\"always_active\">1</property><property name=\"sum\">1</property>"
+                              "</transition></tractor>"
+                              "<tractor id=\"kdenlive_audio_stems\"><property name=\"kdenlive:stem.0\">%4</property>"
+                              "<property name=\"kdenlive:stem.1\">%5</property><property name=\"kdenlive:stem_mix\">2</property>"
+                              "<property name=\"kdenlive:stem_format\">f32</property>"
+                              "<track producer=\"playlist0\"/><track producer=\"playlist1\"/><track producer=\"timeline\"/></tractor></mlt>")
+                   .arg(dir.filePath(QStringLiteral("mix.wav")), tone.arg(QStringLiteral("tone0"), QStringLiteral("440"), QStringLiteral("playlist0")),
+                        tone.arg(QStringLiteral("tone1"), QStringLiteral("1000"), QStringLiteral("playlist1")), dir.filePath(QStringLiteral("stem0.wav")),
+                        dir.filePath(QStringLiteral("stem1.wav")))
+                   .toUtf8());
+    file.close();
+    REQUIRE(AudioStems::render(playlist) == 0);
+
+    auto readSamples = [&dir](const QString &name) {
+        std::vector<float> samples;
+        QFile wav(dir.filePath(name));
+        if (!wav.open(QIODevice::ReadOnly)) {
+            return samples;
+        }
+        const QByteArray data = wav.readAll();
+        const int offset = data.indexOf("data");
+        if (offset < 0) {
+            return samples;
+        }
+        const int size = qFromLittleEndian<qint32>(data.constData() + offset + 4);
+        samples.resize(size_t(size) / sizeof(float));
+        memcpy(samples.data(), data.constData() + offset + 8, samples.size() * sizeof(float));
+        return samples;
+    };
+    const std::vector<float> stem0 = readSamples(QStringLiteral("stem0.wav"));
+    const std::vector<float> stem1 = readSamples(QStringLiteral("stem1.wav"));
+    const std::vector<float> mix = readSamples(QStringLiteral("mix.wav"));
+    // 25 frames at 25 fps, 48000 Hz stereo
+    REQUIRE(stem0.size() == 96000);
+    REQUIRE(stem1.size() == stem0.size());
+    REQUIRE(mix.size() == stem0.size());
+    float peak0 = 0.f;
+    float peak1 = 0.f;
+    float difference = 0.f;
+    for (size_t i = 0; i < mix.size(); ++i) {
+        peak0 = qMax(peak0, qAbs(stem0[i]));
+        peak1 = qMax(peak1, qAbs(stem1[i]));
+        difference = qMax(difference, qAbs(mix[i] - stem0[i] - stem1[i]));
+    }
+    // Each stem holds its own track, the tones are at -6 dB
+    CHECK(peak0 == Approx(0.5).epsilon(0.05));
+    CHECK(peak1 == Approx(0.5).epsilon(0.05));
+    // The mixdown is the sum of the stems on every frame, no track went missing
+    CHECK(difference < 0.01f);
+}
@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "core.h"
+#include "jobs/scenedetector.h"
+
+#include <QTemporaryDir>
+
+TEST_CASE("Frame signatures", "[SceneDetector]")
+{
+    const int width = 64;
+    const int height = 36;
+    std::vector<uint8_t> black(width * height, 16);
+    std::vector<uint8_t> white(width * height, 235);
+    // Vertical stripes, same mean level as gray but with strong edges
+    std::vector<uint8_t> stripes(width * height);
+    std::vector<uint8_t> gray(width * height, 128);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            stripes[size_t(y * width + x)] = (x / 4) % 2 == 0 ? 100 : 156;
+        }
+    }
+    const auto blackSig = SceneDetector::signature(black.data(), width, height, 1, width);
+    const auto whiteSig = SceneDetector::signature(white.data(), width, height, 1, width);
+    const auto stripesSig = SceneDetector::signature(stripes.data(), width, height, 1, width);
+
+    REQUIRE(SceneDetector::difference(blackSig, blackSig) == Approx(0.));
+    // Flat frames only differ by their histogram
+    REQUIRE(SceneDetector::difference(blackSig, whiteSig) == Approx(0.5));
+    // Adding edges counts as a change of content
+    REQUIRE(SceneDetector::difference(SceneDetector::signature(gray.data(), width, height, 1, width), stripesSig) > 0.9);
+
+    // Packed yuv422 gives the same result as the planar luma
+    std::vector<uint8_t> packed(width * height * 2, 128);
+    for (size_t i = 0; i < stripes.size(); ++i) {
+        packed[2 * i] = stripes[i];
+    }
+    const auto packedSig = SceneDetector::signature(packed.data(), width, height, 2, 2 * width);
+    REQUIRE(SceneDetector::difference(packedSig, stripesSig) == Approx(0.));
+}
+
+TEST_CASE("Scene detection on a clip", "[SceneDetector]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("scenes.mlt"));
+    const QStringList colors = {QStringLiteral("red"), QStringLiteral("green"), QStringLiteral("blue"), QStringLiteral("white")};
+    QString xml = QStringLiteral("<mlt>");
+    QString entries;
+    for (int i = 0; i < colors.size(); ++i) {
+        xml.append(QStringLiteral("<producer id=\"p%1\" in=\"0\" out=\"49\"><property name=\"mlt_service\">color</property>"
+                                  "<property name=\"resource\">%2</property></producer>")
+                       .arg(i)
+                       .arg(colors.at(i)));
+        entries.append(QStringLiteral("<entry producer=\"p%1\" in=\"0\" out=\"49\"/>").arg(i));
+    }
+    xml.append(QStringLiteral("<playlist id=\"main\">%1</playlist></mlt>").arg(entries));
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(xml.toUtf8());
+    file.close();
+
+    SceneDetector detector(pCore->getProjectProfile(), path, 0.3);
+    // Use several segments so that cuts on segment boundaries are checked
+    detector.m_segmentLength = 50;
+    int lastProgress = 0;
+    const QList<int> cuts = detector.detect(200, [&lastProgress](int progress) {
+        lastProgress = progress;
+        return true;
+    });
+    REQUIRE_FALSE(detector.hasFailed());
+    REQUIRE(cuts == QList<int>({50, 100, 150}));
+
+    // Aborting returns no result
+    const QList<int> canceled = detector.detect(200, [](int) { return false; });
+    REQUIRE(canceled.isEmpty());
+}
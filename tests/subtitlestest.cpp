@@ -216,6 +216,52 @@ TEST_CASE("Read subtitle file", "[Subtitles]")
         REQUIRE(subtitleModel->rowCount() == 0);
     }
 
+    SECTION("Add many subtitles at once and query them by range")
+    {
+        double fps = pCore->getCurrentFps();
+        QList<SubtitledTime> subs;
+        for (int i = 0; i < 2000; i++) {
+            subs << SubtitledTime(GenTime(10 * i, fps), QStringLiteral("Sub %1").arg(i), GenTime(10 * i + 5, fps));
+        }
+        // A long subtitle overlapping many others, and one colliding with an existing start that must be skipped
+        subs << SubtitledTime(GenTime(1003, fps), QStringLiteral("Long"), GenTime(1503, fps));
+        subs << SubtitledTime(GenTime(20, fps), QStringLiteral("Duplicate"), GenTime(25, fps));
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        REQUIRE(subtitleModel->addSubtitles(subs, undo, redo));
+        REQUIRE(subtitleModel->rowCount() == 2001);
+
+        int firstId = subtitleModel->getIdForStartPos(GenTime(0, fps));
+        int longId = subtitleModel->getIdForStartPos(GenTime(1003, fps));
+        REQUIRE(firstId > -1);
+        REQUIRE(longId > -1);
+        REQUIRE(subtitleModel->getText(subtitleModel->getIdForStartPos(GenTime(20, fps))) == QStringLiteral("Sub 2"));
+        REQUIRE(subtitleModel->getNextSub(firstId) == subtitleModel->getIdForStartPos(GenTime(10, fps)));
+        REQUIRE(subtitleModel->getPreviousSub(longId) == subtitleModel->getIdForStartPos(GenTime(1000, fps)));
+
+        // The long subtitle starts before the range but overlaps it
+        std::unordered_set<int> inRange = subtitleModel->getItemsInRange(1400, 1420);
+        REQUIRE(inRange.size() == 4);
+        REQUIRE(inRange.count(longId) == 1);
+        REQUIRE(subtitleModel->getItemsInRange(1505, 1505).empty());
+        REQUIRE_FALSE(subtitleModel->isBlankAt(1004));
+        REQUIRE(subtitleModel->isBlankAt(1506));
+        REQUIRE(subtitleModel->getBlankEnd(1506) == 1510);
+
+        // Moving a subtitle keeps the position index in sync
+        REQUIRE(subtitleModel->moveSubtitle(firstId, GenTime(30003, fps), false, false));
+        REQUIRE(subtitleModel->getIdForStartPos(GenTime(0, fps)) == -1);
+        REQUIRE(subtitleModel->getIdForStartPos(GenTime(30003, fps)) == firstId);
+
+        REQUIRE(undo());
+        REQUIRE(subtitleModel->rowCount() == 0);
+        REQUIRE(subtitleModel->getIdForStartPos(GenTime(1003, fps)) == -1);
+        REQUIRE(redo());
+        REQUIRE(subtitleModel->rowCount() == 2001);
+        subtitleModel->removeAllSubtitles();
+        REQUIRE(subtitleModel->rowCount() == 0);
+    }
+
     binModel->clean();
     pCore->m_projectManager = nullptr;
 }
@@ -0,0 +1,200 @@
+/*
+    SPDX-FileCopyrightText: 2024 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "core.h"
+#include "definitions.h"
+#include "doc/docundostack.hpp"
+#include "doc/kdenlivedoc.h"
+
+/* Performance benchmarks of the timeline model hot paths on a synthetic project.
+   This is built as a separate target and is not run by ctest, use for example:
+     timelinebenchmark --benchmark-samples 20 -r xml -o timelinebenchmark.xml
+   to get machine-readable results that can be compared between builds.
+   Each benchmark must leave the timeline in the state it found it, since Catch runs the body many times.
+*/
+
+namespace {
+const int clipsPerTrack = 5000;
+const int groupedClips = 1024;
+const int mixedClips = 1000;
+const int clipLength = 20;
+// Mixed clips must be longer than the default mix duration (25 frames)
+const int mixedLength = 50;
+
+/** @brief Ids of the items of the synthetic timeline */
+struct SyntheticTimeline
+{
+    // Two tracks with 5000 contiguous clips each
+    int tid1;
+    int tid2;
+    QList<int> clips1;
+    QList<int> clips2;
+    // 1024 spaced clips forming a binary tree of nested groups
+    int groupTrack;
+    std::vector<int> grouped;
+    int rootGroup;
+    // An empty track, used as a move target
+    int emptyTrack;
+    // 1000 clips with a same track mix between each of them
+    int mixTrack;
+    std::vector<int> mixed;
+};
+
+void buildSyntheticTimeline(const std::shared_ptr<TimelineItemModel> &timeline, SyntheticTimeline &data)
+{
+    auto binModel = pCore->projectItemModel();
+    QString binId = createProducer(pCore->getProjectProfile(), "red", binModel, clipLength);
+    QString mixBinId = createProducer(pCore->getProjectProfile(), "blue", binModel, 2 * mixedLength, false);
+    data.tid1 = timeline->getTrackIndexFromPosition(1);
+    data.tid2 = timeline->getTrackIndexFromPosition(2);
+    data.groupTrack = timeline->getTrackIndexFromPosition(3);
+    data.emptyTrack = timeline->getTrackIndexFromPosition(4);
+    data.mixTrack = timeline->getTrackIndexFromPosition(5);
+
+    QStringList binIds;
+    for (int i = 0; i < clipsPerTrack; i++) {
+        binIds << binId;
+    }
+    REQUIRE(timeline->requestClipsInsertion(binIds, data.tid1, 0, data.clips1, false));
+    REQUIRE(timeline->requestClipsInsertion(binIds, data.tid2, 0, data.clips2, false));
+
+    // Leave a blank of one clip between the grouped clips so that the groups can move
+    for (int i = 0; i < groupedClips; i++) {
+        int cid;
+        REQUIRE(timeline->requestClipInsertion(binId, data.groupTrack, 2 * i * clipLength, cid, false));
+        data.grouped.push_back(cid);
+    }
+    std::vector<int> level = data.grouped;
+    while (level.size() > 1) {
+        std::vector<int> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            int gid = timeline->requestClipsGroup({level[i], level[i + 1]}, false);
+            REQUIRE(gid > -1);
+            next.push_back(gid);
+        }
+        level = next;
+    }
+    data.rootGroup = level.front();
+
+    // Mixes need some extra frames on the clips, so insert longer clips and resize them
+    for (int i = 0; i <= mixedClips; i++) {
+        int cid;
+        REQUIRE(timeline->requestClipInsertion(mixBinId, data.mixTrack, i * mixedLength, cid, false));
+        REQUIRE(timeline->requestItemResize(cid, mixedLength, true, false) == mixedLength);
+        if (i > 0) {
+            REQUIRE(timeline->mixClip(cid));
+        }
+        data.mixed.push_back(cid);
+    }
+    REQUIRE(timeline->getTrackById_const(data.mixTrack)->mixCount() == mixedClips);
+}
+} // namespace
+
+TEST_CASE("Timeline model operations", "[TimelineBenchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    KdenliveDoc document(undoStack, {1, 5});
+    pCore->projectManager()->m_project = &document;
+    QDateTime documentDate = QDateTime::currentDateTime();
+    pCore->projectManager()->updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->m_activeTimelineModel = timeline;
+    pCore->projectManager()->testSetActiveDocument(&document, timeline);
+
+    SyntheticTimeline data;
+    buildSyntheticTimeline(timeline, data);
+    REQUIRE(timeline->checkConsistency());
+    undoStack->clear();
+    const int clipCount = timeline->getClipsCount();
+
+    const int middle = clipsPerTrack / 2;
+    const int middlePosition = middle * clipLength;
+    // Inside a clip on each track except the empty one, and outside of the mix zones
+    const int cutPosition = 1500 * clipLength + 15;
+
+    BENCHMARK("Move a clip to another track and back")
+    {
+        int cid = data.clips1.at(middle);
+        timeline->requestClipMove(cid, data.emptyTrack, middlePosition, true, true, false);
+        return timeline->requestClipMove(cid, data.tid1, middlePosition, true, true, false);
+    };
+    REQUIRE(timeline->getClipPosition(data.clips1.at(middle)) == middlePosition);
+    REQUIRE(timeline->getClipTrackId(data.clips1.at(middle)) == data.tid1);
+
+    BENCHMARK("Move the last clip of a track with 5000 clips")
+    {
+        // The last clip can move freely
+        int cid = data.clips1.last();
+        int position = (clipsPerTrack - 1) * clipLength;
+        timeline->requestClipMove(cid, data.tid1, position + 100, true, true, false);
+        return timeline->requestClipMove(cid, data.tid1, position, true, true, false);
+    };
+
+    BENCHMARK("Move a deep group")
+    {
+        timeline->requestGroupMove(data.grouped.front(), data.rootGroup, 0, 10, true, true, false);
+        return timeline->requestGroupMove(data.grouped.front(), data.rootGroup, 0, -10, true, true, false);
+    };
+    REQUIRE(timeline->getClipPosition(data.grouped.back()) == 2 * (groupedClips - 1) * clipLength);
+
+    BENCHMARK("Move a mixed clip to another track and undo")
+    {
+        int cid = data.mixed.at(mixedClips / 2);
+        bool result = timeline->requestClipMove(cid, data.emptyTrack, timeline->getClipPosition(cid));
+        undoStack->undo();
+        return result;
+    };
+    REQUIRE(timeline->getTrackById_const(data.mixTrack)->mixCount() == mixedClips);
+
+    BENCHMARK("Spacer operation on 500 clips and undo")
+    {
+        int position = (clipsPerTrack - 500) * clipLength;
+        std::pair<int, int> spacerOp = TimelineFunctions::requestSpacerStartOperation(timeline, data.tid1, position);
+        int cid = spacerOp.first;
+        int start = timeline->getItemPosition(cid);
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        bool result = TimelineFunctions::requestSpacerEndOperation(timeline, cid, start, start + 100, data.tid1, -1, undo, redo);
+        undoStack->undo();
+        return result;
+    };
+    REQUIRE(timeline->getClipPosition(data.clips1.last()) == (clipsPerTrack - 1) * clipLength);
+
+    BENCHMARK("Cut all tracks and undo")
+    {
+        bool result = TimelineFunctions::requestClipCutAll(timeline, cutPosition);
+        undoStack->undo();
+        return result;
+    };
+    REQUIRE(timeline->getClipsCount() == clipCount);
+
+    BENCHMARK("Suggest snap point")
+    {
+        return timeline->suggestSnapPoint(middlePosition + 3, 10);
+    };
+
+    BENCHMARK("Best snap position of a group")
+    {
+        std::vector<int> pts = {middlePosition, middlePosition + clipLength, middlePosition + 4 * clipLength};
+        return timeline->getBestSnapPos(middlePosition, 7, pts, 0, 10);
+    };
+
+    REQUIRE(timeline->requestClipMove(data.clips1.last(), data.emptyTrack, 0));
+    BENCHMARK("Undo and redo a clip move")
+    {
+        undoStack->undo();
+        undoStack->redo();
+        return undoStack->index();
+    };
+
+    REQUIRE(timeline->checkConsistency());
+    REQUIRE(timeline->getClipsCount() == clipCount);
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
@@ -6,7 +6,9 @@
 #include "catch.hpp"
 #include "test_utils.hpp"
 // test specific headers
+#include <QDomDocument>
 #include <QString>
+#include <QTemporaryDir>
 #include <cmath>
 #include <iostream>
 #include <tuple>
@@ -69,19 +71,30 @@ TEST_CASE("Timeline preview insert-remove", "[TimelinePreview]")
     timeline->buildPreviewTrack();
     REQUIRE(dir.exists(QLatin1String("preview")));
     dir.cd(QLatin1String("preview"));
+    // The chunk keys are computed in a worker thread and applied from the event loop
+    auto waitForKeys = [&timeline]() {
+        while (timeline->previewManager()->m_keysPending) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            qApp->processEvents();
+        }
+    };
     // Trigger a timeline preview
     timeline->previewManager()->addPreviewRange({0, 50}, true);
     timeline->previewManager()->startPreviewRender();
 
-    // Wait until the preview rendering is over
+    // Wait until the preview rendering is over, the render starts once the chunk keys are computed
     while (timeline->previewManager()->isRunning()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(2000));
         qDebug() << ":::: WAITING FOR PROGRESS...";
         qApp->processEvents();
     }
-    QFileInfoList list = dir.entryInfoList(QDir::Files, QDir::Time);
+    waitForKeys();
+    // Rendered chunks are moved to the shared store
+    QDir store = dir;
+    REQUIRE(store.cd(QLatin1String("store")));
+    QFileInfoList list = store.entryInfoList(QDir::Files, QDir::Time);
     for (auto &file : list) {
-        qDebug() << "::: FOUND FILE: " << dir.absoluteFilePath(file.fileName());
+        qDebug() << "::: FOUND FILE: " << store.absoluteFilePath(file.fileName());
     }
     if (list.size() != 3) {
         QProcess p;
@@ -104,15 +117,156 @@ TEST_CASE("Timeline preview insert-remove", "[TimelinePreview]")
     REQUIRE(timeline->requestClipInsertion(binId, tid3, 50, cid1, true, true, false));
     REQUIRE(timeline->getClipsCount() == 1);
     timeline->previewManager()->invalidatePreviews();
-    list = dir.entryInfoList(QDir::Files, QDir::Time);
+    waitForKeys();
+    list = store.entryInfoList(QDir::Files, QDir::Time);
     for (auto &file : list) {
         qDebug() << "::: FOUND FILE AFTER: " << file.fileName();
     }
-    // 2 chunks should remain
-    REQUIRE(list.size() == 2);
+    // 2 chunks should remain in the preview, the invalidated one stays in the store
+    REQUIRE(list.size() == 3);
+    REQUIRE(timeline->previewManager()->m_renderedChunks.count() == 2);
+    REQUIRE(timeline->previewManager()->m_dirtyChunks.contains(50));
+
+    // Undo restores the invalidated chunk from the store, without rendering
+    undoStack->undo();
+    REQUIRE(timeline->getClipsCount() == 0);
+    timeline->previewManager()->invalidatePreviews();
+    waitForKeys();
+    REQUIRE(timeline->previewManager()->m_renderedChunks.count() == 3);
+    REQUIRE(timeline->previewManager()->m_dirtyChunks.isEmpty());
+    REQUIRE_FALSE(timeline->previewManager()->isRunning());
     timeline->resetPreviewManager();
     // Ensure preview project folder is deleted on close
     REQUIRE(dir.exists() == false);
     binModel->clean();
     pCore->m_projectManager = nullptr;
 }
+
+TEST_CASE("Preview chunk set", "[ChunkSet]")
+{
+    ChunkSet chunks(25);
+    REQUIRE(chunks.isEmpty());
+    REQUIRE(chunks.first() == -1);
+
+    // Frames are aligned on the chunk size and adjacent ranges are merged
+    REQUIRE(chunks.insert(0, 110) == 5);
+    REQUIRE(chunks.insert(125, 200) == 4);
+    REQUIRE(chunks.runs().size() == 1);
+    REQUIRE(chunks.count() == 9);
+    REQUIRE(chunks.insert(50, 75) == 0);
+    REQUIRE(chunks.insert(500) == 1);
+    REQUIRE(chunks.toStringList() == QStringList({QStringLiteral("0-200"), QStringLiteral("500")}));
+    REQUIRE(chunks.contains(100));
+    REQUIRE_FALSE(chunks.contains(110));
+    REQUIRE_FALSE(chunks.contains(300));
+    REQUIRE(chunks.intersects(210, 510));
+    REQUIRE_FALSE(chunks.intersects(210, 490));
+
+    // Removing the middle of a run splits it
+    REQUIRE(chunks.remove(50, 100) == 3);
+    REQUIRE(chunks.count() == 7);
+    REQUIRE(chunks.toStringList() == QStringList({QStringLiteral("0-25"), QStringLiteral("125-200"), QStringLiteral("500")}));
+    REQUIRE(chunks.chunks(20, 150) == std::vector<int>({25, 125, 150}));
+    REQUIRE(chunks.first() == 0);
+    REQUIRE(chunks.last() == 500);
+
+    // Set operations
+    ChunkSet other(25);
+    other.insert(0, 600);
+    other.subtract(chunks);
+    REQUIRE(other.count() == 25 - 7);
+    REQUIRE_FALSE(other.contains(500));
+    other.unite(chunks);
+    REQUIRE(other.toStringList() == QStringList({QStringLiteral("0-600")}));
+
+    // The compressed list survives a round trip
+    REQUIRE(ChunkSet::fromString(chunks.toStringList().join(QLatin1Char(',')), 25) == chunks);
+    chunks.clear();
+    REQUIRE(chunks.isEmpty());
+    REQUIRE(chunks.count() == 0);
+}
+
+TEST_CASE("Preview chunk content keys", "[PreviewStore]")
+{
+    // A color background, a video track using the same source twice and an audio track
+    const QString scene = QStringLiteral(
+        "<mlt>"
+        "<producer id=\"black\"><property name=\"mlt_service\">color</property><property name=\"resource\">black</property>"
+        "<property name=\"length\">1000</property></producer>"
+        "<producer id=\"p1\"><property name=\"mlt_service\">avformat</property><property name=\"resource\">/tmp/clip.mp4</property>"
+        "<property name=\"kdenlive:id\">2</property></producer>"
+        "<producer id=\"p2\"><property name=\"mlt_service\">avformat</property><property name=\"resource\">/tmp/clip.mp4</property>"
+        "<property name=\"kdenlive:id\">3</property></producer>"
+        "<playlist id=\"bg\"><entry producer=\"black\" in=\"0\" out=\"999\"/></playlist>"
+        "<playlist id=\"v1\"><blank length=\"100\"/><entry producer=\"p1\" in=\"0\" out=\"49\"/><blank length=\"50\"/>"
+        "<entry producer=\"p2\" in=\"0\" out=\"49\"/></playlist>"
+        "<playlist id=\"a1\">%1</playlist>"
+        "<playlist id=\"preview\"><property name=\"kdenlive:playlistid\">timeline_preview</property>%2</playlist>"
+        "<tractor id=\"main\"><track producer=\"bg\"/><track producer=\"v1\"/><track producer=\"a1\" hide=\"video\"/>"
+        "<track producer=\"preview\"/>%3</tractor>"
+        "</mlt>");
+    auto keys = [&scene](const QString &audio, const QString &preview, const QString &filter, const QByteArray &salt = QByteArrayLiteral("salt")) {
+        QDomDocument doc;
+        REQUIRE(doc.setContent(scene.arg(audio, preview, filter)));
+        return PreviewChunkStore::chunkKeys(doc, {0, 25, 100, 125, 200, 225}, 25, salt);
+    };
+    const QMap<int, QString> base = keys(QString(), QString(), QString());
+    REQUIRE(base.size() == 6);
+    // The same source frames give the same key at another position, even from another bin clip
+    REQUIRE(base.value(100) == base.value(200));
+    REQUIRE(base.value(125) == base.value(225));
+    REQUIRE(base.value(100) != base.value(125));
+    // Empty chunks over a color have the same content
+    REQUIRE(base.value(0) == base.value(25));
+    REQUIRE(base.value(0) != base.value(100));
+
+    // Audio tracks and the preview track itself don't change the keys
+    const QString entry = QStringLiteral("<entry producer=\"p1\" in=\"0\" out=\"299\"/>");
+    REQUIRE(keys(entry, entry, QString()) == base);
+
+    // Other render parameters change all the keys
+    REQUIRE(keys(QString(), QString(), QString(), QByteArrayLiteral("other")).value(100) != base.value(100));
+
+    // A constant master effect changes the content but not the reuse across positions
+    const QMap<int, QString> blurred =
+        keys(QString(), QString(), QStringLiteral("<filter id=\"f1\"><property name=\"mlt_service\">box_blur</property></filter>"));
+    REQUIRE(blurred.value(100) != base.value(100));
+    REQUIRE(blurred.value(100) == blurred.value(200));
+
+    // An animated effect depends on the position
+    const QMap<int, QString> animated = keys(QString(), QString(),
+                                             QStringLiteral("<filter id=\"f1\"><property name=\"mlt_service\">affine</property>"
+                                                            "<property name=\"transition.rect\">0=0 0 100 100;300=50 50 100 100</property></filter>"));
+    REQUIRE(animated.value(100) != animated.value(200));
+
+    // An effect limited to the first clip only changes its chunks
+    const QMap<int, QString> limited =
+        keys(QString(), QString(), QStringLiteral("<filter id=\"f1\" in=\"100\" out=\"149\"><property name=\"mlt_service\">box_blur</property></filter>"));
+    REQUIRE(limited.value(100) != base.value(100));
+    REQUIRE(limited.value(200) == base.value(200));
+
+    // Entries are listed once for all the chunks, the keys don't depend on the other requested chunks
+    QDomDocument doc;
+    REQUIRE(doc.setContent(scene.arg(QString(), QString(), QString())));
+    REQUIRE(PreviewChunkStore::chunkKeys(doc, {125}, 25, QByteArrayLiteral("salt")).value(125) == base.value(125));
+}
+
+TEST_CASE("Preview chunk store lookup", "[PreviewStore]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    QDir storeDir(dir.path());
+    REQUIRE(storeDir.mkpath(QStringLiteral("store")));
+    REQUIRE(storeDir.cd(QStringLiteral("store")));
+    PreviewChunkStore store(storeDir);
+    // Nothing can be found before the first chunk is rendered
+    REQUIRE(store.isEmpty());
+    QFile chunk(dir.filePath(QStringLiteral("rendered.mp4")));
+    REQUIRE(chunk.open(QIODevice::WriteOnly));
+    chunk.write("data");
+    chunk.close();
+    REQUIRE(store.add(QStringLiteral("abc"), QStringLiteral("mp4"), chunk.fileName()));
+    REQUIRE_FALSE(store.isEmpty());
+    REQUIRE(store.contains(QStringLiteral("abc"), QStringLiteral("mp4")));
+    REQUIRE(store.keyFromPath(store.filePath(QStringLiteral("abc"), QStringLiteral("mp4"))) == QStringLiteral("abc"));
+}
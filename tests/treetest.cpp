@@ -6,6 +6,7 @@
 #include "catch.hpp"
 #include "test_utils.hpp"
 // test specific headers
+#include <QElapsedTimer>
 #include <QString>
 #include <cmath>
 #include <iostream>
@@ -14,6 +15,7 @@
 
 #include "abstractmodel/abstracttreemodel.hpp"
 #include "abstractmodel/treeitem.hpp"
+#include "bin/binsearchindex.hpp"
 #include "effects/effectlist/model/effecttreemodel.hpp"
 #include "effects/effectlist/model/effectfilter.hpp"
 
@@ -195,6 +197,42 @@ TEST_CASE("Basic tree testing", "[TreeModel]")
 // Tests the logic for matching the user-supplied search string against the list
 // of items. The actual logic is in AssetFilter but since it's an abstract
 // class, we test EffectFilter instead.
+TEST_CASE("Large tree row lookup", "[TreeModel]")
+{
+    auto model = AbstractTreeModel::construct();
+    auto folder = model->getRoot()->appendChild(QList<QVariant>{QString("folder")});
+    const int count = 50000;
+    std::vector<std::shared_ptr<TreeItem>> items;
+    items.reserve(count);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        items.push_back(folder->appendChild(QList<QVariant>{QString::number(i)}));
+    }
+    qint64 insertTime = timer.restart();
+    // Look up the index of every item, as done when emitting dataChanged
+    for (int i = 0; i < count; ++i) {
+        QModelIndex ix = model->getIndexFromId(items[size_t(i)]->getId());
+        REQUIRE(ix.row() == i);
+        items[size_t(i)]->setData(0, QString::number(-i));
+    }
+    qint64 updateTime = timer.restart();
+    REQUIRE(model->rowCount(model->getIndexFromItem(folder)) == count);
+    REQUIRE(model->parent(model->getIndexFromItem(items.back())) == model->getIndexFromItem(folder));
+
+    // Removing items invalidates the rows that follow them
+    folder->removeChild(items[100]);
+    folder->removeChild(items[0]);
+    REQUIRE(items[1]->row() == 0);
+    REQUIRE(items[101]->row() == 99);
+    REQUIRE(items.back()->row() == count - 3);
+    REQUIRE(folder->child(99) == items[101]);
+    REQUIRE(model->data(model->index(0, 0, model->getIndexFromItem(folder)), Qt::DisplayRole) == QString::number(-1));
+    REQUIRE(model->checkConsistency());
+    qDebug() << "Inserted" << count << "items in" << insertTime << "ms, updated them in" << updateTime << "ms";
+}
+
 TEST_CASE("Effect filter text-matching logic")
 {
     auto model = EffectTreeModel::construct("", nullptr);
@@ -251,3 +289,48 @@ TEST_CASE("Effect filter text-matching logic")
         CHECK(filter.filterName(item) == true);
     }
 }
+
+TEST_CASE("Bin search index", "[TreeModel]")
+{
+    BinSearchIndex index;
+    // A folder (1) containing a subfolder (2) with a clip (3), and a clip (4) at the root (0)
+    index.setItem(1, 0, QStringLiteral("Footage"));
+    index.setItem(2, 1, QStringLiteral("Day One"));
+    index.setItem(3, 2, QStringLiteral("Interview.mp4\n\nFirst take\n#ff0000:Good"));
+    index.setItem(4, 0, QStringLiteral("Music.ogg"));
+    REQUIRE(index.count() == 4);
+
+    SECTION("Query by name, description and tags")
+    {
+        auto result = index.query(QStringLiteral("VIEW"));
+        REQUIRE(result.matches == QSet<int>({3}));
+        REQUIRE(result.ancestors == QSet<int>({1, 2}));
+        REQUIRE(index.query(QStringLiteral("take")).matches == QSet<int>({3}));
+        REQUIRE(index.query(QStringLiteral("good")).matches == QSet<int>({3}));
+        REQUIRE(index.query(QStringLiteral("mu")).matches == QSet<int>({4}));
+        REQUIRE(index.query(QStringLiteral("o")).matches == QSet<int>({1, 2, 3, 4}));
+        // Fields are not searched across
+        REQUIRE(index.query(QStringLiteral("mp4first")).matches.isEmpty());
+        REQUIRE(index.query(QStringLiteral("missing")).matches.isEmpty());
+        REQUIRE(index.query(QStringLiteral("missing")).ancestors.isEmpty());
+        REQUIRE(index.matches(3, BinSearchIndex::fold(QStringLiteral("Interview"))));
+        REQUIRE_FALSE(index.matches(4, BinSearchIndex::fold(QStringLiteral("Interview"))));
+    }
+
+    SECTION("Update and remove items")
+    {
+        index.setItem(4, 2, QStringLiteral("Interview 2.ogg"));
+        auto result = index.query(QStringLiteral("interview"));
+        REQUIRE(result.matches == QSet<int>({3, 4}));
+        REQUIRE(result.ancestors == QSet<int>({1, 2}));
+        REQUIRE(index.query(QStringLiteral("music")).matches.isEmpty());
+
+        index.removeItem(3);
+        REQUIRE(index.count() == 3);
+        REQUIRE(index.query(QStringLiteral("interview")).matches == QSet<int>({4}));
+        REQUIRE(index.query(QStringLiteral("take")).matches.isEmpty());
+        index.clear();
+        REQUIRE(index.count() == 0);
+        REQUIRE(index.query(QStringLiteral("day")).matches.isEmpty());
+    }
+}